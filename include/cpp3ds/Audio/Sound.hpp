@@ -218,6 +218,8 @@ public :
 
 private :
 
+    friend class SoundBuffer;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -66,6 +66,18 @@ public:
     ////////////////////////////////////////////////////////////
     SoundBuffer(const SoundBuffer& copy);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Move constructor
+    ///
+    /// The samples are taken over without being copied, and the
+    /// sounds using \a other are switched to this buffer without
+    /// interrupting their playback. \a other is left empty.
+    ///
+    /// \param other Instance to move from
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundBuffer(SoundBuffer&& other) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -225,6 +237,19 @@ public:
     ////////////////////////////////////////////////////////////
     SoundBuffer& operator =(const SoundBuffer& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of move assignment operator
+    ///
+    /// The sounds that were using this buffer are detached from
+    /// it, those using \a right are switched to it.
+    ///
+    /// \param right Instance to move from, left empty
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    SoundBuffer& operator =(SoundBuffer&& right) noexcept;
+
 private:
 
     friend class Sound;
@@ -266,6 +291,14 @@ private:
     ////////////////////////////////////////////////////////////
     void detachSound(Sound* sound) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Take over the sounds attached to another buffer
+    ///
+    /// \param other Buffer whose sounds now use this buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void takeSounds(SoundBuffer& other);
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
@@ -2,12 +2,16 @@
 #define CPP3DS_GRAPHICS_HPP
 
 #include <cpp3ds/Window.hpp>
+#include <cpp3ds/Graphics/BigSprite.hpp>
+#include <cpp3ds/Graphics/BigTexture.hpp>
 #include <cpp3ds/Graphics/BlendMode.hpp>
 #include <cpp3ds/Graphics/Color.hpp>
 #include <cpp3ds/Graphics/Console.hpp>
 #include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/FrameAllocator.hpp>
 #include <cpp3ds/Graphics/Glyph.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/RenderCommandList.hpp>
 #include <cpp3ds/Graphics/RenderStates.hpp>
 #include <cpp3ds/Graphics/RenderTexture.hpp>
 //#include <cpp3ds/Graphics/RenderWindow.hpp>
@@ -19,6 +23,9 @@
 #include <cpp3ds/Graphics/Sprite.hpp>
 #include <cpp3ds/Graphics/Text.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/TextureAtlas.hpp>
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/TextureLoader.hpp>
 #include <cpp3ds/Graphics/Transform.hpp>
 #include <cpp3ds/Graphics/Vertex.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
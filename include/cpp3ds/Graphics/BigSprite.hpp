@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_BIGSPRITE_HPP
+#define CPP3DS_BIGSPRITE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Color.hpp>
+#include <cpp3ds/Graphics/Drawable.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/Graphics/Transformable.hpp>
+
+
+namespace cpp3ds
+{
+class BigTexture;
+
+////////////////////////////////////////////////////////////
+/// \brief Drawable representation of a big texture, with its
+///        own transformations and color
+///
+////////////////////////////////////////////////////////////
+class BigSprite : public Drawable, public Transformable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty sprite with no source texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    BigSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the sprite from a big texture
+    ///
+    /// \param texture Source texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit BigSprite(BigTexture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the source texture of the sprite
+    ///
+    /// The texture must exist as long as the sprite uses it.
+    /// It is not const, as drawing the sprite decides which of
+    /// its tiles are loaded.
+    ///
+    /// \param texture New texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(BigTexture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the global color of the sprite
+    ///
+    /// \param color New color of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    void setColor(const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the source texture of the sprite
+    ///
+    /// \return Pointer to the sprite's texture, NULL if none
+    ///
+    ////////////////////////////////////////////////////////////
+    BigTexture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global color of the sprite
+    ///
+    /// \return Global color of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& getColor() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the local bounding rectangle of the entity
+    ///
+    /// \return Local bounding rectangle of the entity
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getLocalBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the global bounding rectangle of the entity
+    ///
+    /// \return Global bounding rectangle of the entity
+    ///
+    ////////////////////////////////////////////////////////////
+    FloatRect getGlobalBounds() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the resident tiles to a render target
+    ///
+    /// The part of the texture covered by the view of the
+    /// target is made the visible area of the texture first.
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    BigTexture* m_texture; ///< Texture of the sprite
+    Color       m_color;   ///< Global color of the sprite
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_BIGSPRITE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::BigSprite
+/// \ingroup graphics
+///
+/// cpp3ds::BigSprite draws a cpp3ds::BigTexture, tile by tile,
+/// like cpp3ds::Sprite draws a texture. Each time it is drawn,
+/// it tells the texture which part of it the view shows, so
+/// that the tiles around it are streamed in.
+///
+/// A big texture should only be drawn by one sprite at a time,
+/// or the sprites would fight over which tiles are loaded.
+///
+/// \see cpp3ds::BigTexture, cpp3ds::Sprite
+///
+////////////////////////////////////////////////////////////
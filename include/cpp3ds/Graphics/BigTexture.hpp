@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_BIGTEXTURE_HPP
+#define CPP3DS_BIGTEXTURE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cpp3ds/System/Vector2.hpp>
+#include <string>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Image larger than a texture, streamed in tiles
+///
+////////////////////////////////////////////////////////////
+class BigTexture : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty big texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    BigTexture();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~BigTexture();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Split an image file into tiles
+    ///
+    /// Only the size of the image is read here. The tiles are
+    /// loaded in the background when they become visible (see
+    /// setVisibleArea), each one decoding its own region of
+    /// the file. JPEG files only decode the rows down to the
+    /// tile, other formats are decoded whole for every tile,
+    /// so they are refused beyond 4 megapixels (2048x2048).
+    ///
+    /// \param filename Path of the image file to load
+    /// \param format   Pixel format to store the tiles in
+    /// \param tileSize Maximum width and height of a tile, at most Texture::getMaximumSize()
+    ///
+    /// \return True if the image could be read
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename, Texture::Format format = Texture::RGBA8, unsigned int tileSize = 1024);
+
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Use the textures of a container file as tiles
+    ///
+    /// Every texture of the container becomes a tile, placed
+    /// at the position stored with it. The tiles are loaded
+    /// in the background when they become visible, straight
+    /// into texture memory, without any decoding.
+    ///
+    /// \param filename Path of the container file to load
+    ///
+    /// \return True if the container could be read
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromPreprocessedFile(const std::string& filename);
+#endif
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of the whole image
+    ///
+    /// \return Size in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the distance around the visible area to keep loaded
+    ///
+    /// Tiles within the margin are loaded ahead of time, so that
+    /// they are there when the view scrolls to them. Tiles are
+    /// only released beyond twice the margin, so that moving
+    /// back and forth doesn't reload them.
+    /// The default margin is 256 pixels.
+    ///
+    /// \param margin Margin around the visible area, in pixels of the image
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMargin(unsigned int margin);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the distance around the visible area to keep loaded
+    ///
+    /// \return Margin around the visible area, in pixels of the image
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getMargin() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the smooth filter of the tiles
+    ///
+    /// \param smooth True to enable smoothing, false to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setSmooth(bool smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the smooth filter is enabled or not
+    ///
+    /// \return True if smoothing is enabled, false if it is disabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isSmooth() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the area of the image that is shown
+    ///
+    /// The tiles around the area are loaded, closest to its
+    /// center first, and the ones far from it are released
+    /// once they haven't been drawn for a whole frame.
+    /// BigSprite calls this when drawn, from the view of the
+    /// render target.
+    ///
+    /// \param area Visible area, in pixels of the image
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVisibleArea(const FloatRect& area);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release all the tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of tiles
+    ///
+    /// \return Number of tiles the image is split into
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getTileCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of tiles that are loaded or loading
+    ///
+    /// \return Number of tiles with a texture
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getResidentCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the area of the image covered by a tile
+    ///
+    /// \param index Index of the tile
+    ///
+    /// \return Area of the tile, in pixels of the image
+    ///
+    ////////////////////////////////////////////////////////////
+    const IntRect& getTileRect(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the texture of a tile
+    ///
+    /// A tile that is still loading shows the placeholder of
+    /// TextureLoader.
+    ///
+    /// \param index Index of the tile
+    ///
+    /// \return Texture of the tile, NULL if it isn't resident
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTile(std::size_t index) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Part of the image stored in its own texture
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Tile
+    {
+        IntRect  area;    ///< Area of the image covered by the tile
+        Texture* texture; ///< Texture of the tile, NULL when not resident
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::string       m_filename;       ///< Image or container file the tiles are loaded from
+    Texture::Format   m_format;         ///< Pixel format of the tiles
+    Vector2u          m_size;           ///< Size of the whole image
+    unsigned int      m_margin;         ///< Distance around the visible area to keep loaded
+    bool              m_isSmooth;       ///< Status of the smooth filter
+    bool              m_isPreprocessed; ///< Are the tiles textures of a container file?
+    std::vector<Tile> m_tiles;          ///< Tiles of the image, row by row
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_BIGTEXTURE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::BigTexture
+/// \ingroup graphics
+///
+/// Textures can't be larger than Texture::getMaximumSize()
+/// (1024x1024 on the 3DS), and a whole 8K map wouldn't fit in
+/// memory anyway. cpp3ds::BigTexture splits an image into
+/// tiles, and only keeps the tiles around the visible area
+/// resident. They are decoded in the background by
+/// TextureLoader, and uploaded as they are ready, while the
+/// view scrolls.
+///
+/// Decoding a tile takes a while. Only JPEG files can decode
+/// a tile without decoding the whole image, which is why other
+/// formats are limited to 4 megapixels: an 8K PNG map would
+/// need 256 MB for each tile. Maps that are known in advance
+/// can be cooked into a texture container, one texture per
+/// tile, and loaded with loadFromPreprocessedFile instead.
+///
+/// A big texture is drawn with a cpp3ds::BigSprite, which
+/// updates the visible area from the view of the render
+/// target it is drawn to.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::BigTexture map;
+/// if (!map.loadFromFile("images/worldmap.jpg"))
+///     return -1;
+///
+/// cpp3ds::BigSprite sprite(map);
+///
+/// // In the game loop, scroll the view around the map
+/// view.move(offset);
+/// window.setView(view);
+/// window.draw(sprite);
+/// \endcode
+///
+/// \see cpp3ds::BigSprite, cpp3ds::TextureLoader
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+#ifndef CPP3DS_DISTANCEFIELD_HPP
+#define CPP3DS_DISTANCEFIELD_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Convert coverage to a signed distance field
+///
+/// The field is larger than the coverage by \a spread pixels
+/// on each side, pixels outside of the coverage are empty.
+/// Edges are at 128, values reach 255 inside and 0 outside
+/// at \a spread pixels from them. Partially covered pixels
+/// locate the edge within a pixel.
+///
+/// \param coverage Coverage to convert, 8 bits per pixel
+/// \param width    Width of the coverage
+/// \param height   Height of the coverage
+/// \param spread   Distance covered by the field, in pixels (at least 1)
+/// \param field    Field to write, (width + 2 * spread) * (height + 2 * spread) bytes
+///
+////////////////////////////////////////////////////////////
+void computeDistanceField(const Uint8* coverage, int width, int height, int spread, Uint8* field);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_DISTANCEFIELD_HPP
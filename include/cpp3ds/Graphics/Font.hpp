@@ -31,9 +31,10 @@
 #include <cpp3ds/Graphics/Glyph.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/HashTable.hpp>
+#include <cpp3ds/System/Mutex.hpp>
 #include <cpp3ds/System/Vector2.hpp>
 #include <cpp3ds/System/String.hpp>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -77,6 +78,18 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         Font(const Font& copy);
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Move constructor
+        ///
+        /// The FreeType handles and the glyph pages are taken over
+        /// without being copied or reference counted, so the page
+        /// textures keep their address. \a other is left empty.
+        ///
+        /// \param other Instance to move from
+        ///
+        ////////////////////////////////////////////////////////////
+        Font(Font&& other) noexcept;
+
         ////////////////////////////////////////////////////////////
         /// \brief Destructor
         ///
@@ -168,6 +181,10 @@ namespace cpp3ds
         /// Be aware that using a negative value for the outline
         /// thickness will cause distorted rendering.
         ///
+        /// With a distance field (see setDistanceField), the glyph
+        /// is scaled from the reference size and \a outlineThickness
+        /// is ignored: cpp3ds::Text draws outlines by threshold.
+        ///
         /// \param codePoint        Unicode code point of the character to get
         /// \param characterSize    Reference character size
         /// \param bold             Retrieve the bold version or the regular one?
@@ -178,6 +195,66 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         const Glyph& getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness = 0) const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Load a set of glyphs ahead of their first use
+        ///
+        /// All the missing glyphs are rasterized in one pass and
+        /// packed into the page of \a characterSize. Call it while a
+        /// screen loads so that its first frame doesn't stall on
+        /// getGlyph.
+        ///
+        /// This function can be called from a loading thread, even
+        /// while the font or one of its copies is drawn: the font
+        /// and its copies, which share the same face, are locked
+        /// while glyphs are added, and the page texture isn't
+        /// touched. The glyphs are written to it in a single update
+        /// the next time getTexture is called, by the thread that
+        /// draws.
+        ///
+        /// \param characters       Characters to load, duplicates are skipped
+        /// \param characterSize    Reference character size
+        /// \param bold             Load the bold version or the regular one?
+        /// \param outlineThickness Thickness of outline (when != 0 the glyphs will not be filled)
+        ///
+        /// \return Number of glyphs that were loaded
+        ///
+        /// \see getAsciiCharacters, getLatin1Characters, getKanaCharacters
+        ///
+        ////////////////////////////////////////////////////////////
+        std::size_t preloadGlyphs(const String& characters, unsigned int characterSize, bool bold = false, float outlineThickness = 0) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the printable ASCII characters
+        ///
+        /// \return Characters from U+0020 to U+007E
+        ///
+        /// \see preloadGlyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        static String getAsciiCharacters();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the printable Latin-1 characters
+        ///
+        /// \return ASCII characters plus U+00A0 to U+00FF
+        ///
+        /// \see preloadGlyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        static String getLatin1Characters();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the Japanese kana and punctuation
+        ///
+        /// \return CJK punctuation (U+3000 to U+303F), hiragana
+        ///         and katakana (U+3041 to U+30FF), and the
+        ///         halfwidth and fullwidth forms (U+FF01 to U+FF9F)
+        ///
+        /// \see preloadGlyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        static String getKanaCharacters();
+
         ////////////////////////////////////////////////////////////
         /// \brief Get the kerning offset of two glyphs
         ///
@@ -243,7 +320,8 @@ namespace cpp3ds
         ///
         /// The contents of the returned texture changes as more glyphs
         /// are requested, thus it is not very relevant. It is mainly
-        /// used internally by cpp3ds::Text.
+        /// used internally by cpp3ds::Text. With a distance field,
+        /// all the sizes share the same texture.
         ///
         /// \param characterSize Reference character size
         ///
@@ -252,6 +330,59 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         const Texture& getTexture(unsigned int characterSize) const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Render all the character sizes from a single distance field
+        ///
+        /// When enabled, glyphs are rasterized once at \a referenceSize
+        /// and stored as signed distances to their edges in a single
+        /// page. cpp3ds::Text scales them to any character size and
+        /// finds their edges, and their outline, by thresholding the
+        /// distances, so no page is created per size nor per outline
+        /// thickness. Sizes far below the reference lose some detail
+        /// compared to glyphs rasterized at their own size.
+        ///
+        /// Changing the mode discards all the loaded glyphs, so it
+        /// should be done before any text using the font is drawn.
+        ///
+        /// \param enabled       True to use a distance field, false to rasterize each size
+        /// \param referenceSize Character size the glyphs are rasterized at
+        ///
+        /// \see isDistanceField
+        ///
+        ////////////////////////////////////////////////////////////
+        void setDistanceField(bool enabled, unsigned int referenceSize = 32);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the glyphs are stored as a distance field
+        ///
+        /// \return True if the font uses a distance field
+        ///
+        /// \see setDistanceField
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isDistanceField() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the character size of the distance field glyphs
+        ///
+        /// \return Reference size, or 0 if there's no distance field
+        ///
+        ////////////////////////////////////////////////////////////
+        unsigned int getDistanceFieldSize() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the reach of the distance field around the glyph edges
+        ///
+        /// Distances are stored up to this many pixels (at the reference
+        /// size) on each side of the edges, which is also the padding
+        /// around each glyph's texture rectangle. It bounds the outline
+        /// thickness that can be drawn from the field.
+        ///
+        /// \return Spread of the distance field, in pixels, or 0 if there's no distance field
+        ///
+        ////////////////////////////////////////////////////////////
+        unsigned int getDistanceFieldSpread() const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Overload of assignment operator
         ///
@@ -262,6 +393,16 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         Font& operator =(const Font& right);
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Overload of move assignment operator
+        ///
+        /// \param right Instance to move from, left empty
+        ///
+        /// \return Reference to self
+        ///
+        ////////////////////////////////////////////////////////////
+        Font& operator =(Font&& right) noexcept;
+
     private:
 
         ////////////////////////////////////////////////////////////
@@ -280,7 +421,17 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         // Types
         ////////////////////////////////////////////////////////////
-        typedef std::map<Uint64, Glyph> GlyphTable; ///< Table mapping a codepoint to its glyph
+        typedef priv::HashTable<Uint64, Glyph> GlyphTable; ///< Table mapping a codepoint to its glyph
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Glyph pixels waiting to be written to a page texture
+        ///
+        ////////////////////////////////////////////////////////////
+        struct PendingGlyph
+        {
+            IntRect     rect;   ///< Rectangle of the glyph in the page texture
+            std::size_t offset; ///< Offset of its coverage in the page's pendingPixels
+        };
 
         ////////////////////////////////////////////////////////////
         /// \brief Structure defining a page of glyphs
@@ -290,10 +441,14 @@ namespace cpp3ds
         {
             Page();
 
-            GlyphTable       glyphs;  ///< Table mapping code points to their corresponding glyph
-            Texture          texture; ///< Texture containing the pixels of the glyphs
-            unsigned int     nextRow; ///< Y position of the next new row in the texture
-            std::vector<Row> rows;    ///< List containing the position of all the existing rows
+            GlyphTable                glyphs;        ///< Table mapping code points to their corresponding glyph
+            Texture                   texture;       ///< Texture containing the pixels of the glyphs, created by updatePage
+            Vector2u                  size;          ///< Size of the texture once updatePage is called
+            unsigned int              nextRow;       ///< Y position of the next new row in the texture
+            std::vector<Row>          rows;          ///< List containing the position of all the existing rows
+            std::vector<PendingGlyph> pending;       ///< Glyphs packed by preloadGlyphs, not written to the texture yet
+            std::vector<Uint8>        pendingPixels; ///< Coverage of the pending glyphs
+            unsigned int              pendingRow;    ///< Y position of the first row that was free before the pending glyphs
         };
 
         ////////////////////////////////////////////////////////////
@@ -302,6 +457,25 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         void cleanup();
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Drop all the loaded glyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        void clearGlyphs() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Find a glyph in the tables, loading it if needed
+        ///
+        /// \param codePoint        Unicode code point of the character to get
+        /// \param characterSize    Reference character size
+        /// \param bold             Retrieve the bold version or the regular one?
+        /// \param outlineThickness Thickness of outline, 0 with a distance field
+        ///
+        /// \return The glyph corresponding to \a codePoint and \a characterSize
+        ///
+        ////////////////////////////////////////////////////////////
+        const Glyph& findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Load a new glyph and store it in the cache
         ///
@@ -309,15 +483,41 @@ namespace cpp3ds
         /// \param characterSize    Reference character size
         /// \param bold             Retrieve the bold version or the regular one?
         /// \param outlineThickness Thickness of outline (when != 0 the glyph will not be filled)
+        /// \param deferred         If true, the pixels are added to the pending glyphs of
+        ///                         the page instead of being written to the texture
         ///
         /// \return The glyph corresponding to \a codePoint and \a characterSize
         ///
         ////////////////////////////////////////////////////////////
-        Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const;
+        Glyph loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool deferred = false) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Bring the texture of a page up to date
+        ///
+        /// The texture is created or grown to the size of the page,
+        /// and the pending glyphs are written to it. This is the only
+        /// place the texture changes size, so that preloadGlyphs never
+        /// touches a texture that may be drawn.
+        ///
+        /// \param page Page to update
+        ///
+        ////////////////////////////////////////////////////////////
+        void updatePage(Page& page) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Write the pending glyphs to a page with a single texture update
+        ///
+        /// \param page Page the glyphs were packed into
+        ///
+        ////////////////////////////////////////////////////////////
+        void writePendingGlyphs(Page& page) const;
 
         ////////////////////////////////////////////////////////////
         /// \brief Find a suitable rectangle within the texture for a glyph
         ///
+        /// The size of the page is doubled when the glyph doesn't fit,
+        /// the texture follows in updatePage.
+        ///
         /// \param page   Page of glyphs to search in
         /// \param width  Width of the rectangle
         /// \param height Height of the rectangle
@@ -340,7 +540,9 @@ namespace cpp3ds
         ////////////////////////////////////////////////////////////
         // Types
         ////////////////////////////////////////////////////////////
-        typedef std::map<unsigned int, Page> PageTable; ///< Table mapping a character size to its page (texture)
+        typedef priv::HashTable<unsigned int, Page> PageTable;          ///< Table mapping a character size to its page (texture)
+        typedef priv::HashTable<unsigned int, GlyphTable> ScaledTable; ///< Table mapping a character size to the distance field glyphs scaled to it
+        typedef priv::HashTable<Uint64, float> KerningTable;           ///< Table mapping a pair of code points and a size to their kerning
 
         ////////////////////////////////////////////////////////////
         // Member data
@@ -350,9 +552,15 @@ namespace cpp3ds
         void*                      m_streamRec;   ///< Pointer to the stream rec instance (it is typeless to avoid exposing implementation details)
         void*                      m_stroker;     ///< Pointer to the stroker (it is typeless to avoid exposing implementation details)
         int*                       m_refCount;    ///< Reference counter used by implicit sharing
+        Mutex*                     m_mutex;       ///< Protects the pages and the face against loading threads, shared by the copies along with the face
         Info                       m_info;        ///< Information about the font
         mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
-        mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+        mutable std::vector<Uint8> m_pixelBuffer; ///< Buffer holding a glyph's coverage before being written to the texture
+        mutable ScaledTable        m_scaledGlyphs; ///< Distance field glyphs scaled to each character size
+        unsigned int               m_distanceFieldSize; ///< Reference size of the distance field glyphs, 0 when disabled
+        mutable KerningTable       m_kerning;     ///< Kerning of the pairs already looked up
+        mutable unsigned int       m_asciiSize;   ///< Character size of the glyphs in m_asciiGlyphs
+        mutable const Glyph*       m_asciiGlyphs[2][128]; ///< Regular and bold ASCII glyphs of m_asciiSize, NULL until used
     };
 
 } // namespace cpp3ds
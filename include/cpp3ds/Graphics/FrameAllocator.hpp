@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_FRAMEALLOCATOR_HPP
+#define CPP3DS_FRAMEALLOCATOR_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <cstddef>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Bump allocator for memory that only lives for one frame
+///
+////////////////////////////////////////////////////////////
+class FrameAllocator : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the allocator
+    ///
+    /// No memory is reserved until the first allocation.
+    ///
+    /// \param capacity Size of the buffer, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit FrameAllocator(std::size_t capacity = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~FrameAllocator();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the size of the buffer
+    ///
+    /// The current buffer is released, so any memory allocated
+    /// from it becomes invalid. The new one is reserved on the
+    /// next allocation.
+    ///
+    /// \param capacity New size of the buffer, in bytes
+    ///
+    /// \see getCapacity
+    ///
+    ////////////////////////////////////////////////////////////
+    void setCapacity(std::size_t capacity);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the buffer
+    ///
+    /// \return Size of the buffer, in bytes
+    ///
+    /// \see setCapacity
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCapacity() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate a block of memory for the current frame
+    ///
+    /// On the 3DS the memory lives in the linear heap, so it can
+    /// be read by the GPU directly. It stays valid until the
+    /// frame has been rendered, after which the whole buffer is
+    /// recycled. There is no need (and no way) to free it.
+    ///
+    /// \param size      Number of bytes to allocate
+    /// \param alignment Alignment of the block, must be a power of two
+    ///
+    /// \return Pointer to the memory, or NULL if there's not enough room left in this frame
+    ///
+    ////////////////////////////////////////////////////////////
+    void* allocate(std::size_t size, std::size_t alignment = 16);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release all the memory allocated so far
+    ///
+    /// This is done automatically on the first allocation of
+    /// each frame, and should only be called when it's known
+    /// that the GPU won't read the allocated memory anymore.
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of bytes allocated in the current frame
+    ///
+    /// \return Number of bytes in use
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the highest number of bytes used in a frame
+    ///
+    /// This is useful to tune the capacity of the allocator.
+    /// Allocations that failed because the buffer was full
+    /// are counted too, so a high-water mark above the capacity
+    /// means that the buffer is too small.
+    ///
+    /// \return Highest number of bytes requested in a single frame
+    ///
+    /// \see resetHighWaterMark
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getHighWaterMark() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the high-water mark to the current usage
+    ///
+    /// \see getHighWaterMark
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetHighWaterMark();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark the end of a frame
+    ///
+    /// Must be called once the GPU has processed all the draw
+    /// commands of the frame, so that every allocator can reuse
+    /// its memory. cpp3ds::Game takes care of it at the end of
+    /// each render().
+    ///
+    ////////////////////////////////////////////////////////////
+    static void nextFrame();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Uint8*      m_buffer;        ///< Memory the blocks are taken from (allocated on first use)
+    std::size_t m_capacity;      ///< Size of the buffer, in bytes
+    std::size_t m_offset;        ///< Offset of the first free byte in the buffer
+    std::size_t m_highWaterMark; ///< Highest number of bytes requested in a frame
+    Uint32      m_frame;         ///< Frame in which the buffer was last reset
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_FRAMEALLOCATOR_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::FrameAllocator
+/// \ingroup graphics
+///
+/// cpp3ds::FrameAllocator hands out short-lived memory, such
+/// as the vertices of geometry that is built every frame.
+/// Allocating is only a matter of moving an offset forward,
+/// and everything is released at once when the frame ends.
+///
+/// Every cpp3ds::RenderTarget owns one, which is what
+/// RenderTarget::allocateVertices uses.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::Vertex* quad = window.allocateVertices(4);
+/// if (quad)
+/// {
+///     // ... fill the vertices ...
+///     window.draw(quad, 4, cpp3ds::TrianglesStrip);
+/// }
+/// \endcode
+///
+/// \see cpp3ds::RenderTarget
+///
+////////////////////////////////////////////////////////////
@@ -60,6 +60,45 @@ public :
     ////////////////////////////////////////////////////////////
     ~Image();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Image(const Image& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move constructor
+    ///
+    /// The pixel array is taken over without being copied,
+    /// \a other is left empty.
+    ///
+    /// \param other Instance to move from
+    ///
+    ////////////////////////////////////////////////////////////
+    Image(Image&& other) noexcept;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Image& operator =(const Image& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of move assignment operator
+    ///
+    /// \param right Instance to move from, left empty
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Image& operator =(Image&& right) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Create the image and fill it with a unique color
     ///
@@ -102,6 +141,45 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromFile(const std::string& filename);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the image from a file on disk, reduced to fit a size
+    ///
+    /// The image is reduced by the smallest power of two that
+    /// makes it fit in \a maxSize x \a maxSize pixels. JPEG
+    /// files are reduced while they are decoded, so a large
+    /// photo never needs the memory of its full size.
+    /// If this function fails, the image is left unchanged.
+    ///
+    /// \param filename Path of the image file to load
+    /// \param maxSize  Maximum width and height of the image, 0 for no limit
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromMemory, loadFromStream, saveToFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename, unsigned int maxSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a region of an image file on disk
+    ///
+    /// The region is given in pixels of the full image and is
+    /// clamped to it. It is then reduced like with
+    /// loadFromFile(filename, maxSize). JPEG files only decode
+    /// the rows down to the bottom of the region.
+    /// If this function fails, the image is left unchanged.
+    ///
+    /// \param filename Path of the image file to load
+    /// \param area     Region of the image to load
+    /// \param maxSize  Maximum width and height of the image, 0 for no limit
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromMemory, loadFromStream, saveToFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::string& filename, const IntRect& area, unsigned int maxSize = 0);
+
     ////////////////////////////////////////////////////////////
     /// \brief Load the image from a file in memory
     ///
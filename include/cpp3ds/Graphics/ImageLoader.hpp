@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
 #include <cpp3ds/System/NonCopyable.hpp>
 #include <cpp3ds/System/Vector2.hpp>
 #include <string>
@@ -69,6 +70,94 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadImageFromFile(const std::string& filename, std::vector<Uint8>& pixels, Vector2u& size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a region of an image file, reduced to fit a size
+    ///
+    /// The region is reduced by the smallest power of two that
+    /// makes it fit in \a maxSize x \a maxSize. JPEG files are
+    /// reduced by the decoder itself and only the rows of the
+    /// region are kept, other formats are decoded whole and then
+    /// cropped and reduced in place.
+    ///
+    /// \param filename Path of image file to load
+    /// \param area     Region of the image to load, empty for the whole image
+    /// \param maxSize  Maximum width and height of the result, 0 for no limit
+    /// \param pixels   Array of pixels to fill with loaded image
+    /// \param size     Size of loaded image, in pixels
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadImageFromFile(const std::string& filename, const IntRect& area, unsigned int maxSize, std::vector<Uint8>& pixels, Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the size of an image file without decoding it
+    ///
+    /// \param filename Path of image file to read
+    /// \param size     Size of the image, in pixels
+    ///
+    /// \return True if the file is an image that can be loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadImageSizeFromFile(const std::string& filename, Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether regions of an image file are decoded on their own
+    ///
+    /// Only JPEG files are, loading a region of another format
+    /// decodes the whole image first.
+    ///
+    /// \param filename Path of image file to check
+    ///
+    /// \return True if loading a region only decodes the rows down to it
+    ///
+    ////////////////////////////////////////////////////////////
+    bool canLoadRegions(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Clamp a region to the bounds of an image
+    ///
+    /// This is how every image and texture loading function
+    /// interprets its area: an empty area, or one that contains
+    /// the whole image, is the whole image. Otherwise a negative
+    /// position is moved to 0 while keeping the size, and the
+    /// size is then cut to the image.
+    ///
+    /// \param area Region of the image
+    /// \param size Size of the image, in pixels
+    ///
+    /// \return Region within the image, with a width or height of 0 or less if there's nothing left
+    ///
+    ////////////////////////////////////////////////////////////
+    static IntRect clampArea(const IntRect& area, const Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load an image from a file on disk into existing memory
+    ///
+    /// The pixels are decoded in place when possible, texture
+    /// memory for example, so no intermediate copy is made.
+    ///
+    /// \param filename Path of image file to load
+    /// \param pixels   Memory to write the RGBA pixels to
+    /// \param size     Expected size of the image, in pixels
+    ///
+    /// \return True if loading was successful and the image has the expected size
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadImageFromFile(const std::string& filename, Uint8* pixels, const Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of decodes that couldn't be done in place
+    ///
+    /// Their pixels were decoded into a block of their own and
+    /// then copied. Only the decodes of the calling thread are
+    /// counted.
+    ///
+    /// \return Number of copied decodes since the thread started
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getDecodeCopyCount();
+
     ////////////////////////////////////////////////////////////
     /// \brief Load an image from a file in memory
     ///
@@ -132,6 +221,20 @@ private :
     ///
     ////////////////////////////////////////////////////////////
     bool writeJpg(const std::string& filename, const std::vector<Uint8>& pixels, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a region of a JPEG file with DCT scaling
+    ///
+    /// \param path    Full path of the JPEG file
+    /// \param area    Region of the image to load, in pixels of the full image
+    /// \param factor  Power of two to reduce the region by
+    /// \param pixels  Array of pixels to fill with loaded image
+    /// \param size    Size of loaded image, in pixels
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readJpg(const std::string& path, const IntRect& area, unsigned int factor, std::vector<Uint8>& pixels, Vector2u& size);
 };
 
 } // namespace priv
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_RENDERCOMMANDLIST_HPP
+#define CPP3DS_RENDERCOMMANDLIST_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Vertex.hpp>
+#include <cpp3ds/Graphics/PrimitiveType.hpp>
+#include <cpp3ds/Graphics/RenderStates.hpp>
+#include <cpp3ds/Graphics/Drawable.hpp>
+#ifndef EMULATION
+#include <cpp3ds/System/LinearAllocator.hpp>
+#endif
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Sequence of recorded draws that can be replayed
+///
+////////////////////////////////////////////////////////////
+class RenderCommandList : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty command list.
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderCommandList();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the recorded draws
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the list contains any draw
+    ///
+    /// \return True if nothing was recorded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isEmpty() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of draw commands in the list
+    ///
+    /// Consecutive draws sharing the same states are merged
+    /// while recording, so this is the number of draw calls
+    /// made when the list is replayed.
+    ///
+    /// \return Number of commands
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getCommandCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the total number of recorded vertices
+    ///
+    /// \return Number of vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVertexCount() const;
+
+private :
+
+    friend class RenderTarget;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a draw
+    ///
+    /// The vertices are transformed by \a states.transform and
+    /// converted to a list of triangles.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states used for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void append(const Vertex* vertices, unsigned int vertexCount,
+                PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replay the recorded draws on a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states, only the transform is used
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Recorded draw call
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Command
+    {
+        unsigned int   first;     ///< Index of the first vertex
+        unsigned int   count;     ///< Number of vertices
+        BlendMode      blendMode; ///< Blending mode
+        const Texture* texture;   ///< Texture (must outlive the list)
+        Uint64         textureId; ///< Cache identifier of the texture
+        const Shader*  shader;    ///< Shader (must outlive the list)
+        UintRect       scissor;   ///< Scissor rectangle
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Command> m_commands; ///< Recorded draw calls
+#ifdef EMULATION
+    std::vector<Vertex> m_vertices;  ///< Transformed vertices of all the commands, as triangle lists
+#else
+    std::vector<Vertex, LinearAllocator<Vertex>> m_vertices;
+#endif
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_RENDERCOMMANDLIST_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::RenderCommandList
+/// \ingroup graphics
+///
+/// cpp3ds::RenderCommandList stores the result of a sequence
+/// of draws, so that static scenes such as a user interface
+/// don't have to be rebuilt every frame. The vertices are
+/// transformed once when recorded and kept in linear memory,
+/// and consecutive draws sharing the same states are merged.
+///
+/// A list is recorded with RenderTarget::beginRecording and
+/// RenderTarget::endRecording, and replayed by drawing it like
+/// any other drawable. The transform of the render states is
+/// applied on top of the recorded geometry, which allows to
+/// move the whole scene with an offset.
+///
+/// The textures and shaders used while recording must stay
+/// alive as long as the list is drawn. A list must not be
+/// recorded again during a frame in which it was drawn, since
+/// the GPU only reads its vertices when the frame ends.
+///
+/// Text drawn with the system font can't be recorded.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::RenderCommandList hud;
+/// window.beginRecording(hud);
+/// window.draw(background);
+/// window.draw(title);
+/// window.endRecording();
+///
+/// // Every frame
+/// window.draw(hud);
+/// window.draw(hud, cpp3ds::Transform().translate(0, scroll));
+/// \endcode
+///
+/// \see cpp3ds::RenderTarget
+///
+////////////////////////////////////////////////////////////
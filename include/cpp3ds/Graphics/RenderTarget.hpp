@@ -33,7 +33,9 @@
 #include <cpp3ds/Graphics/RenderStates.hpp>
 #include <cpp3ds/Graphics/PrimitiveType.hpp>
 #include <cpp3ds/Graphics/Vertex.hpp>
+#include <cpp3ds/Graphics/FrameAllocator.hpp>
 #include <cpp3ds/System/NonCopyable.hpp>
+#include <vector>
 #ifndef EMULATION
 #include <citro3d.h>
 #endif
@@ -42,6 +44,7 @@
 namespace cpp3ds
 {
 class Drawable;
+class RenderCommandList;
 
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
@@ -50,6 +53,7 @@ class Drawable;
 class RenderTarget : NonCopyable
 {
 friend class Text;
+friend class RenderCommandList;
 
 public :
 
@@ -248,6 +252,119 @@ public :
     void draw(const Vertex* vertices, unsigned int vertexCount,
               PrimitiveType type, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable automatic batching of draw calls
+    ///
+    /// When batching is enabled, consecutive draws that share the
+    /// same texture, blend mode, scissor and shader are collected
+    /// into a single vertex stream. This stream is submitted as one
+    /// draw call when one of these states changes, when the view
+    /// changes, or when flush() or display() is called.
+    ///
+    /// Only small meshes (sprites, shapes, text) are batched, their
+    /// vertices are transformed on the CPU while being collected.
+    /// Bigger vertex arrays are still drawn directly.
+    ///
+    /// Batching is disabled by default.
+    ///
+    /// \param enabled True to enable batching, false to disable it
+    ///
+    /// \see isBatchingEnabled, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBatchingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether automatic batching is enabled or not
+    ///
+    /// \return True if batching is enabled
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBatchingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Submit the pending batched draws to the GPU
+    ///
+    /// This function only has an effect when batching is enabled.
+    /// It must be called before issuing GPU commands directly,
+    /// so that the batched geometry is drawn first.
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate vertices that only live for the current frame
+    ///
+    /// This is the cheapest way to get memory for geometry that
+    /// is rebuilt every frame: the vertices are taken from a
+    /// buffer owned by the render target (in linear memory on
+    /// the 3DS, so the GPU can read them without a copy), and
+    /// the whole buffer is recycled once the GPU has rendered
+    /// the frame. They must not be used in later frames, and
+    /// must not be freed.
+    ///
+    /// The batching of draw calls shares the same buffer.
+    ///
+    /// \param vertexCount Number of vertices to allocate
+    ///
+    /// \return Pointer to the vertices, or NULL if the buffer is full for this frame
+    ///
+    /// \see getVertexAllocator
+    ///
+    ////////////////////////////////////////////////////////////
+    Vertex* allocateVertices(unsigned int vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the allocator of the per-frame vertices
+    ///
+    /// It can be used to change the size of the buffer
+    /// (8192 vertices by default) or to check its high-water mark.
+    ///
+    /// \return Reference to the per-frame vertex allocator
+    ///
+    /// \see allocateVertices
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameAllocator& getVertexAllocator();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start recording the draws into a command list
+    ///
+    /// Until endRecording is called, the draws made on this
+    /// target are stored in \a commandList instead of being
+    /// rendered. The list is cleared first.
+    ///
+    /// \param commandList Command list receiving the draws
+    ///
+    /// \see endRecording, RenderCommandList
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginRecording(RenderCommandList& commandList);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop recording the draws
+    ///
+    /// Draws made after this call are rendered again.
+    ///
+    /// \see beginRecording
+    ///
+    ////////////////////////////////////////////////////////////
+    void endRecording();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the draws are being recorded
+    ///
+    /// \return True if a command list is being recorded
+    ///
+    /// \see beginRecording
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isRecording() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -276,14 +393,14 @@ public :
     /// // OpenGL code here...
     /// \endcode
     ///
-    /// Note that this function is quite expensive: it saves all the
-    /// possible OpenGL states and matrices, even the ones you
-    /// don't care about. Therefore it should be used wisely.
-    /// It is provided for convenience, but the best results will
-    /// be achieved if you handle OpenGL states yourself (because
-    /// you know which states have really changed, and need to be
-    /// saved and restored). Take a look at the ResetGLStates
-    /// function if you do so.
+    /// The states used by cpp3ds (view, blend mode, transform,
+    /// texture, scissor and shader) are saved on a stack and
+    /// marked as dirty, so that the next draws apply the ones they
+    /// need. popGLStates then only applies again the states that
+    /// differ from the saved ones. Calls can be nested.
+    ///
+    /// In the emulator, this function also saves all the OpenGL
+    /// states and matrices, which is quite expensive.
     ///
     /// \see popGLStates
     ///
@@ -310,6 +427,9 @@ public :
     /// states needed by SFML are set, so that subsequent draw()
     /// calls will work as expected.
     ///
+    /// The states are not applied right away: they are marked as
+    /// dirty, and the next draw() calls apply the ones they use.
+    ///
     /// Example:
     /// \code
     /// // OpenGL code here...
@@ -347,6 +467,50 @@ protected :
 
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives immediately, bypassing the batch
+    ///
+    /// Small meshes are pre-transformed on the CPU, so that
+    /// consecutive draws can share an identity modelview matrix.
+    ///
+    /// \param vertices      Pointer to the vertices
+    /// \param vertexCount   Number of vertices in the array
+    /// \param type          Type of primitives to draw
+    /// \param states        Render states to use for drawing
+    /// \param isTransformed True if the vertices were already transformed (the transform of \a states is ignored)
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                        PrimitiveType type, const RenderStates& states, bool isTransformed = false);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append primitives to the pending batch
+    ///
+    /// The vertices are transformed and converted to a list
+    /// of triangles. The pending batch is flushed first if its
+    /// states don't match the given ones.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    /// \return True if the primitives were batched, false if they must be drawn directly
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addToBatch(const Vertex* vertices, unsigned int vertexCount,
+                    PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make sure that the states cache can be trusted
+    ///
+    /// All the render targets share the same GPU states, so
+    /// when another target has drawn since this one, all the
+    /// cached states are marked as dirty.
+    ///
+    ////////////////////////////////////////////////////////////
+    void validateCache();
+
     ////////////////////////////////////////////////////////////
     /// \brief Apply the current view
     ///
@@ -413,23 +577,67 @@ private:
     ////////////////////////////////////////////////////////////
     struct StatesCache
     {
-        enum {VertexCacheSize = 4};
+        enum {VertexCacheSize = 96};      ///< Biggest mesh that gets pre-transformed on the CPU
+        enum {FrameVertexCount = 8192};   ///< Default number of per-frame vertices
+        enum {BatchMaxVertexCount = 96};  ///< Biggest mesh (in triangle list vertices) that gets batched
+
+        ////////////////////////////////////////////////////////////
+        /// \brief States that must be applied again on next use,
+        ///        whatever their cached value is
+        ///
+        ////////////////////////////////////////////////////////////
+        enum DirtyFlags
+        {
+            ViewDirty      = 1 << 0,
+            BlendModeDirty = 1 << 1,
+            TransformDirty = 1 << 2,
+            TextureDirty   = 1 << 3,
+            ScissorDirty   = 1 << 4,
+            ShaderDirty    = 1 << 5,
+            AllDirty       = (1 << 6) - 1
+        };
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Cached states saved by pushGLStates
+        ///
+        ////////////////////////////////////////////////////////////
+        struct SavedStates
+        {
+            BlendMode blendMode;
+            Uint64    textureId;
+            UintRect  scissor;
+            bool      useVertexCache;
+            Uint8     dirty;
+        };
 
         bool      glStatesSet;    ///< Are our internal GL states set yet?
-        bool      viewChanged;    ///< Has the current view changed since last draw?
+        Uint8     dirty;          ///< Combination of DirtyFlags
         BlendMode lastBlendMode;  ///< Cached blending mode
         Uint64    lastTextureId;  ///< Cached texture
-        bool      useVertexCache; ///< Did we previously use the vertex cache?
-        Vertex*   vertexCache;    ///< Pre-transformed vertices cache
+        bool      useVertexCache; ///< Did we previously use the vertex cache? (i.e. is the identity transform applied?)
+        Vertex*   vertexCache;    ///< Pre-transformed vertices cache (the 3DS uses the frame allocator instead)
         UintRect  lastScissor;
+
+        std::vector<SavedStates> stack; ///< States saved by pushGLStates
+
+        bool           batchEnabled;   ///< Is automatic batching enabled?
+        Vertex*        batchVertices;  ///< Pre-transformed vertices of the pending batch
+        unsigned int   batchCount;     ///< Number of vertices in the pending batch
+        const Texture* batchTexture;   ///< Texture of the pending batch (flushes it before going away)
+        Uint64         batchTextureId; ///< Cache identifier of the pending batch's texture
+        BlendMode      batchBlendMode; ///< Blending mode of the pending batch
+        UintRect       batchScissor;   ///< Scissor of the pending batch
+        const Shader*  batchShader;    ///< Shader of the pending batch
     };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        m_defaultView; ///< Default view
-    View        m_view;        ///< Current view
-    StatesCache m_cache;       ///< Render states cache
+    View               m_defaultView;     ///< Default view
+    View               m_view;            ///< Current view
+    StatesCache        m_cache;           ///< Render states cache
+    FrameAllocator     m_vertexAllocator; ///< Per-frame vertices, also used by the batches
+    RenderCommandList* m_commandList;     ///< Command list being recorded, if any
 
 protected:
 #ifndef EMULATION
@@ -342,6 +342,18 @@ namespace cpp3ds
 
         void drawSystemFont(RenderTarget& target, RenderStates states) const;
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Draw the text from a distance field font
+        ///
+        /// The outline and the fill are drawn one after the other,
+        /// each with its own threshold on the distance field.
+        ///
+        /// \param target Render target to draw to
+        /// \param states Render states of the text, with the font texture
+        ///
+        ////////////////////////////////////////////////////////////
+        void drawDistanceField(RenderTarget& target, const RenderStates& states) const;
+
         ////////////////////////////////////////////////////////////
         /// \brief Make sure the text's geometry is updated
         ///
@@ -43,6 +43,11 @@ class RenderTarget;
 class RenderTexture;
 class InputStream;
 
+namespace priv
+{
+    struct ContainerTexture;
+}
+
 /////////////////////////////////////////////////////some things could easily be broken///////
 /// \brief Image living on the graphics card that can be used for drawing
 ///
@@ -61,6 +66,28 @@ public :
         Pixels      ///< Texture coordinates in range [0 .. size]
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Pixel formats a texture can be stored in
+    ///
+    /// Pixels are always given to and read from a texture as
+    /// 32-bits RGBA, they are converted to the texture format
+    /// when uploaded. Smaller formats save memory and upload
+    /// time at the cost of color precision.
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Format
+    {
+        RGBA8,     ///< 32 bits, 8 bits per channel (default)
+        RGB565,    ///< 16 bits, opaque, 5 bits red and blue and 6 bits green
+        RGBA5551,  ///< 16 bits, 5 bits per color channel and 1 bit alpha
+        RGBA4,     ///< 16 bits, 4 bits per channel
+        LA8,       ///< 16 bits, 8 bits luminance and 8 bits alpha
+        A8,        ///< 8 bits, alpha only (color is read as white)
+        ETC1,      ///< 4 bits, compressed, opaque
+        ETC1A4,    ///< 8 bits, compressed, with 4 bits alpha
+        Compressed ///< ETC1A4 if the image has transparent pixels, ETC1 otherwise
+    };
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -79,6 +106,18 @@ public :
     ////////////////////////////////////////////////////////////
     Texture(const Texture& copy);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Move constructor
+    ///
+    /// The GPU texture is taken over without being copied, along
+    /// with its pending background load if any. \a other is
+    /// left empty.
+    ///
+    /// \param other Instance to move from
+    ///
+    ////////////////////////////////////////////////////////////
+    Texture(Texture&& other) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -89,14 +128,17 @@ public :
     /// \brief Create the texture
     ///
     /// If this function fails, the texture is left unchanged.
+    /// As there is no image to look at, Compressed gives an
+    /// ETC1A4 texture.
     ///
     /// \param width  Width of the texture
     /// \param height Height of the texture
+    /// \param format Pixel format used to store the texture
     ///
     /// \return True if creation was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool create(unsigned int width, unsigned int height);
+    bool create(unsigned int width, unsigned int height, Format format = RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// \brief Load the texture from a file on disk
@@ -129,6 +171,30 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromFile(const std::string& filename, const IntRect& area = IntRect());
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading the texture from a file in the background
+    ///
+    /// Only the header of the file is read before returning:
+    /// the texture gets its final size, and shows a placeholder
+    /// color while a background thread decodes and tiles the
+    /// pixels. The load is finished on the rendering thread by
+    /// TextureLoader::update, which cpp3ds::Game calls every frame.
+    ///
+    /// Unlike loadFromImage, the Compressed format always
+    /// gives an ETC1A4 texture, since the pixels aren't known yet.
+    /// Changing the texture (create, update...) cancels the load.
+    ///
+    /// \param filename Path of the image file to load
+    /// \param area     Area of the image to load
+    /// \param format   Pixel format to store the texture in
+    ///
+    /// \return True if the load was started
+    ///
+    /// \see isLoading, loadFromFile, cpp3ds::TextureLoader
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFileAsync(const std::string& filename, const IntRect& area = IntRect(), Format format = RGBA8);
+
     ////////////////////////////////////////////////////////////
     /// \brief Load the texture from a file in memory
     ///
@@ -206,19 +272,84 @@ public :
     ///
     /// If this function fails, the texture is left unchanged.
     ///
-    /// \param image Image to load into the texture
-    /// \param area  Area of the image to load
+    /// The image pixels are converted to \a format while they
+    /// are uploaded.
+    ///
+    /// \param image  Image to load into the texture
+    /// \param area   Area of the image to load
+    /// \param format Pixel format used to store the texture
     ///
     /// \return True if loading was successful
     ///
     /// \see loadFromFile, loadFromMemory
     ///
     ////////////////////////////////////////////////////////////
-    bool loadFromImage(const Image& image, const IntRect& area = IntRect());
+    bool loadFromImage(const Image& image, const IntRect& area = IntRect(), Format format = RGBA8);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a whole image, in a given format
+    ///
+    /// This is mostly meant for compression:
+    /// \code
+    /// texture.loadFromImage(image, cpp3ds::Texture::Compressed);
+    /// \endcode
+    /// Compressing is slow, large images are better compressed
+    /// once when cooking assets (see loadFromPreprocessedFile).
+    ///
+    /// \param image  Image to load into the texture
+    /// \param format Pixel format used to store the texture
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromImage(const Image& image, Format format);
 
 #ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Load already tiled texture data
+    ///
+    /// The data is laid out the way the GPU reads it, in the
+    /// given format. When it holds the base level followed by
+    /// the whole mipmap chain (see generateMipmap), the texture
+    /// is loaded with its mipmap.
+    ///
+    ////////////////////////////////////////////////////////////
     bool loadFromPreprocessedFile(const std::string& filename);
     bool loadFromPreprocessedFile(const std::string& filename, size_t width, size_t height, GPU_TEXCOLOR format);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a texture of a preprocessed container file
+    ///
+    /// Containers hold several textures, each with its mipmap
+    /// levels, optionally LZ11 or LZ4 compressed (see
+    /// priv::TextureContainerWriter). The levels are read, or
+    /// decompressed, straight into texture memory.
+    /// Files of the previous format only hold texture 0.
+    ///
+    /// \param filename Path of the file to load
+    /// \param index    Index of the texture in the file
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromPreprocessedFile(const std::string& filename, unsigned int index);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a texture of a preprocessed container file in the background
+    ///
+    /// Works like loadFromFileAsync: the texture gets its size
+    /// and format right away, and the levels are read by the
+    /// loader thread.
+    ///
+    /// \param filename Path of the container file to load
+    /// \param index    Index of the texture in the file
+    ///
+    /// \return True if the load was started
+    ///
+    /// \see loadFromPreprocessedFile, cpp3ds::TextureLoader
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromPreprocessedFileAsync(const std::string& filename, unsigned int index = 0);
     bool loadFromPreprocessedMemory(void *data, size_t size, size_t width, size_t height, GPU_TEXCOLOR format, bool copyData = true);
 
     C3D_Tex* getNativeTexture() { return m_texture; }
@@ -232,6 +363,24 @@ public :
     ////////////////////////////////////////////////////////////
     Vector2u getSize() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the pixel format of the texture
+    ///
+    /// \return Format the pixels are stored in
+    ///
+    ////////////////////////////////////////////////////////////
+    Format getFormat() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a background load is pending
+    ///
+    /// \return True if the texture still shows the placeholder
+    ///
+    /// \see loadFromFileAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isLoading() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the texture pixels to an image
     ///
@@ -247,6 +396,40 @@ public :
     ////////////////////////////////////////////////////////////
     Image copyToImage() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy a region of the texture pixels to an image
+    ///
+    /// Only the tiles covering \a area are converted, which
+    /// makes small reads, such as thumbnails, much cheaper
+    /// than copying the whole texture.
+    ///
+    /// \param area Area of the texture to copy
+    ///
+    /// \return Image containing the pixels of the area, empty if the area isn't inside the texture
+    ///
+    /// \see readPixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Image copyToImage(const IntRect& area) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read a region of the texture pixels to an array
+    ///
+    /// The tiles covering \a area are converted straight into
+    /// \a pixels, without any intermediate buffer. This is the
+    /// cheapest way to read back a few pixels, e.g. for color
+    /// picking.
+    ///
+    /// \param area   Area of the texture to read
+    /// \param pixels Array of area.width * area.height RGBA pixels to fill
+    ///
+    /// \return True if the area is inside the texture and its format can be read
+    ///
+    /// \see copyToImage
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readPixels(const IntRect& area, Uint8* pixels) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Update the whole texture from an array of pixels
     ///
@@ -421,6 +604,25 @@ public :
     ////////////////////////////////////////////////////////////
     bool isRepeated() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate a mipmap using the current texture data
+    ///
+    /// Mipmaps are pre-computed chains of optimized textures.
+    /// Each level of texture in a mipmap is generated by halving
+    /// each of the previous level's dimensions, down to 8x8.
+    /// Minified textures then sample a level close to their
+    /// displayed size, which avoids aliasing and reads much
+    /// less memory.
+    ///
+    /// The levels are built on the CPU with a box filter, which
+    /// takes some time. Updating the texture rebuilds them, so
+    /// avoid mipmaps on textures updated every frame.
+    ///
+    /// \return True if mipmap generation was successful, false if unsuccessful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -431,6 +633,16 @@ public :
     ////////////////////////////////////////////////////////////
     Texture& operator =(const Texture& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of move assignment operator
+    ///
+    /// \param right Instance to move from, left empty
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Texture& operator =(Texture&& right) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Bind a texture for rendering
     ///
@@ -478,8 +690,12 @@ public :
 
 private :
 
+    friend class Font;
     friend class RenderTexture;
     friend class RenderTarget;
+    friend class RenderCommandList;
+    friend class TextureCache;
+    friend class TextureLoader;
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -496,20 +712,183 @@ private :
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the amount of texture memory used by the pixels
+    ///
+    /// This includes the padding and the mipmap levels, if any.
+    ///
+    /// \return Size of the texture data, in bytes (0 if there is none)
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getMemorySize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the texture data, so that it can be reloaded later
+    ///
+    /// Only textures that can be restored are evicted: those
+    /// loaded from a file, and compressed ones whose data is
+    /// then kept in main memory. Used by cpp3ds::TextureCache.
+    ///
+    /// \return True if the data was released
+    ///
+    ////////////////////////////////////////////////////////////
+    bool evict();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reload the texture data released by evict
+    ///
+    /// \return True if the texture has its data back
+    ///
+    ////////////////////////////////////////////////////////////
+    bool restore();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Take over the data and state of another texture
+    ///
+    /// This texture must be empty. \a other is left empty, and
+    /// both get a new cache identifier. The caller is in charge
+    /// of cpp3ds::TextureCache and cpp3ds::TextureLoader.
+    ///
+    /// \param other Texture to take the data from
+    ///
+    ////////////////////////////////////////////////////////////
+    void moveFrom(Texture& other);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the texture larger, keeping its pixels
+    ///
+    /// The pixels stay at the same position from the top left
+    /// corner, the new area is filled with \a color. On the 3DS
+    /// the existing tiles are copied as they are, without being
+    /// read back or tiled again. Mipmaps are dropped.
+    ///
+    /// \param width  New width, not smaller than the current one
+    /// \param height New height, not smaller than the current one
+    /// \param color  Color of the new area
+    ///
+    /// \return True if the texture was resized
+    ///
+    ////////////////////////////////////////////////////////////
+    bool grow(unsigned int width, unsigned int height, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the pixels of a background load
+    ///
+    /// Runs on the loader thread, so it doesn't touch the GPU.
+    ///
+    /// \param pixels Pixels of the area of the image to load
+    /// \param pitch  Size of an image row, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepareLoad(const Uint8* pixels, unsigned int pitch);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Hand the pixels of a background load to the GPU
+    ///
+    /// Runs on the rendering thread, after prepareLoad.
+    ///
+    /// \param pixels Pixels of the area of the image to load
+    /// \param pitch  Size of an image row, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void finishLoad(const Uint8* pixels, unsigned int pitch);
+
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a region of the texture from rows of pixels
+    ///
+    /// The rows are tiled straight into the texture memory, so
+    /// they can be part of a larger image.
+    ///
+    /// \param pixels Array of RGBA pixels of the first row
+    /// \param width  Width of the region to update
+    /// \param height Height of the region to update
+    /// \param pitch  Size of a row of \a pixels, in bytes
+    /// \param x      X offset in the texture where to copy the pixels
+    /// \param y      Y offset in the texture where to copy the pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateRegion(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate the texture memory for already tiled data
+    ///
+    /// The data itself is written by the caller.
+    ///
+    /// \param width  Width of the texture data (power of two)
+    /// \param height Height of the texture data (power of two)
+    /// \param format Format of the texture data
+    /// \param mipmap Whether the data includes the whole mipmap chain
+    ///
+    /// \return True if the memory could be allocated
+    ///
+    ////////////////////////////////////////////////////////////
+    bool createPreprocessed(unsigned int width, unsigned int height, GPU_TEXCOLOR format, bool mipmap);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate the texture memory for a texture of a container
+    ///
+    /// \param info Description of the texture in the container
+    ///
+    /// \return True if the memory could be allocated
+    ///
+    ////////////////////////////////////////////////////////////
+    bool createPreprocessed(const priv::ContainerTexture& info);
+#endif
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a region of the texture from texels of its format
+    ///
+    /// The texels are linear rows in the layout of the texture
+    /// format (one byte per texel for A8, for example) and are
+    /// only tiled, not converted. Compressed formats can't be
+    /// updated this way.
+    ///
+    /// \param texels Texels of the first row
+    /// \param width  Width of the region to update
+    /// \param height Height of the region to update
+    /// \param pitch  Size of a row of \a texels, in bytes
+    /// \param x      X offset in the texture where to copy the texels
+    /// \param y      Y offset in the texture where to copy the texels
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateTexels(const Uint8* texels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int x, unsigned int y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch that uses the texture, if any
+    ///
+    /// Render targets only keep a pointer to the texture of
+    /// their pending batch, it must be drawn before the texture
+    /// is destroyed or its data is handed to another texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushBatch() const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Vector2u     m_size;          ///< Public texture size
-    Vector2u     m_actualSize;    ///< Actual texture size (can be greater than public size because of padding)
-    bool         m_isSmooth;      ///< Status of the smooth filter
-    bool         m_isRepeated;    ///< Is the texture in repeat mode?
-    mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
-    Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
+    Vector2u           m_size;           ///< Public texture size
+    Vector2u           m_actualSize;     ///< Actual texture size (can be greater than public size because of padding)
+    Format             m_format;         ///< Pixel format of the texture
+    bool               m_isSmooth;       ///< Status of the smooth filter
+    bool               m_isRepeated;     ///< Is the texture in repeat mode?
+    bool               m_hasMipmap;      ///< Has the mipmap been generated?
+    mutable bool       m_pixelsFlipped;  ///< To work around the inconsistency in Y orientation
+    Uint64             m_cacheId;        ///< Unique number that identifies the texture to the render target's cache
+    std::string        m_sourceFile;     ///< File the pixels were loaded from, empty if they can't be reloaded
+    IntRect            m_sourceArea;     ///< Area of the source file that was loaded
+    bool               m_isPreprocessed; ///< Is the source file a preprocessed texture?
+    unsigned int       m_sourceIndex;    ///< Texture of the source file, if it's a preprocessed container
+    bool               m_isEvicted;      ///< Was the data released by the texture cache?
+    std::vector<Uint8> m_retainedData;   ///< Compressed data kept in main memory while evicted
+    mutable Uint32     m_lastUse;        ///< Frame in which the texture was last bound (see TextureCache)
+    bool               m_isLoading;      ///< Is a background load pending? (see TextureLoader)
+    mutable RenderTarget* m_batchTarget; ///< Render target whose pending batch draws the texture, if any
 #ifdef EMULATION
-    unsigned int m_texture;       ///< Internal texture identifier
+    unsigned int       m_texture;        ///< Internal texture identifier
 #else
-    C3D_Tex*     m_texture;       ///< Internal texture identifier
-    bool         m_ownsData;      ///< Check if this object owns the data and needs to free it
+    C3D_Tex*           m_texture;        ///< Internal texture identifier
+    bool               m_ownsData;       ///< Check if this object owns the data and needs to free it
 #endif
 };
 
@@ -553,10 +932,17 @@ private :
 /// store the collision information separately, for example in an array
 /// of booleans.
 ///
-/// Like cpp3ds::Image, cpp3ds::Texture can handle a unique internal
-/// representation of pixels, which is RGBA 32 bits. This means
+/// Like cpp3ds::Image, cpp3ds::Texture takes and returns pixels
+/// in a unique representation, which is RGBA 32 bits. This means
 /// that a pixel must be composed of 8 bits red, green, blue and
-/// alpha channels -- just like a cpp3ds::Color.
+/// alpha channels -- just like a cpp3ds::Color. The texture can
+/// however store them in a smaller format (see Texture::Format),
+/// for example RGB565 for opaque backgrounds or A8 for masks,
+/// which uses half or a quarter of the memory.
+///
+/// Textures loaded from a file can be evicted from the graphics
+/// memory when it runs short, and are reloaded the next time they
+/// are bound (see cpp3ds::TextureCache).
 ///
 /// Usage example:
 /// \code
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTUREATLAS_HPP
+#define CPP3DS_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <vector>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Texture holding many images, packed together
+///
+////////////////////////////////////////////////////////////
+class TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty atlas, create() must be called before
+    /// images can be added.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the atlas texture
+    ///
+    /// The size should be a power of two (and at most
+    /// Texture::getMaximumSize()), as any other size is rounded
+    /// up by the texture anyway. The texture starts fully
+    /// transparent.
+    ///
+    /// \param width   Width of the atlas
+    /// \param height  Height of the atlas
+    /// \param padding Empty pixels kept around each image, to avoid bleeding when smoothing
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(unsigned int width, unsigned int height, unsigned int padding = 1);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an image to the atlas
+    ///
+    /// The image is packed with the skyline bottom-left
+    /// strategy and copied to the texture right away, so this
+    /// works both when building an atlas offline and while the
+    /// application runs.
+    ///
+    /// \param image Image to add
+    ///
+    /// \return Area of the image in the atlas texture, to be used with Sprite::setTextureRect. Empty if there's not enough room left.
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect add(const Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an array of pixels to the atlas
+    ///
+    /// \param pixels Array of RGBA pixels to add
+    /// \param width  Width of the pixel region
+    /// \param height Height of the pixel region
+    ///
+    /// \return Area of the pixels in the atlas texture. Empty if there's not enough room left.
+    ///
+    /// \see add(const Image&)
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect add(const Uint8* pixels, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reserve an area of the atlas without writing to it
+    ///
+    /// \param width  Width of the area
+    /// \param height Height of the area
+    ///
+    /// \return Reserved area. Empty if there's not enough room left.
+    ///
+    ////////////////////////////////////////////////////////////
+    IntRect reserve(unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forget all the packed images
+    ///
+    /// The texture keeps its pixels, they are only overwritten
+    /// by the next images added.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture of the atlas
+    ///
+    /// \return Reference to the atlas texture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture& getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the atlas texture to an image
+    ///
+    /// This is mostly useful to save an atlas built offline.
+    ///
+    /// \return Image containing the atlas pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Image copyToImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the atlas
+    ///
+    /// \return Size of the atlas, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the fraction of the atlas used by images
+    ///
+    /// \return Used area divided by the total area (padding included), between 0 and 1
+    ///
+    ////////////////////////////////////////////////////////////
+    float getOccupancy() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Horizontal segment of the skyline
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Segment
+    {
+        unsigned int x;     ///< Left of the segment
+        unsigned int y;     ///< Height of the skyline over the segment
+        unsigned int width; ///< Width of the segment
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find where a rectangle would rest on the skyline
+    ///
+    /// \param index  Index of the segment the rectangle starts on
+    /// \param width  Width of the rectangle
+    /// \param height Height of the rectangle
+    /// \param y      Receives the top of the rectangle
+    ///
+    /// \return True if the rectangle fits at this position
+    ///
+    ////////////////////////////////////////////////////////////
+    bool fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Texture              m_texture;  ///< Texture containing the packed images
+    std::vector<Segment> m_skyline;  ///< Top contour of the packed area, from left to right
+    unsigned int         m_padding;  ///< Empty pixels around each image
+    unsigned long        m_usedArea; ///< Number of pixels used by packed areas
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTUREATLAS_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextureAtlas
+/// \ingroup graphics
+///
+/// Each texture switch breaks a batch of draws, and every
+/// texture is padded to a power of two size on the 3DS. Packing
+/// many small images (icons, UI elements, sprite frames) in one
+/// texture avoids both.
+///
+/// Images are placed with the skyline bottom-left heuristic,
+/// which keeps the packing tight without having to know all
+/// the images beforehand.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::TextureAtlas atlas;
+/// atlas.create(512, 512);
+///
+/// cpp3ds::Image icon;
+/// icon.loadFromFile("icon.png");
+/// cpp3ds::IntRect iconRect = atlas.add(icon);
+///
+/// cpp3ds::Sprite sprite(atlas.getTexture(), iconRect);
+/// \endcode
+///
+/// \see cpp3ds::Texture, cpp3ds::Sprite
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTURECACHE_HPP
+#define CPP3DS_TEXTURECACHE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cstddef>
+
+
+namespace cpp3ds
+{
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Keeps the texture memory usage under a budget
+///
+////////////////////////////////////////////////////////////
+class TextureCache
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the amount of texture memory that can be used
+    ///
+    /// When the textures use more than this, the least recently
+    /// bound ones are evicted at the end of the frame, or when
+    /// an evicted texture is reloaded. A budget of 0 (the
+    /// default) disables eviction.
+    ///
+    /// \param bytes Maximum size of the texture data, in bytes
+    ///
+    /// \see getBudget, getMemoryUsage
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setBudget(std::size_t bytes);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the amount of texture memory that can be used
+    ///
+    /// \return Maximum size of the texture data, in bytes (0 if unlimited)
+    ///
+    /// \see setBudget
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::size_t getBudget();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the amount of texture memory currently used
+    ///
+    /// This is the size of the data of every texture that is
+    /// resident, whether it can be evicted or not.
+    ///
+    /// \return Size of the texture data, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::size_t getMemoryUsage();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of binds of a resident texture
+    ///
+    /// \return Number of cache hits since the last reset
+    ///
+    /// \see resetCounters
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getHitCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of binds of an evicted texture
+    ///
+    /// Each of them reloaded the texture from its source.
+    ///
+    /// \return Number of cache misses since the last reset
+    ///
+    /// \see resetCounters
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getMissCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of textures evicted
+    ///
+    /// \return Number of evictions since the last reset
+    ///
+    /// \see resetCounters
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getEvictionCount();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the hit, miss and eviction counters to zero
+    ///
+    ////////////////////////////////////////////////////////////
+    static void resetCounters();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Evict textures until the memory usage fits a size
+    ///
+    /// This is useful to make room before loading a level, for
+    /// example. Textures bound in the current frame are kept,
+    /// the GPU may still read them.
+    ///
+    /// \param bytes Memory usage to reach, in bytes
+    ///
+    /// \return Memory usage after eviction, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::size_t trim(std::size_t bytes);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of frames since a texture was last bound
+    ///
+    /// A texture that is still bound counts as bound in the
+    /// current frame, render targets don't bind it again.
+    ///
+    /// \param texture Texture to check
+    ///
+    /// \return 0 if the texture was bound in the current frame, 1 in the previous one, and so on
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint32 getAge(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark the end of a frame
+    ///
+    /// Enforces the budget, then starts a new frame for the
+    /// recency of the textures. cpp3ds::Game takes care of it
+    /// at the end of each render().
+    ///
+    ////////////////////////////////////////////////////////////
+    static void nextFrame();
+
+private :
+
+    friend class Texture;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start tracking a texture
+    ///
+    /// \param texture Texture being constructed
+    ///
+    ////////////////////////////////////////////////////////////
+    static void add(Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop tracking a texture
+    ///
+    /// \param texture Texture being destroyed
+    ///
+    ////////////////////////////////////////////////////////////
+    static void remove(Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Hand the tracked state of a texture to another one
+    ///
+    /// \param from Texture being moved from
+    /// \param to   Texture being moved to
+    ///
+    ////////////////////////////////////////////////////////////
+    static void move(const Texture& from, const Texture& to);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record that a texture is bound, reloading it if needed
+    ///
+    /// \param texture Texture being bound
+    ///
+    ////////////////////////////////////////////////////////////
+    static void use(const Texture& texture);
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURECACHE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextureCache
+/// \ingroup graphics
+///
+/// The 3DS has little memory that the GPU can read, a game
+/// with many large textures runs out of it quickly.
+/// cpp3ds::TextureCache tracks the data size of every
+/// cpp3ds::Texture, and when the total goes over the budget,
+/// evicts the textures that were bound the longest time ago.
+///
+/// An evicted texture keeps its size and settings, and is
+/// reloaded transparently the next time it is bound. So only
+/// textures whose pixels can be brought back are evicted:
+/// \li textures loaded with loadFromFile or loadFromPreprocessedFile
+///     are read from their file again;
+/// \li compressed textures (ETC1, ETC1A4) keep their data in
+///     main memory, which is less scarce than texture memory.
+///
+/// Textures created or modified by hand (create, update,
+/// RenderTexture) are never evicted.
+///
+/// Reloading a texture from a file is slow, the hit and miss
+/// counters help to pick a budget that doesn't cause stalls.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::TextureCache::setBudget(16 * 1024 * 1024);
+///
+/// // ... load textures and draw as usual ...
+///
+/// if (cpp3ds::TextureCache::getMissCount() > 0)
+///     cpp3ds::err() << "Texture reloads: " << cpp3ds::TextureCache::getMissCount() << std::endl;
+/// \endcode
+///
+/// \see cpp3ds::Texture
+///
+////////////////////////////////////////////////////////////
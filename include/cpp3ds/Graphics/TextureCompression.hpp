@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTURECOMPRESSION_HPP
+#define CPP3DS_TEXTURECOMPRESSION_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Compress RGBA pixels to a region of an ETC1 texture
+///
+/// Blocks are written in the 3DS layout: 8x8 tiles made of
+/// four 4x4 blocks, rows of tiles starting from the bottom
+/// of the image, each block stored as a little endian 64 bits
+/// word. ETC1A4 blocks are preceded by 64 bits of 4 bits
+/// alpha values.
+///
+/// Compression works on whole 4x4 blocks: the region should
+/// be aligned on 4 pixels, other pixels of the blocks it
+/// touches are overwritten with its edge pixels.
+///
+/// This is a CPU-heavy operation, best done when cooking
+/// assets rather than while a game runs.
+///
+/// \param texture       Tiled texture data to write to
+/// \param pixels        Linear RGBA pixels of the region, top row first
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param alpha         True for ETC1A4, false for ETC1
+///
+////////////////////////////////////////////////////////////
+void compressEtc1(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                  unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, bool alpha);
+
+////////////////////////////////////////////////////////////
+/// \brief Decompress a region of an ETC1 texture to RGBA pixels
+///
+/// \param pixels        Linear RGBA pixels to write the region to, top row first
+/// \param texture       Tiled texture data to read from
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param alpha         True for ETC1A4, false for ETC1
+///
+/// \see compressEtc1
+///
+////////////////////////////////////////////////////////////
+void decompressEtc1(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                    unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, bool alpha);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURECOMPRESSION_HPP
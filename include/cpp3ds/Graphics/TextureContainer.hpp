@@ -0,0 +1,385 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTURECONTAINER_HPP
+#define CPP3DS_TEXTURECONTAINER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/System/FileInputStream.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <string>
+#include <vector>
+
+
+namespace cpp3ds
+{
+class InputStream;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Ways a chunk of a texture container can be stored
+///
+////////////////////////////////////////////////////////////
+enum ChunkCompression
+{
+    ChunkRaw,  ///< Stored as is, read straight into texture memory
+    ChunkLz11, ///< LZ77 variant of the 3DS system files (type 0x11)
+    ChunkLz4   ///< LZ4 block format, faster to decode
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Start of a texture container file
+///
+/// All the values of the file are little endian. The header
+/// is followed by the textures, the chunks and the rects,
+/// then by the chunk data.
+///
+////////////////////////////////////////////////////////////
+struct ContainerHeader
+{
+    char   magic[4];     ///< "CTEX"
+    Uint16 version;      ///< Version of the format, 2
+    Uint16 textureCount; ///< Number of textures
+    Uint16 rectCount;    ///< Number of atlas rects
+    Uint16 alignment;    ///< Alignment of the chunk data in the file, in bytes
+    Uint32 chunkCount;   ///< Number of chunks, one per texture level
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Texture stored in a container
+///
+////////////////////////////////////////////////////////////
+struct ContainerTexture
+{
+    Uint16 format;         ///< Texture::Format of the data
+    Uint16 width;          ///< Width of the texture data (power of two)
+    Uint16 height;         ///< Height of the texture data (power of two)
+    Uint16 originalWidth;  ///< Width of the source image
+    Uint16 originalHeight; ///< Height of the source image
+    Uint16 levelCount;     ///< 1, or the whole mipmap chain
+    Uint16 left;           ///< Left of the texture in a larger image (see BigTexture)
+    Uint16 top;            ///< Top of the texture in a larger image (see BigTexture)
+    Uint32 firstChunk;     ///< Index of the chunk of the base level
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Level of a texture stored in a container
+///
+////////////////////////////////////////////////////////////
+struct ContainerChunk
+{
+    Uint32 offset;      ///< Position of the data in the file
+    Uint32 size;        ///< Size of the stored data, in bytes
+    Uint32 rawSize;     ///< Size of the level in texture memory, in bytes
+    Uint32 compression; ///< ChunkCompression of the data
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Area of a texture of a container, for atlases
+///
+////////////////////////////////////////////////////////////
+struct ContainerRect
+{
+    Uint16 texture; ///< Index of the texture that holds the area
+    Uint16 left;    ///< Left of the area in the texture
+    Uint16 top;     ///< Top of the area in the texture
+    Uint16 width;   ///< Width of the area
+    Uint16 height;  ///< Height of the area
+    Uint16 padding; ///< Unused
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Reads texture container files
+///
+/// Only the tables are read when the container is opened.
+/// The levels are read straight into the memory given by
+/// the caller, normally the texture memory: raw chunks are
+/// read with a single call, compressed ones are decoded
+/// from a small buffer.
+///
+////////////////////////////////////////////////////////////
+class TextureContainer : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureContainer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a container file
+    ///
+    /// \param filename Path of the file to open
+    ///
+    /// \return True if the file is a valid container
+    ///
+    ////////////////////////////////////////////////////////////
+    bool openFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Open a container from a stream
+    ///
+    /// The stream must stay alive while the container is used.
+    ///
+    /// \param stream Source stream to read from
+    ///
+    /// \return True if the stream holds a valid container
+    ///
+    ////////////////////////////////////////////////////////////
+    bool openFromStream(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a stream starts like a container
+    ///
+    /// The stream is left at its beginning.
+    ///
+    /// \param stream Stream to check
+    ///
+    /// \return True if the stream starts with the container magic
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isContainer(InputStream& stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of textures
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getTextureCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the description of a texture
+    ///
+    /// \param index Index of the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    const ContainerTexture& getTexture(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the chunk of a texture level
+    ///
+    /// \param texture Index of the texture
+    /// \param level   Level of the texture, 0 for the base one
+    ///
+    ////////////////////////////////////////////////////////////
+    const ContainerChunk& getChunk(std::size_t texture, unsigned int level) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of atlas rects
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getRectCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return an atlas rect
+    ///
+    /// \param index Index of the rect
+    ///
+    ////////////////////////////////////////////////////////////
+    const ContainerRect& getRect(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of all the levels of a texture
+    ///
+    /// \param texture Index of the texture
+    ///
+    /// \return Size of the texture data, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getDataSize(std::size_t texture) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read all the levels of a texture
+    ///
+    /// The levels are written one after the other, the way
+    /// citro3d lays out a mipmapped texture.
+    ///
+    /// \param texture Index of the texture
+    /// \param data    Memory of getDataSize(texture) bytes to write to
+    ///
+    /// \return True if all the levels could be read
+    ///
+    ////////////////////////////////////////////////////////////
+    bool readTexture(std::size_t texture, void* data);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    FileInputStream               m_file;     ///< File opened by openFromFile
+    InputStream*                  m_stream;   ///< Stream the container is read from
+    std::vector<ContainerTexture> m_textures; ///< Textures of the container
+    std::vector<ContainerChunk>   m_chunks;   ///< Chunks of all the texture levels
+    std::vector<ContainerRect>    m_rects;    ///< Atlas rects
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Builds texture container files
+///
+/// Used to cook textures ahead of time. Levels are compressed
+/// as they are added, and stored raw if that doesn't make
+/// them smaller.
+///
+////////////////////////////////////////////////////////////
+class TextureContainerWriter
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a texture, without any level yet
+    ///
+    /// \param format         Format of the texture data
+    /// \param width          Width of the texture data (power of two, 8 to 1024)
+    /// \param height         Height of the texture data (power of two, 8 to 1024)
+    /// \param originalWidth  Width of the source image
+    /// \param originalHeight Height of the source image
+    /// \param left           Left of the texture in a larger image
+    /// \param top            Top of the texture in a larger image
+    ///
+    /// \return Index of the texture, or -1 if the parameters are invalid
+    ///
+    ////////////////////////////////////////////////////////////
+    int addTexture(Texture::Format format, unsigned int width, unsigned int height,
+                   unsigned int originalWidth, unsigned int originalHeight,
+                   unsigned int left = 0, unsigned int top = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the next level of a texture
+    ///
+    /// The base level comes first, then the mipmap levels in
+    /// order. Either only the base level or the whole chain
+    /// must be added.
+    ///
+    /// \param texture     Index of the texture
+    /// \param data        Tiled data of the level
+    /// \param size        Size of the data, in bytes
+    /// \param compression How to store the data
+    ///
+    /// \return True if the level has the expected size
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addLevel(std::size_t texture, const void* data, std::size_t size, ChunkCompression compression);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an atlas rect
+    ///
+    /// \param texture   Index of the texture that holds the area
+    /// \param rectangle Area in the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void addRect(std::size_t texture, const IntRect& rectangle);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the container to memory
+    ///
+    /// \param data Array to fill with the file contents
+    ///
+    /// \return True if every texture has a valid set of levels
+    ///
+    ////////////////////////////////////////////////////////////
+    bool save(std::vector<Uint8>& data) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the container to a file
+    ///
+    /// \param filename Path of the file to write
+    ///
+    /// \return True if saving was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::string& filename) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Level waiting to be written
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Level
+    {
+        ChunkCompression   compression; ///< How the data is stored
+        std::size_t        rawSize;     ///< Size of the level in texture memory
+        std::vector<Uint8> data;        ///< Stored data
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<ContainerTexture>    m_textures; ///< Textures added so far
+    std::vector<std::vector<Level> > m_levels;   ///< Levels of each texture
+    std::vector<ContainerRect>       m_rects;    ///< Atlas rects
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Compress data in the LZ11 format
+///
+/// \param data   Data to compress
+/// \param size   Size of the data, in bytes
+/// \param output Array to fill with the compressed data
+///
+////////////////////////////////////////////////////////////
+void compressLz11(const Uint8* data, std::size_t size, std::vector<Uint8>& output);
+
+////////////////////////////////////////////////////////////
+/// \brief Compress data in the LZ4 block format
+///
+/// \param data   Data to compress
+/// \param size   Size of the data, in bytes
+/// \param output Array to fill with the compressed data
+///
+////////////////////////////////////////////////////////////
+void compressLz4(const Uint8* data, std::size_t size, std::vector<Uint8>& output);
+
+////////////////////////////////////////////////////////////
+/// \brief Decompress a chunk from a stream
+///
+/// The output is written directly, and earlier output is
+/// read back for the matches, so it can be texture memory.
+///
+/// \param stream      Stream positioned at the chunk data
+/// \param size        Size of the chunk data, in bytes
+/// \param compression Format of the chunk data
+/// \param output      Memory to write the decompressed data to
+/// \param outputSize  Expected size of the decompressed data
+///
+/// \return True if the chunk decompressed to exactly \a outputSize bytes
+///
+////////////////////////////////////////////////////////////
+bool decompressChunk(InputStream& stream, std::size_t size, ChunkCompression compression, Uint8* output, std::size_t outputSize);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURECONTAINER_HPP
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTURELOADER_HPP
+#define CPP3DS_TEXTURELOADER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Color.hpp>
+#include <cpp3ds/Graphics/Rect.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <string>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+/// \brief Loads textures in the background, as a group
+///
+////////////////////////////////////////////////////////////
+class TextureLoader : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty group.
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureLoader();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The pending loads are not cancelled, they just stop
+    /// being part of the group.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureLoader();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading a texture from a file, as part of the group
+    ///
+    /// This works like Texture::loadFromFileAsync.
+    ///
+    /// \param texture  Texture to load
+    /// \param filename Path of the image file to load
+    /// \param area     Area of the image to load
+    /// \param format   Pixel format to store the texture in
+    ///
+    /// \return True if the load was started
+    ///
+    /// \see Texture::loadFromFileAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(Texture& texture, const std::string& filename, const IntRect& area = IntRect(), Texture::Format format = Texture::RGBA8);
+
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Start loading a texture of a preprocessed container, as part of the group
+    ///
+    /// This works like Texture::loadFromPreprocessedFileAsync.
+    ///
+    /// \param texture  Texture to load
+    /// \param filename Path of the container file to load
+    /// \param index    Index of the texture in the file
+    ///
+    /// \return True if the load was started
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromPreprocessedFile(Texture& texture, const std::string& filename, unsigned int index = 0);
+#endif
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of loads of the group not finished yet
+    ///
+    /// \return Number of pending loads
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getPendingCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of loads of the group that failed
+    ///
+    /// A texture that failed to load is left transparent.
+    ///
+    /// \return Number of failed loads
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getFailureCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until all the loads of the group are finished
+    ///
+    /// Like update, this must be called from the thread that
+    /// renders.
+    ///
+    /// \return True if none of the loads of the group failed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool wait();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Finish the loads that have been decoded
+    ///
+    /// Decoding happens in a background thread, but the
+    /// textures can only be handed to the GPU by the thread
+    /// that renders. cpp3ds::Game calls this at the end of
+    /// each render().
+    ///
+    ////////////////////////////////////////////////////////////
+    static void update();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the color shown by textures being loaded
+    ///
+    /// The default is opaque grey.
+    ///
+    /// \param color New placeholder color
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setPlaceholderColor(const Color& color);
+
+private :
+
+    friend class Texture;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the texture and queue the decoding of its file
+    ///
+    /// \param texture  Texture to load
+    /// \param filename Path of the image file to load
+    /// \param area     Area of the image to load
+    /// \param format   Pixel format to store the texture in
+    /// \param group    Group of the load, can be null
+    ///
+    /// \return True if the load was started
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool load(Texture& texture, const std::string& filename, const IntRect& area, Texture::Format format, TextureLoader* group);
+
+#ifndef EMULATION
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the texture and queue the reading of its container
+    ///
+    /// \param texture  Texture to load
+    /// \param filename Path of the container file to load
+    /// \param index    Index of the texture in the file
+    /// \param group    Group of the load, can be null
+    ///
+    /// \return True if the load was started
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool loadPreprocessed(Texture& texture, const std::string& filename, unsigned int index, TextureLoader* group);
+#endif
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue the load of a created texture
+    ///
+    /// \param texture      Texture to load
+    /// \param filename     Path of the file to load
+    /// \param area         Area of the image to load
+    /// \param index        Index of the texture in a container
+    /// \param preprocessed Is the file a preprocessed container?
+    /// \param group        Group of the load, can be null
+    ///
+    ////////////////////////////////////////////////////////////
+    static void start(Texture& texture, const std::string& filename, const IntRect& area, unsigned int index, bool preprocessed, TextureLoader* group);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the pending load of a texture
+    ///
+    /// Waits if the texture is being decoded.
+    ///
+    /// \param texture Texture being loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    static void cancel(Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move a texture along with its pending load
+    ///
+    /// Waits if the texture is being decoded, then gives the
+    /// data and the load of \a from to \a to.
+    ///
+    /// \param from Texture being loaded
+    /// \param to   Empty texture taking over
+    ///
+    ////////////////////////////////////////////////////////////
+    static void move(Texture& from, Texture& to);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the texture bound instead of the ones being loaded
+    ///
+    /// \return Placeholder texture
+    ///
+    ////////////////////////////////////////////////////////////
+    static const Texture& getPlaceholder();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode the queued files, until there are none left
+    ///
+    /// This is the entry point of the loader thread.
+    ///
+    ////////////////////////////////////////////////////////////
+    static void run();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::size_t m_failures; ///< Number of loads of the group that failed
+};
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURELOADER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::TextureLoader
+/// \ingroup graphics
+///
+/// Loading a texture from a file takes a while: the image
+/// has to be decoded, then tiled (and maybe compressed) into
+/// the layout of the GPU. Done when a level streams in, it
+/// stalls the game for several frames.
+///
+/// Texture::loadFromFileAsync and TextureLoader::loadFromFile
+/// do the decoding and tiling in a background thread, with a
+/// lower priority than the main one, so it mostly runs while
+/// the main thread waits for the vertical blank. Only the
+/// final cache flush happens on the rendering thread, in
+/// update().
+///
+/// The texture gets its final size right away, so that it
+/// can be given to sprites, and shows a placeholder color
+/// until the load is finished.
+///
+/// A cpp3ds::TextureLoader instance is a group of loads,
+/// which can be waited for together (a loading screen for
+/// example).
+///
+/// Usage example:
+/// \code
+/// cpp3ds::Texture background, tiles;
+/// cpp3ds::TextureLoader loader;
+/// loader.loadFromFile(background, "images/background.png");
+/// loader.loadFromFile(tiles, "images/tiles.png", cpp3ds::IntRect(), cpp3ds::Texture::RGBA4);
+///
+/// // ... draw a loading screen while loader.getPendingCount() > 0 ...
+///
+/// // or block until all the textures are there
+/// if (!loader.wait())
+///     cpp3ds::err() << "Some textures failed to load" << std::endl;
+/// \endcode
+///
+/// \see cpp3ds::Texture
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_TEXTURETILING_HPP
+#define CPP3DS_TEXTURETILING_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cstddef>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Copy linear pixels to a region of a tiled texture
+///
+/// The texture is laid out the way the 3DS GPU reads it:
+/// 8x8 tiles in Z-order, rows of tiles starting from the
+/// bottom of the image. 24 and 32 bits pixels have their
+/// bytes reversed (RGBA becomes ABGR), other depths are
+/// copied as they are.
+///
+/// \param texture       Tiled texture data to write to
+/// \param pixels        Linear pixels of the region, top row first
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param bitsPerPixel  Depth of the pixels: 4, 8, 16, 24 or 32
+///
+/// \return False if the pixel depth isn't supported
+///
+////////////////////////////////////////////////////////////
+bool tileImage(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+               unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel);
+
+////////////////////////////////////////////////////////////
+/// \brief Copy a region of a tiled texture to linear pixels
+///
+/// This is the exact inverse of tileImage.
+///
+/// \param pixels        Linear pixels to write the region to, top row first
+/// \param texture       Tiled texture data to read from
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param bitsPerPixel  Depth of the pixels: 4, 8, 16, 24 or 32
+///
+/// \return False if the pixel depth isn't supported
+///
+////////////////////////////////////////////////////////////
+bool untileImage(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                 unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel);
+
+////////////////////////////////////////////////////////////
+/// \brief Copy RGBA pixels to a region of a tiled texture, converting them
+///
+/// Same as the other overload, but the pixels are always
+/// 32-bits RGBA and get converted to \a format on the way.
+/// ETC1 formats are compressed (see compressEtc1).
+///
+/// \param texture       Tiled texture data to write to
+/// \param pixels        Linear RGBA pixels of the region, top row first
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param format        Format of the texture
+///
+/// \return False if the format isn't supported
+///
+////////////////////////////////////////////////////////////
+bool tileImage(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+               unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, Texture::Format format);
+
+////////////////////////////////////////////////////////////
+/// \brief Copy a region of a tiled texture to RGBA pixels, converting them
+///
+/// This is the inverse of tileImage, precision lost by the
+/// texture format is of course not recovered.
+///
+/// \param pixels        Linear RGBA pixels to write the region to, top row first
+/// \param texture       Tiled texture data to read from
+/// \param x             X offset of the region in the texture
+/// \param y             Y offset of the region in the texture (from the top)
+/// \param width         Width of the region
+/// \param height        Height of the region
+/// \param pitch         Size of a row of \a pixels, in bytes
+/// \param textureWidth  Width of the texture (multiple of 8)
+/// \param textureHeight Height of the texture (multiple of 8)
+/// \param format        Format of the texture
+///
+/// \return False if the format isn't supported
+///
+////////////////////////////////////////////////////////////
+bool untileImage(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                 unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, Texture::Format format);
+
+////////////////////////////////////////////////////////////
+/// \brief Tile RGBA pixels into an RGBA8 texture of the same size, in place
+///
+/// The image must fill the texture exactly, so the tiled data
+/// takes the same room as the pixels. Only two bands of 8 rows
+/// are buffered, which lets an image be decoded straight into
+/// texture memory without a second full-size buffer.
+///
+/// \param pixels Linear RGBA pixels, replaced by the tiled texture data
+/// \param width  Width of the image (multiple of 8)
+/// \param height Height of the image (multiple of 8)
+///
+////////////////////////////////////////////////////////////
+void tileImageInPlace(Uint8* pixels, unsigned int width, unsigned int height);
+
+////////////////////////////////////////////////////////////
+/// \brief Copy a tiled texture into a larger one
+///
+/// The pixels keep their position from the top left corner.
+/// Whole rows of tiles are copied, nothing gets untiled. The
+/// rest of the larger texture is filled with \a fillTile.
+///
+/// \param texture       Tiled texture data to write to
+/// \param source        Tiled texture data of the smaller texture
+/// \param sourceWidth   Width of the smaller texture (multiple of 8)
+/// \param sourceHeight  Height of the smaller texture (multiple of 8)
+/// \param textureWidth  Width of the larger texture (multiple of 8)
+/// \param textureHeight Height of the larger texture (multiple of 8)
+/// \param bitsPerPixel  Depth of the texels
+/// \param fillTile      One tile of texture data to fill the new area with
+///
+////////////////////////////////////////////////////////////
+void growTiledImage(Uint8* texture, const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+                    unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel, const Uint8* fillTile);
+
+////////////////////////////////////////////////////////////
+/// \brief Convert linear RGBA pixels to texels of a format, without tiling
+///
+/// Texels are written the way the 3DS GPU stores them:
+/// 16 bits formats as native 16 bits values, RGBA8 as ABGR.
+/// Compressed formats aren't supported, they need tiling.
+///
+/// \param texels Destination texels
+/// \param pixels Source RGBA pixels
+/// \param count  Number of pixels to convert
+/// \param format Format of the texels
+///
+////////////////////////////////////////////////////////////
+void convertPixels(Uint8* texels, const Uint8* pixels, std::size_t count, Texture::Format format);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the number of bits used by a texel of a format
+///
+/// \param format Texture format
+///
+/// \return Bits per texel
+///
+////////////////////////////////////////////////////////////
+unsigned int getBitsPerPixel(Texture::Format format);
+
+////////////////////////////////////////////////////////////
+/// \brief Halve the size of RGBA pixels with a 2x2 box filter
+///
+/// \param destination Destination pixels, (width / 2) x (height / 2)
+/// \param source      Source pixels
+/// \param width       Width of the source (even)
+/// \param height      Height of the source (even)
+///
+////////////////////////////////////////////////////////////
+void halveImage(Uint8* destination, const Uint8* source, unsigned int width, unsigned int height);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the number of levels in a texture mipmap chain
+///
+/// The chain stops at the first level smaller than a tile
+/// (8 pixels) in either direction, as the GPU does.
+///
+/// \param width  Width of the texture
+/// \param height Height of the texture
+///
+/// \return Number of levels, including the base one
+///
+////////////////////////////////////////////////////////////
+unsigned int getMipmapLevelCount(unsigned int width, unsigned int height);
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_TEXTURETILING_HPP
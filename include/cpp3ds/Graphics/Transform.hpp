@@ -30,12 +30,15 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Rect.hpp>
 #include <cpp3ds/System/Vector2.hpp>
+#include <cstddef>
 #ifndef EMULATION
 #include <c3d/types.h>
 #endif
 
 namespace cpp3ds
 {
+class Vertex;
+
 ////////////////////////////////////////////////////////////
 /// \brief Define a 3x3 transform matrix
 ///
@@ -135,6 +138,25 @@ public :
     ////////////////////////////////////////////////////////////
     FloatRect transformRect(const FloatRect& rectangle) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform an array of vertices
+    ///
+    /// The positions are transformed, while the colors and
+    /// texture coordinates are copied as is. This is much faster
+    /// than calling transformPoint for each vertex: the matrix is
+    /// only read once and the vertices are processed four at a
+    /// time, so that the compiler can interleave (or vectorize)
+    /// their multiply-adds.
+    ///
+    /// The source and destination arrays must not overlap.
+    ///
+    /// \param source      Vertices to transform
+    /// \param destination Array receiving the transformed vertices
+    /// \param count       Number of vertices to transform
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformVertices(const Vertex* source, Vertex* destination, std::size_t count) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Combine the current transform with another one
     ///
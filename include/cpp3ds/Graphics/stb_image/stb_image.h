@@ -880,8 +880,11 @@ static stbi_uc *stbi__pnm_load(stbi__context *s, int *x, int *y, int *comp, int
 static int      stbi__pnm_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
-// this is not threadsafe
-static const char *stbi__g_failure_reason;
+// this is not threadsafe, unless STBI_THREAD_LOCAL is defined
+#ifndef STBI_THREAD_LOCAL
+#define STBI_THREAD_LOCAL
+#endif
+static STBI_THREAD_LOCAL const char *stbi__g_failure_reason;
 
 STBIDEF const char *stbi_failure_reason(void)
 {
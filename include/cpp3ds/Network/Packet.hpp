@@ -65,6 +65,45 @@ public:
     ////////////////////////////////////////////////////////////
     virtual ~Packet();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet(const Packet& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move constructor
+    ///
+    /// The data buffer is taken over without being copied,
+    /// \a other is left empty.
+    ///
+    /// \param other Instance to move from
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet(Packet&& other) noexcept;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet& operator =(const Packet& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of move assignment operator
+    ///
+    /// \param right Instance to move from, left empty
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet& operator =(Packet&& right) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Append data to the end of the packet
     ///
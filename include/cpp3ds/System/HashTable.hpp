@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef CPP3DS_HASHTABLE_HPP
+#define CPP3DS_HASHTABLE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cstddef>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Open addressing hash table with integer keys
+///
+/// Lookups probe a flat array of keys, so they touch much
+/// less memory than a tree walk. Values are stored apart in
+/// a deque: references to them stay valid until clear().
+/// Values can't be removed one by one.
+///
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+class HashTable
+{
+    static_assert(std::is_integral<Key>::value, "HashTable keys must be integers");
+
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// No memory is allocated until the first insertion.
+    ///
+    ////////////////////////////////////////////////////////////
+    HashTable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the value of a key
+    ///
+    /// \param key Key to look for
+    ///
+    /// \return Pointer to the value, or NULL if \a key isn't in the table
+    ///
+    ////////////////////////////////////////////////////////////
+    Value* find(Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the value of a key
+    ///
+    /// \param key Key to look for
+    ///
+    /// \return Pointer to the value, or NULL if \a key isn't in the table
+    ///
+    ////////////////////////////////////////////////////////////
+    const Value* find(Key key) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a value, unless its key is already in the table
+    ///
+    /// \param key   Key of the value
+    /// \param value Value to add
+    ///
+    /// \return Reference to the value of \a key, the existing one if any
+    ///
+    ////////////////////////////////////////////////////////////
+    Value& insert(Key key, const Value& value);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the value of a key, adding a default one if needed
+    ///
+    /// \param key Key of the value
+    ///
+    /// \return Reference to the value of \a key
+    ///
+    ////////////////////////////////////////////////////////////
+    Value& operator [](Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of values in the table
+    ///
+    /// \return Number of values
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the values and release the memory
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Entry of the key array
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Slot
+    {
+        Key         key;   ///< Key stored in the slot
+        std::size_t index; ///< Index of the value in m_values, Empty if the slot is free
+    };
+
+    static const std::size_t Empty = static_cast<std::size_t>(-1);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the slot holding a key, or the free slot where it goes
+    ///
+    /// \param key Key to look for
+    ///
+    /// \return Index of the slot, the table must not be empty
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t findSlot(Key key) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a slot for a key that isn't in the table
+    ///
+    /// \param key Key to add
+    ///
+    /// \return Index of the new slot, pointing to the end of m_values
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t addSlot(Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rebuild the key array with more slots
+    ///
+    /// \param capacity New number of slots, a power of two
+    ///
+    ////////////////////////////////////////////////////////////
+    void rehash(std::size_t capacity);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Slot> m_slots;  ///< Key array, its size is a power of two
+    std::deque<Value> m_values; ///< Values, in insertion order
+    unsigned int      m_shift;  ///< Shift bringing the hash of a key down to a slot index
+};
+
+#include <cpp3ds/System/HashTable.inl>
+
+} // namespace priv
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_HASHTABLE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class cpp3ds::priv::HashTable
+/// \ingroup system
+///
+/// Keys are hashed with a Fibonacci multiplication and
+/// collisions are resolved by linear probing. The key array
+/// is kept at most three quarters full.
+///
+/// Usage example:
+/// \code
+/// cpp3ds::priv::HashTable<cpp3ds::Uint32, float> widths;
+/// widths.insert('a', 9.f);
+///
+/// if (const float* width = widths.find('a'))
+///     std::cout << *width << std::endl;
+/// \endcode
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+inline HashTable<Key, Value>::HashTable() :
+m_slots (),
+m_values(),
+m_shift (64)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+inline Value* HashTable<Key, Value>::find(Key key)
+{
+    if (m_values.empty())
+        return NULL;
+
+    std::size_t index = m_slots[findSlot(key)].index;
+    return (index != Empty) ? &m_values[index] : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+inline const Value* HashTable<Key, Value>::find(Key key) const
+{
+    if (m_values.empty())
+        return NULL;
+
+    std::size_t index = m_slots[findSlot(key)].index;
+    return (index != Empty) ? &m_values[index] : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+Value& HashTable<Key, Value>::insert(Key key, const Value& value)
+{
+    if (Value* existing = find(key))
+        return *existing;
+
+    addSlot(key);
+    m_values.push_back(value);
+
+    return m_values.back();
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+Value& HashTable<Key, Value>::operator [](Key key)
+{
+    if (Value* existing = find(key))
+        return *existing;
+
+    addSlot(key);
+    m_values.emplace_back();
+
+    return m_values.back();
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+inline std::size_t HashTable<Key, Value>::getSize() const
+{
+    return m_values.size();
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+void HashTable<Key, Value>::clear()
+{
+    std::vector<Slot>().swap(m_slots);
+    std::deque<Value>().swap(m_values);
+    m_shift = 64;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+inline std::size_t HashTable<Key, Value>::findSlot(Key key) const
+{
+    // Fibonacci hashing: the top bits of the product depend on all the key bits
+    std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = static_cast<std::size_t>((static_cast<Uint64>(key) * 0x9E3779B97F4A7C15ULL) >> m_shift);
+
+    while ((m_slots[slot].index != Empty) && (m_slots[slot].key != key))
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+std::size_t HashTable<Key, Value>::addSlot(Key key)
+{
+    // Keep at least a quarter of the slots free, so that probes stay short
+    if ((m_values.size() + 1) * 4 > m_slots.size() * 3)
+        rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+    std::size_t slot = findSlot(key);
+    m_slots[slot].key   = key;
+    m_slots[slot].index = m_values.size();
+
+    return slot;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename Key, typename Value>
+void HashTable<Key, Value>::rehash(std::size_t capacity)
+{
+    Slot free = {Key(), Empty};
+    std::vector<Slot> slots(capacity, free);
+    slots.swap(m_slots);
+
+    m_shift = 64;
+    for (std::size_t size = capacity; size > 1; size /= 2)
+        --m_shift;
+
+    // Values keep their index, only their keys move
+    for (typename std::vector<Slot>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+        if (it->index != Empty)
+            m_slots[findSlot(it->key)] = *it;
+}
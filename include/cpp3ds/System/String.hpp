@@ -154,6 +154,17 @@ public :
     ////////////////////////////////////////////////////////////
     String(const String& copy);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Move constructor
+    ///
+    /// The characters are taken over without being copied,
+    /// \a other is left empty.
+    ///
+    /// \param other Instance to move from
+    ///
+    ////////////////////////////////////////////////////////////
+    String(String&& other) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Create a new cpp3ds::String from a UTF-8 encoded string
     ///
@@ -305,6 +316,16 @@ public :
     ////////////////////////////////////////////////////////////
     String& operator =(const String& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of move assignment operator
+    ///
+    /// \param right Instance to move from, left empty
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    String& operator =(String&& right) noexcept;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of += operator to append an UTF-32 string
     ///
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "Cooker.hpp"
+#include <cpp3ds/Audio/InputSoundFile.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    void writeUint16(std::vector<cpp3ds::Uint8>& data, cpp3ds::Uint16 value)
+    {
+        data.push_back(static_cast<cpp3ds::Uint8>(value));
+        data.push_back(static_cast<cpp3ds::Uint8>(value >> 8));
+    }
+
+    void writeUint32(std::vector<cpp3ds::Uint8>& data, cpp3ds::Uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            data.push_back(static_cast<cpp3ds::Uint8>(value >> (i * 8)));
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace cooker
+{
+////////////////////////////////////////////////////////////
+bool cookSound(const std::vector<Uint8>& source, const Settings& settings, std::vector<CookedFile>& output)
+{
+    InputSoundFile file;
+    if (source.empty() || !file.openFromMemory(&source[0], source.size()))
+        return false;
+
+    unsigned int channelCount = file.getChannelCount();
+    unsigned int sampleRate   = file.getSampleRate();
+    if (channelCount == 0 || sampleRate == 0)
+        return false;
+
+    std::vector<Int16> samples(static_cast<std::size_t>(file.getSampleCount()));
+    if (!samples.empty())
+        samples.resize(static_cast<std::size_t>(file.read(&samples[0], samples.size())));
+    samples.resize(samples.size() - samples.size() % channelCount);
+
+    // Mix down to mono
+    if (settings.mono && channelCount > 1)
+    {
+        std::size_t frameCount = samples.size() / channelCount;
+        for (std::size_t frame = 0; frame < frameCount; ++frame)
+        {
+            int sum = 0;
+            for (unsigned int channel = 0; channel < channelCount; ++channel)
+                sum += samples[frame * channelCount + channel];
+            samples[frame] = static_cast<Int16>(sum / static_cast<int>(channelCount));
+        }
+
+        samples.resize(frameCount);
+        channelCount = 1;
+    }
+
+    // Linear resampling, a lower rate saves memory and mixing time on the DSP
+    if (settings.sampleRate != 0 && settings.sampleRate != sampleRate && !samples.empty())
+    {
+        std::size_t frameCount = samples.size() / channelCount;
+        std::size_t newFrameCount = static_cast<std::size_t>(static_cast<Uint64>(frameCount) * settings.sampleRate / sampleRate);
+        double step = static_cast<double>(sampleRate) / settings.sampleRate;
+
+        std::vector<Int16> resampled(newFrameCount * channelCount);
+        for (std::size_t frame = 0; frame < newFrameCount; ++frame)
+        {
+            double position = frame * step;
+            std::size_t first = static_cast<std::size_t>(position);
+            std::size_t second = std::min(first + 1, frameCount - 1);
+            double weight = position - first;
+
+            for (unsigned int channel = 0; channel < channelCount; ++channel)
+            {
+                double a = samples[first * channelCount + channel];
+                double b = samples[second * channelCount + channel];
+                resampled[frame * channelCount + channel] = static_cast<Int16>(a + (b - a) * weight);
+            }
+        }
+
+        samples.swap(resampled);
+        sampleRate = settings.sampleRate;
+    }
+
+    // 16 bits PCM wave file, which the device reads without decoding
+    Uint32 dataSize = static_cast<Uint32>(samples.size() * 2);
+
+    output.push_back(CookedFile());
+    std::vector<Uint8>& data = output.back().data;
+    output.back().extension = "wav";
+
+    data.reserve(44 + dataSize);
+    data.insert(data.end(), "RIFF", "RIFF" + 4);
+    writeUint32(data, 36 + dataSize);
+    data.insert(data.end(), "WAVE", "WAVE" + 4);
+    data.insert(data.end(), "fmt ", "fmt " + 4);
+    writeUint32(data, 16);
+    writeUint16(data, 1);
+    writeUint16(data, static_cast<Uint16>(channelCount));
+    writeUint32(data, sampleRate);
+    writeUint32(data, sampleRate * channelCount * 2);
+    writeUint16(data, static_cast<Uint16>(channelCount * 2));
+    writeUint16(data, 16);
+    data.insert(data.end(), "data", "data" + 4);
+    writeUint32(data, dataSize);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        writeUint16(data, static_cast<Uint16>(samples[i]));
+
+    return true;
+}
+
+} // namespace cooker
+
+} // namespace cpp3ds
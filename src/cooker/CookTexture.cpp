@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "Cooker.hpp"
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/TextureTiling.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+    // Largest texture of the 3DS GPU; Texture::getMaximumSize() would ask the host GPU
+    const unsigned int maximumSize = 1024;
+
+    unsigned int getValidSize(unsigned int size)
+    {
+        // Same rule as the textures of the device: a power of two, at least 8
+        unsigned int powerOfTwo = 8;
+        while (powerOfTwo < size)
+            powerOfTwo *= 2;
+
+        return powerOfTwo;
+    }
+
+    // Copy a region of an image to a texture-sized buffer, repeating the
+    // edge pixels over the padding so that filtering and mipmaps don't
+    // bleed transparent black into the image
+    void extractRegion(std::vector<cpp3ds::Uint8>& region, const std::vector<cpp3ds::Uint8>& pixels, unsigned int imageWidth,
+                       unsigned int left, unsigned int top, unsigned int width, unsigned int height,
+                       unsigned int textureWidth, unsigned int textureHeight)
+    {
+        region.resize(textureWidth * textureHeight * 4);
+
+        for (unsigned int y = 0; y < textureHeight; ++y)
+        {
+            const cpp3ds::Uint8* source = &pixels[((top + std::min(y, height - 1)) * imageWidth + left) * 4];
+            cpp3ds::Uint8* destination = &region[y * textureWidth * 4];
+
+            std::memcpy(destination, source, width * 4);
+            for (unsigned int x = width; x < textureWidth; ++x)
+                std::memcpy(destination + x * 4, source + (width - 1) * 4, 4);
+        }
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace cooker
+{
+////////////////////////////////////////////////////////////
+bool cookTexture(const std::vector<Uint8>& source, const Settings& settings, std::vector<CookedFile>& output)
+{
+    std::vector<Uint8> pixels;
+    Vector2u size;
+    if (source.empty() || !priv::ImageLoader::getInstance().loadImageFromMemory(&source[0], source.size(), pixels, size))
+        return false;
+
+    unsigned int tileSize = std::min(settings.tileSize, maximumSize);
+    if (tileSize == 0)
+    {
+        err() << "Invalid tile size" << std::endl;
+        return false;
+    }
+
+    priv::TextureContainerWriter writer;
+    std::vector<Uint8> region;
+    std::vector<Uint8> halved;
+    std::vector<Uint8> texels;
+
+    // Images larger than a tile become several textures, placed where they belong for BigTexture
+    for (unsigned int top = 0; top < size.y; top += tileSize)
+    {
+        for (unsigned int left = 0; left < size.x; left += tileSize)
+        {
+            unsigned int width  = std::min(tileSize, size.x - left);
+            unsigned int height = std::min(tileSize, size.y - top);
+            unsigned int textureWidth  = getValidSize(width);
+            unsigned int textureHeight = getValidSize(height);
+
+            int texture = writer.addTexture(settings.textureFormat, textureWidth, textureHeight, width, height, left, top);
+            if (texture < 0)
+                return false;
+
+            extractRegion(region, pixels, size.x, left, top, width, height, textureWidth, textureHeight);
+
+            unsigned int levelCount = settings.mipmap ? priv::getMipmapLevelCount(textureWidth, textureHeight) : 1;
+            for (unsigned int level = 0; level < levelCount; ++level)
+            {
+                unsigned int levelWidth  = textureWidth >> level;
+                unsigned int levelHeight = textureHeight >> level;
+
+                texels.assign(levelWidth * levelHeight * priv::getBitsPerPixel(settings.textureFormat) / 8, 0);
+                if (!priv::tileImage(&texels[0], &region[0], 0, 0, levelWidth, levelHeight, levelWidth * 4,
+                                     levelWidth, levelHeight, settings.textureFormat))
+                {
+                    err() << "Unsupported texture format for cooking" << std::endl;
+                    return false;
+                }
+
+                if (!writer.addLevel(texture, &texels[0], texels.size(), settings.compression))
+                    return false;
+
+                if (level + 1 < levelCount)
+                {
+                    halved.resize((levelWidth / 2) * (levelHeight / 2) * 4);
+                    priv::halveImage(&halved[0], &region[0], levelWidth, levelHeight);
+                    region.swap(halved);
+                }
+            }
+        }
+    }
+
+    output.push_back(CookedFile());
+    output.back().extension = "ctex";
+
+    return writer.save(output.back().data);
+}
+
+} // namespace cooker
+
+} // namespace cpp3ds
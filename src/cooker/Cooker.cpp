@@ -0,0 +1,431 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "Cooker.hpp"
+#include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Thread.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#ifdef _WIN32
+    #include <direct.h>
+#endif
+
+
+namespace
+{
+    // Bump when the output of a cook function changes, to invalidate the caches
+    const char* cookerVersion = "2";
+
+    // 64 bits FNV-1a, good enough to tell sources apart
+    cpp3ds::Uint64 hash(cpp3ds::Uint64 value, const void* data, std::size_t size)
+    {
+        const cpp3ds::Uint8* bytes = static_cast<const cpp3ds::Uint8*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ULL;
+        }
+
+        return value;
+    }
+
+    bool readFile(const std::string& filename, std::vector<cpp3ds::Uint8>& data)
+    {
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        if (!file)
+            return false;
+
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+
+        data.resize(static_cast<std::size_t>(size));
+        if (size > 0)
+            file.read(reinterpret_cast<char*>(&data[0]), size);
+
+        return !file.fail();
+    }
+
+    bool writeFile(const std::string& filename, const std::vector<cpp3ds::Uint8>& data)
+    {
+        // Written aside then renamed, so that no reader sees a partial file
+        std::string temporary = filename + ".tmp";
+        {
+            std::ofstream file(temporary.c_str(), std::ios::binary);
+            if (!file)
+                return false;
+
+            if (!data.empty())
+                file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+            if (!file)
+                return false;
+        }
+
+        std::remove(filename.c_str());
+        return std::rename(temporary.c_str(), filename.c_str()) == 0;
+    }
+
+    bool makeDirectory(const std::string& path)
+    {
+        std::size_t position = 0;
+        while (position != std::string::npos)
+        {
+            position = path.find('/', position + 1);
+            std::string directory = path.substr(0, position);
+            if (directory.empty())
+                continue;
+
+#ifdef _WIN32
+            int result = _mkdir(directory.c_str());
+#else
+            int result = mkdir(directory.c_str(), 0755);
+#endif
+            if ((result != 0) && (errno != EEXIST))
+                return false;
+        }
+
+        return true;
+    }
+
+    std::string getDirectory(const std::string& path)
+    {
+        std::size_t slash = path.rfind('/');
+        return (slash == std::string::npos) ? std::string() : path.substr(0, slash);
+    }
+
+    std::string getExtension(const std::string& path)
+    {
+        std::size_t dot = path.rfind('.');
+        if ((dot == std::string::npos) || (path.find('/', dot) != std::string::npos))
+            return std::string();
+
+        std::string extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+
+    // Cache entries hold all the files cooked from a source:
+    // a count, then the extension and the data of every file
+    void writeUint32(std::vector<cpp3ds::Uint8>& data, cpp3ds::Uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            data.push_back(static_cast<cpp3ds::Uint8>(value >> (i * 8)));
+    }
+
+    bool readUint32(const std::vector<cpp3ds::Uint8>& data, std::size_t& position, cpp3ds::Uint32& value)
+    {
+        if ((position > data.size()) || (data.size() - position < 4))
+            return false;
+
+        value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<cpp3ds::Uint32>(data[position++]) << (i * 8);
+
+        return true;
+    }
+
+    void packFiles(const std::vector<cpp3ds::cooker::CookedFile>& files, std::vector<cpp3ds::Uint8>& data)
+    {
+        writeUint32(data, static_cast<cpp3ds::Uint32>(files.size()));
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            writeUint32(data, static_cast<cpp3ds::Uint32>(files[i].extension.size()));
+            data.insert(data.end(), files[i].extension.begin(), files[i].extension.end());
+            writeUint32(data, static_cast<cpp3ds::Uint32>(files[i].data.size()));
+            data.insert(data.end(), files[i].data.begin(), files[i].data.end());
+        }
+    }
+
+    bool unpackFiles(const std::vector<cpp3ds::Uint8>& data, std::vector<cpp3ds::cooker::CookedFile>& files)
+    {
+        std::size_t position = 0;
+        cpp3ds::Uint32 count;
+        if (!readUint32(data, position, count))
+            return false;
+
+        files.resize(count);
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            cpp3ds::Uint32 size;
+            if (!readUint32(data, position, size) || (size > data.size() - position))
+                return false;
+            files[i].extension.assign(data.begin() + position, data.begin() + position + size);
+            position += size;
+
+            if (!readUint32(data, position, size) || (size > data.size() - position))
+                return false;
+            files[i].data.assign(data.begin() + position, data.begin() + position + size);
+            position += size;
+        }
+
+        return position == data.size();
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace cooker
+{
+////////////////////////////////////////////////////////////
+Settings::Settings() :
+textureFormat(Texture::RGBA8),
+mipmap       (false),
+tileSize     (1024),
+compression  (priv::ChunkLz4),
+sampleRate   (0),
+mono         (false)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+std::string Settings::describe(const std::string& kind) const
+{
+    std::ostringstream stream;
+    if (kind == "texture")
+    {
+        stream << "format=" << textureFormat << " mipmap=" << mipmap << " tile=" << tileSize
+               << " compression=" << compression;
+    }
+    else if (kind == "sound")
+    {
+        stream << "rate=" << sampleRate << " mono=" << mono;
+    }
+
+    return stream.str();
+}
+
+
+////////////////////////////////////////////////////////////
+Cooker::Cooker(const Settings& settings, const std::string& outputDir, const std::string& cacheDir) :
+m_settings   (settings),
+m_outputDir  (outputDir),
+m_cacheDir   (cacheDir),
+m_nextJob    (0),
+m_cachedCount(0),
+m_failed     (false)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool Cooker::add(const std::string& filename, const std::string& baseDir)
+{
+    std::string extension = getExtension(filename);
+
+    Job job;
+    job.filename = filename;
+    if (extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "bmp" ||
+        extension == "tga" || extension == "gif" || extension == "psd" || extension == "hdr")
+    {
+        job.cook = &cookTexture;
+        job.kind = "texture";
+    }
+    else if (extension == "wav" || extension == "ogg" || extension == "flac")
+    {
+        job.cook = &cookSound;
+        job.kind = "sound";
+    }
+    else
+    {
+        err() << "Unknown kind of asset \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    // Keep the path relative to the base directory, without the extension
+    std::string relative = filename;
+    if (!baseDir.empty())
+    {
+        std::string prefix = baseDir;
+        if (prefix[prefix.size() - 1] != '/')
+            prefix += '/';
+        if (relative.find(prefix) == 0)
+            relative = relative.substr(prefix.size());
+    }
+    else
+    {
+        std::size_t slash = relative.rfind('/');
+        if (slash != std::string::npos)
+            relative = relative.substr(slash + 1);
+    }
+
+    job.output = m_outputDir + "/" + relative.substr(0, relative.size() - extension.size() - 1);
+    m_jobs.push_back(job);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Cooker::run(unsigned int threadCount)
+{
+    m_nextJob     = 0;
+    m_cachedCount = 0;
+    m_failed      = false;
+
+    if (!m_cacheDir.empty() && !makeDirectory(m_cacheDir))
+    {
+        err() << "Failed to create the cache directory \"" << m_cacheDir << "\"" << std::endl;
+        return false;
+    }
+
+    // The calling thread works too
+    threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned int>(m_jobs.size())));
+    std::vector<Thread*> threads;
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        threads.push_back(new Thread(&Cooker::work, this));
+        threads.back()->launch();
+    }
+
+    work();
+
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->wait();
+        delete threads[i];
+    }
+
+    return !m_failed;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Cooker::getCachedCount() const
+{
+    return m_cachedCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void Cooker::work()
+{
+    for (;;)
+    {
+        std::size_t index;
+        {
+            Lock lock(m_mutex);
+            if (m_nextJob >= m_jobs.size())
+                return;
+            index = m_nextJob++;
+        }
+
+        if (!cook(m_jobs[index]))
+        {
+            Lock lock(m_mutex);
+            m_failed = true;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool Cooker::cook(const Job& job)
+{
+    std::vector<Uint8> source;
+    if (!readFile(job.filename, source))
+    {
+        Lock lock(m_mutex);
+        err() << "Failed to read asset \"" << job.filename << "\"" << std::endl;
+        return false;
+    }
+
+    // The cache is keyed by the contents of the source, not its path or date,
+    // so renamed or touched files and switching branches don't cook again
+    std::string settings = std::string(job.kind) + '\n' + cookerVersion + '\n' + m_settings.describe(job.kind);
+    Uint64 key = hash(14695981039346656037ULL, settings.c_str(), settings.size() + 1);
+    key = hash(key, source.empty() ? NULL : &source[0], source.size());
+
+    char name[17];
+    std::sprintf(name, "%016llx", static_cast<unsigned long long>(key));
+    std::string cacheFile = m_cacheDir.empty() ? std::string() : m_cacheDir + "/" + name;
+
+    std::vector<CookedFile> files;
+    std::vector<Uint8> entry;
+    bool cached = !cacheFile.empty() && readFile(cacheFile, entry) && unpackFiles(entry, files);
+
+    if (!cached)
+    {
+        files.clear();
+        if (!job.cook(source, m_settings, files))
+        {
+            Lock lock(m_mutex);
+            err() << "Failed to cook " << job.kind << " \"" << job.filename << "\"" << std::endl;
+            return false;
+        }
+
+        if (!cacheFile.empty())
+        {
+            entry.clear();
+            packFiles(files, entry);
+            if (!writeFile(cacheFile, entry))
+            {
+                Lock lock(m_mutex);
+                err() << "Failed to write cache entry \"" << cacheFile << "\"" << std::endl;
+            }
+        }
+    }
+
+    if (!makeDirectory(getDirectory(job.output)))
+    {
+        Lock lock(m_mutex);
+        err() << "Failed to create the directory of \"" << job.output << "\"" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        std::string filename = job.output + "." + files[i].extension;
+        if (!writeFile(filename, files[i].data))
+        {
+            Lock lock(m_mutex);
+            err() << "Failed to write \"" << filename << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    Lock lock(m_mutex);
+    if (cached)
+        m_cachedCount++;
+    std::cout << (cached ? "cached " : "cooked ") << job.filename << std::endl;
+
+    return true;
+}
+
+} // namespace cooker
+
+} // namespace cpp3ds
@@ -0,0 +1,229 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef CPP3DS_COOKER_HPP
+#define CPP3DS_COOKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Config.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
+#include <string>
+#include <vector>
+
+
+namespace cpp3ds
+{
+namespace cooker
+{
+////////////////////////////////////////////////////////////
+/// \brief Options controlling how assets are cooked
+///
+////////////////////////////////////////////////////////////
+struct Settings
+{
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    Settings();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Describe the settings that affect a kind of asset
+    ///
+    /// The description is part of the cache key, so that
+    /// changing an option cooks the assets it affects again.
+    ///
+    /// \param kind "texture" or "sound"
+    ///
+    /// \return Text describing the settings
+    ///
+    ////////////////////////////////////////////////////////////
+    std::string describe(const std::string& kind) const;
+
+    Texture::Format            textureFormat; ///< Format of the cooked textures
+    bool                       mipmap;        ///< Store the whole mipmap chain of the textures?
+    unsigned int               tileSize;      ///< Images larger than this are split into tiles (see BigTexture)
+    priv::ChunkCompression     compression;   ///< How the texture levels are stored
+    unsigned int               sampleRate;    ///< Sample rate of the cooked sounds, 0 to keep the source rate
+    bool                       mono;          ///< Mix the cooked sounds down to a single channel?
+};
+
+////////////////////////////////////////////////////////////
+/// \brief File produced by cooking an asset
+///
+////////////////////////////////////////////////////////////
+struct CookedFile
+{
+    std::string        extension; ///< Extension replacing the one of the source file
+    std::vector<Uint8> data;      ///< Contents of the file
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Cook an image to a texture container
+///
+/// The image is converted to the texture format, tiled the
+/// way the GPU reads it and stored in a ".ctex" container,
+/// with its mipmap chain if asked. Images larger than the
+/// tile size are split into several textures, placed at
+/// their position in the image, for BigTexture.
+///
+/// \param source   Contents of the image file
+/// \param settings Cooking options
+/// \param output   Receives the cooked files
+///
+/// \return True if the image could be cooked
+///
+////////////////////////////////////////////////////////////
+bool cookTexture(const std::vector<Uint8>& source, const Settings& settings, std::vector<CookedFile>& output);
+
+////////////////////////////////////////////////////////////
+/// \brief Cook a sound to 16 bits PCM
+///
+/// Any format InputSoundFile reads is decoded, optionally
+/// resampled and mixed down to mono, and stored as a ".wav"
+/// file that needs no decoding on the device.
+///
+/// \param source   Contents of the sound file
+/// \param settings Cooking options
+/// \param output   Receives the cooked files
+///
+/// \return True if the sound could be cooked
+///
+////////////////////////////////////////////////////////////
+bool cookSound(const std::vector<Uint8>& source, const Settings& settings, std::vector<CookedFile>& output);
+
+////////////////////////////////////////////////////////////
+/// \brief Cooks batches of asset files in parallel
+///
+////////////////////////////////////////////////////////////
+class Cooker : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param settings  Cooking options
+    /// \param outputDir Directory the cooked files are written to
+    /// \param cacheDir  Directory of the cache, empty to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    Cooker(const Settings& settings, const std::string& outputDir, const std::string& cacheDir);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an asset file to cook
+    ///
+    /// The kind of asset is found from the extension of the
+    /// file. The cooked files keep the path of the source
+    /// relative to \a baseDir, under the output directory.
+    ///
+    /// \param filename Path of the source file
+    /// \param baseDir  Directory the output path is relative to
+    ///
+    /// \return False if the kind of asset isn't known
+    ///
+    ////////////////////////////////////////////////////////////
+    bool add(const std::string& filename, const std::string& baseDir);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cook all the added files
+    ///
+    /// \param threadCount Number of files cooked at the same time
+    ///
+    /// \return True if every file could be cooked
+    ///
+    ////////////////////////////////////////////////////////////
+    bool run(unsigned int threadCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of files taken from the cache by the last run
+    ///
+    /// \return Number of cache hits
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getCachedCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function cooking a kind of asset
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef bool (*CookFunction)(const std::vector<Uint8>&, const Settings&, std::vector<CookedFile>&);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Asset file waiting to be cooked
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Job
+    {
+        std::string  filename; ///< Path of the source file
+        std::string  output;   ///< Output path, without extension
+        CookFunction cook;     ///< Function cooking the file
+        const char*  kind;     ///< Name of the kind of asset, part of the cache key
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cook the jobs of the queue until it is empty
+    ///
+    /// This is the entry point of the worker threads.
+    ///
+    ////////////////////////////////////////////////////////////
+    void work();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cook a single job
+    ///
+    /// \param job Job to cook
+    ///
+    /// \return True if the files could be cooked and written
+    ///
+    ////////////////////////////////////////////////////////////
+    bool cook(const Job& job);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Settings         m_settings;    ///< Cooking options
+    std::string      m_outputDir;   ///< Directory the cooked files are written to
+    std::string      m_cacheDir;    ///< Directory of the cache, empty if disabled
+    std::vector<Job> m_jobs;        ///< Files to cook
+    std::size_t      m_nextJob;     ///< Index of the next job to hand to a worker
+    unsigned int     m_cachedCount; ///< Number of jobs taken from the cache
+    bool             m_failed;      ///< Did any job fail?
+    Mutex            m_mutex;       ///< Protects the queue, counters and logging
+};
+
+} // namespace cooker
+
+} // namespace cpp3ds
+
+
+#endif // CPP3DS_COOKER_HPP
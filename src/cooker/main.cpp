@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include "Cooker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+
+namespace
+{
+    void showUsage()
+    {
+        std::cout <<
+            "usage: cpp3ds-cook [options] -o <output dir> file...\n"
+            "\n"
+            "Cooks images to .ctex texture containers and sounds to 16 bits PCM\n"
+            ".wav files.\n"
+            "\n"
+            "  -o, --output DIR      directory the cooked files are written to\n"
+            "  -d, --dir DIR         directory the output paths are relative to\n"
+            "  -c, --cache DIR       cache directory (default: <output>/.cache)\n"
+            "      --no-cache        always cook every file\n"
+            "  -j, --jobs N          number of files cooked at once (default: cores)\n"
+            "\n"
+            "  --format NAME         rgba8, rgb565, rgba5551, rgba4, la8, a8, etc1 or etc1a4\n"
+            "  --mipmap              store the whole mipmap chain\n"
+            "  --tile-size N         split larger images into tiles (default: 1024)\n"
+            "  --compression NAME    raw, lz11 or lz4 (default: lz4)\n"
+            "\n"
+            "  --sample-rate N       resample sounds to this rate\n"
+            "  --mono                mix sounds down to mono\n";
+    }
+
+    bool parseFormat(const std::string& name, cpp3ds::Texture::Format& format)
+    {
+        const char* names[] = {"rgba8", "rgb565", "rgba5551", "rgba4", "la8", "a8", "etc1", "etc1a4"};
+        const cpp3ds::Texture::Format formats[] = {cpp3ds::Texture::RGBA8, cpp3ds::Texture::RGB565, cpp3ds::Texture::RGBA5551,
+                                                   cpp3ds::Texture::RGBA4, cpp3ds::Texture::LA8, cpp3ds::Texture::A8,
+                                                   cpp3ds::Texture::ETC1, cpp3ds::Texture::ETC1A4};
+
+        for (std::size_t i = 0; i < sizeof(names) / sizeof(*names); ++i)
+        {
+            if (name == names[i])
+            {
+                format = formats[i];
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool parseCompression(const std::string& name, cpp3ds::priv::ChunkCompression& compression)
+    {
+        if (name == "raw")
+            compression = cpp3ds::priv::ChunkRaw;
+        else if (name == "lz11")
+            compression = cpp3ds::priv::ChunkLz11;
+        else if (name == "lz4")
+            compression = cpp3ds::priv::ChunkLz4;
+        else
+            return false;
+
+        return true;
+    }
+
+    bool parseNumber(const std::string& text, unsigned int& value)
+    {
+        char* end;
+        unsigned long number = std::strtoul(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0')
+            return false;
+
+        value = static_cast<unsigned int>(number);
+        return true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    cpp3ds::cooker::Settings settings;
+    std::string outputDir;
+    std::string baseDir;
+    std::string cacheDir;
+    bool useCache = true;
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        bool hasValue = (i + 1 < argc);
+        bool valid = true;
+
+        if (option == "-h" || option == "--help")
+        {
+            showUsage();
+            return 0;
+        }
+        else if ((option == "-o" || option == "--output") && hasValue)
+            outputDir = argv[++i];
+        else if ((option == "-d" || option == "--dir") && hasValue)
+            baseDir = argv[++i];
+        else if ((option == "-c" || option == "--cache") && hasValue)
+            cacheDir = argv[++i];
+        else if (option == "--no-cache")
+            useCache = false;
+        else if ((option == "-j" || option == "--jobs") && hasValue)
+            valid = parseNumber(argv[++i], threadCount) && threadCount > 0;
+        else if (option == "--format" && hasValue)
+            valid = parseFormat(argv[++i], settings.textureFormat);
+        else if (option == "--mipmap")
+            settings.mipmap = true;
+        else if (option == "--tile-size" && hasValue)
+            valid = parseNumber(argv[++i], settings.tileSize) && settings.tileSize > 0;
+        else if (option == "--compression" && hasValue)
+            valid = parseCompression(argv[++i], settings.compression);
+        else if (option == "--sample-rate" && hasValue)
+            valid = parseNumber(argv[++i], settings.sampleRate);
+        else if (option == "--mono")
+            settings.mono = true;
+        else if (!option.empty() && option[0] == '-')
+            valid = false;
+        else
+            files.push_back(option);
+
+        if (!valid)
+        {
+            std::cerr << "Invalid option or value: " << option << std::endl;
+            showUsage();
+            return 2;
+        }
+    }
+
+    if (outputDir.empty() || files.empty())
+    {
+        showUsage();
+        return 2;
+    }
+
+    if (useCache && cacheDir.empty())
+        cacheDir = outputDir + "/.cache";
+    if (!useCache)
+        cacheDir.clear();
+
+    cpp3ds::cooker::Cooker cooker(settings, outputDir, cacheDir);
+    bool success = true;
+    for (std::size_t i = 0; i < files.size(); ++i)
+        success = cooker.add(files[i], baseDir) && success;
+
+    success = cooker.run(threadCount) && success;
+
+    std::cout << files.size() << " files, " << cooker.getCachedCount() << " from the cache" << std::endl;
+
+    return success ? 0 : 1;
+}
@@ -35,6 +35,7 @@
 #include <cpp3ds/Resources.hpp>
 #include <3ds.h>
 #include <memory>
+#include <utility>
 #include <string.h>
 
 
@@ -58,6 +59,23 @@ m_sounds  () // don't copy the attached sounds
 }
 
 
+////////////////////////////////////////////////////////////
+SoundBuffer::SoundBuffer(SoundBuffer&& other) noexcept :
+m_duration    (other.m_duration),
+m_sounds      (),
+m_sampleRate  (other.m_sampleRate),
+m_channelCount(other.m_channelCount),
+m_samples     (std::move(other.m_samples))
+{
+    // The wave buffers of the playing sounds keep pointing at the
+    // same linear memory, only their owner changes
+    takeSounds(other);
+
+    other.m_samples.clear();
+    other.m_duration = Time::Zero;
+}
+
+
 ////////////////////////////////////////////////////////////
 SoundBuffer::~SoundBuffer()
 {
@@ -202,6 +220,31 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 }
 
 
+////////////////////////////////////////////////////////////
+SoundBuffer& SoundBuffer::operator =(SoundBuffer&& right) noexcept
+{
+    if (this != &right)
+    {
+        // Stop and detach the sounds that play the samples being released
+        SoundList sounds;
+        sounds.swap(m_sounds);
+        for (SoundList::const_iterator it = sounds.begin(); it != sounds.end(); ++it)
+            (*it)->resetBuffer();
+
+        m_samples      = std::move(right.m_samples);
+        m_duration     = right.m_duration;
+        m_sampleRate   = right.m_sampleRate;
+        m_channelCount = right.m_channelCount;
+        takeSounds(right);
+
+        right.m_samples.clear();
+        right.m_duration = Time::Zero;
+    }
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::initialize(InputSoundFile& file)
 {
@@ -271,4 +314,14 @@ void SoundBuffer::detachSound(Sound* sound) const
     m_sounds.erase(sound);
 }
 
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::takeSounds(SoundBuffer& other)
+{
+    // Our own list is empty at this point, swapping it allocates nothing
+    m_sounds.swap(other.m_sounds);
+    for (SoundList::const_iterator it = m_sounds.begin(); it != m_sounds.end(); ++it)
+        (*it)->m_buffer = this;
+}
+
 } // namespace cpp3ds
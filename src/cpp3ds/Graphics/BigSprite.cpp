@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/BigSprite.hpp>
+#include <cpp3ds/Graphics/BigTexture.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/Vertex.hpp>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+BigSprite::BigSprite() :
+m_texture(NULL),
+m_color  (Color::White)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+BigSprite::BigSprite(BigTexture& texture) :
+m_texture(&texture),
+m_color  (Color::White)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::setTexture(BigTexture& texture)
+{
+    m_texture = &texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::setColor(const Color& color)
+{
+    m_color = color;
+}
+
+
+////////////////////////////////////////////////////////////
+BigTexture* BigSprite::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Color& BigSprite::getColor() const
+{
+    return m_color;
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect BigSprite::getLocalBounds() const
+{
+    if (!m_texture)
+        return FloatRect();
+
+    Vector2u size = m_texture->getSize();
+    return FloatRect(0.f, 0.f, static_cast<float>(size.x), static_cast<float>(size.y));
+}
+
+
+////////////////////////////////////////////////////////////
+FloatRect BigSprite::getGlobalBounds() const
+{
+    return getTransform().transformRect(getLocalBounds());
+}
+
+
+////////////////////////////////////////////////////////////
+void BigSprite::draw(RenderTarget& target, RenderStates states) const
+{
+    if (!m_texture)
+        return;
+
+    states.transform *= getTransform();
+
+    // Bounding rectangle of the view, in world coordinates
+    const View& view = target.getView();
+    FloatRect viewArea(view.getCenter() - view.getSize() / 2.f, view.getSize());
+    if (view.getRotation() != 0.f)
+        viewArea = Transform().rotate(view.getRotation(), view.getCenter()).transformRect(viewArea);
+
+    // The same area in pixels of the texture
+    m_texture->setVisibleArea(states.transform.getInverse().transformRect(viewArea));
+
+    for (std::size_t i = 0; i < m_texture->getTileCount(); ++i)
+    {
+        const Texture* tile = m_texture->getTile(i);
+        if (!tile)
+            continue;
+
+        FloatRect rect(m_texture->getTileRect(i));
+        Vertex vertices[4] =
+        {
+            Vertex(Vector2f(rect.left, rect.top), m_color, Vector2f(0.f, 0.f)),
+            Vertex(Vector2f(rect.left, rect.top + rect.height), m_color, Vector2f(0.f, rect.height)),
+            Vertex(Vector2f(rect.left + rect.width, rect.top), m_color, Vector2f(rect.width, 0.f)),
+            Vertex(Vector2f(rect.left + rect.width, rect.top + rect.height), m_color, Vector2f(rect.width, rect.height))
+        };
+
+        states.texture = tile;
+        target.draw(vertices, 4, TrianglesStrip, states);
+    }
+}
+
+} // namespace cpp3ds
@@ -0,0 +1,287 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/BigTexture.hpp>
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <utility>
+
+
+namespace
+{
+    // Formats other than JPEG are decoded whole for every tile, images
+    // larger than this wouldn't leave enough memory on the 3DS
+    const cpp3ds::Uint64 maxWholeDecodeSize = 16 * 1024 * 1024;
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+BigTexture::BigTexture() :
+m_format        (Texture::RGBA8),
+m_size          (0, 0),
+m_margin        (256),
+m_isSmooth      (false),
+m_isPreprocessed(false)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+BigTexture::~BigTexture()
+{
+    release();
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::loadFromFile(const std::string& filename, Texture::Format format, unsigned int tileSize)
+{
+    tileSize = std::min(tileSize, Texture::getMaximumSize());
+    if (tileSize == 0)
+    {
+        err() << "Failed to load big texture \"" << filename << "\", invalid tile size" << std::endl;
+        return false;
+    }
+
+    // Only the header is read, the tiles are loaded when they are shown
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageSizeFromFile(filename, size))
+        return false;
+
+    if (!priv::ImageLoader::getInstance().canLoadRegions(filename) &&
+        (static_cast<Uint64>(size.x) * size.y * 4 > maxWholeDecodeSize))
+    {
+        err() << "Failed to load big texture \"" << filename << "\", each tile would decode the whole image, "
+              << "use a JPEG file or a preprocessed texture container" << std::endl;
+        return false;
+    }
+
+    release();
+    m_tiles.clear();
+
+    for (unsigned int y = 0; y < size.y; y += tileSize)
+    {
+        for (unsigned int x = 0; x < size.x; x += tileSize)
+        {
+            Tile tile;
+            tile.area    = IntRect(x, y, std::min(tileSize, size.x - x), std::min(tileSize, size.y - y));
+            tile.texture = NULL;
+            m_tiles.push_back(tile);
+        }
+    }
+
+    m_filename       = filename;
+    m_format         = format;
+    m_size           = size;
+    m_isPreprocessed = false;
+
+    return true;
+}
+
+
+#ifndef EMULATION
+////////////////////////////////////////////////////////////
+bool BigTexture::loadFromPreprocessedFile(const std::string& filename)
+{
+    // Only the tables are read, the tiles are loaded when they are shown
+    priv::TextureContainer container;
+    if (!container.openFromFile(filename))
+        return false;
+
+    release();
+    m_tiles.clear();
+
+    Vector2u size(0, 0);
+    for (unsigned int i = 0; i < container.getTextureCount(); ++i)
+    {
+        const priv::ContainerTexture& info = container.getTexture(i);
+
+        Tile tile;
+        tile.area    = IntRect(info.left, info.top, info.originalWidth, info.originalHeight);
+        tile.texture = NULL;
+        m_tiles.push_back(tile);
+
+        size.x = std::max(size.x, static_cast<unsigned int>(info.left + info.originalWidth));
+        size.y = std::max(size.y, static_cast<unsigned int>(info.top + info.originalHeight));
+    }
+
+    m_filename       = filename;
+    m_size           = size;
+    m_isPreprocessed = true;
+
+    return true;
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+Vector2u BigTexture::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::setMargin(unsigned int margin)
+{
+    m_margin = margin;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int BigTexture::getMargin() const
+{
+    return m_margin;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::setSmooth(bool smooth)
+{
+    m_isSmooth = smooth;
+
+    for (std::vector<Tile>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        if (it->texture)
+            it->texture->setSmooth(smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+bool BigTexture::isSmooth() const
+{
+    return m_isSmooth;
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::setVisibleArea(const FloatRect& area)
+{
+    // Tiles are loaded within the margin, and released beyond twice the margin.
+    // Tiles drawn in this frame or the previous one are kept: the GPU may still
+    // read them, and a big texture shown through several views (both screens,
+    // a minimap) would otherwise drop and reload its tiles every frame.
+    float margin = static_cast<float>(m_margin);
+    FloatRect loaded(area.left - margin, area.top - margin, area.width + margin * 2.f, area.height + margin * 2.f);
+    FloatRect kept(area.left - margin * 2.f, area.top - margin * 2.f, area.width + margin * 4.f, area.height + margin * 4.f);
+    Vector2f center(area.left + area.width / 2.f, area.top + area.height / 2.f);
+
+    std::vector<std::pair<float, std::size_t> > missing;
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        Tile& tile = m_tiles[i];
+        FloatRect rect(tile.area);
+
+        if (tile.texture && !rect.intersects(kept) && (TextureCache::getAge(*tile.texture) > 1))
+        {
+            // Deleting the texture also cancels its load if it is still queued
+            delete tile.texture;
+            tile.texture = NULL;
+        }
+        else if (!tile.texture && rect.intersects(loaded))
+        {
+            float dx = rect.left + rect.width / 2.f - center.x;
+            float dy = rect.top + rect.height / 2.f - center.y;
+            missing.push_back(std::make_pair(dx * dx + dy * dy, i));
+        }
+    }
+
+    // The loader works in order, so the tiles closest to the center come first
+    std::sort(missing.begin(), missing.end());
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+        Tile& tile = m_tiles[missing[i].second];
+
+        Texture* texture = new Texture;
+#ifndef EMULATION
+        bool queued = m_isPreprocessed ? texture->loadFromPreprocessedFileAsync(m_filename, missing[i].second)
+                                       : texture->loadFromFileAsync(m_filename, tile.area, m_format);
+#else
+        bool queued = texture->loadFromFileAsync(m_filename, tile.area, m_format);
+#endif
+        if (!queued)
+        {
+            delete texture;
+            continue;
+        }
+
+        texture->setSmooth(m_isSmooth);
+        tile.texture = texture;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void BigTexture::release()
+{
+    for (std::vector<Tile>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+    {
+        delete it->texture;
+        it->texture = NULL;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t BigTexture::getTileCount() const
+{
+    return m_tiles.size();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t BigTexture::getResidentCount() const
+{
+    std::size_t count = 0;
+    for (std::vector<Tile>::const_iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        if (it->texture)
+            count++;
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+const IntRect& BigTexture::getTileRect(std::size_t index) const
+{
+    return m_tiles[index].area;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* BigTexture::getTile(std::size_t index) const
+{
+    return m_tiles[index].texture;
+}
+
+} // namespace cpp3ds
@@ -1,4 +1,5 @@
 #include "CitroHelpers.hpp"
+#include <algorithm>
 
 namespace
 {
@@ -62,3 +63,45 @@ C3D_MtxStack* CitroGetTextureMatrix()
 {
 	return &textureMatrix;
 }
+
+void CitroSetDistanceFieldEnv(float threshold, float sharpness)
+{
+	// Stage 0 (set by Texture::bind) gives the vertex color, the following
+	// stages compute clamp((distance - threshold) * sharpness + 0.5) from
+	// the texture alpha, then apply the vertex alpha. The combiners only
+	// multiply by up to 1, the three 4x output scales reach a sharpness of 64.
+	sharpness = std::min(sharpness, 64.f);
+	float start = std::max(threshold - 0.5f / sharpness, 0.f);
+	float factor = sharpness / 64.f;
+
+	C3D_TexEnv* env = C3D_GetTexEnv(1);
+	C3D_TexEnvInit(env);
+	C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_CONSTANT, 0);
+	C3D_TexEnvFunc(env, C3D_Alpha, GPU_SUBTRACT);
+	C3D_TexEnvColor(env, static_cast<u32>(start * 255.f + 0.5f) << 24);
+
+	env = C3D_GetTexEnv(2);
+	C3D_TexEnvInit(env);
+	C3D_TexEnvSrc(env, C3D_Alpha, GPU_PREVIOUS, GPU_CONSTANT, 0);
+	C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
+	C3D_TexEnvColor(env, std::max(static_cast<u32>(factor * 255.f + 0.5f), 1u) << 24);
+	C3D_TexEnvScale(env, C3D_Alpha, GPU_TEVSCALE_4);
+
+	for (int i = 3; i <= 4; ++i)
+	{
+		env = C3D_GetTexEnv(i);
+		C3D_TexEnvInit(env);
+		C3D_TexEnvScale(env, C3D_Alpha, GPU_TEVSCALE_4);
+	}
+
+	env = C3D_GetTexEnv(5);
+	C3D_TexEnvInit(env);
+	C3D_TexEnvSrc(env, C3D_Alpha, GPU_PREVIOUS, GPU_PRIMARY_COLOR, 0);
+	C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
+}
+
+void CitroResetDistanceFieldEnv()
+{
+	for (int i = 1; i <= 5; ++i)
+		C3D_TexEnvInit(C3D_GetTexEnv(i));
+}
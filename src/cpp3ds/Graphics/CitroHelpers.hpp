@@ -8,3 +8,5 @@ void CitroUpdateMatrixStacks();
 C3D_MtxStack* CitroGetProjectionMatrix();
 C3D_MtxStack* CitroGetModelviewMatrix();
 C3D_MtxStack* CitroGetTextureMatrix();
+void CitroSetDistanceFieldEnv(float threshold, float sharpness);
+void CitroResetDistanceFieldEnv();
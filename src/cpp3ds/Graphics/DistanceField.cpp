@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/DistanceField.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+    // Offset to a neighbour pixel and its distance
+    struct Neighbour
+    {
+        int   dx;
+        int   dy;
+        float distance;
+    };
+
+    bool closer(const Neighbour& left, const Neighbour& right)
+    {
+        return left.distance < right.distance;
+    }
+
+    // Neighbours within spread pixels (plus half a pixel for the edge
+    // position), closest first. Built once per spread and thread.
+    const std::vector<Neighbour>& getNeighbours(int spread)
+    {
+        thread_local std::vector<Neighbour> neighbours;
+        thread_local int neighboursSpread = 0;
+
+        if (spread != neighboursSpread)
+        {
+            neighbours.clear();
+            float limit = spread + 0.5f;
+            for (int dy = -spread; dy <= spread; ++dy)
+            {
+                for (int dx = -spread; dx <= spread; ++dx)
+                {
+                    Neighbour neighbour;
+                    neighbour.dx = dx;
+                    neighbour.dy = dy;
+                    neighbour.distance = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+                    if ((neighbour.distance > 0.f) && (neighbour.distance < limit))
+                        neighbours.push_back(neighbour);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), closer);
+            neighboursSpread = spread;
+        }
+
+        return neighbours;
+    }
+
+    // Coverage of a pixel, pixels out of the coverage are empty
+    int coverageAt(const cpp3ds::Uint8* coverage, int width, int height, int x, int y)
+    {
+        if ((x < 0) || (y < 0) || (x >= width) || (y >= height))
+            return 0;
+
+        return coverage[x + y * width];
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+void computeDistanceField(const Uint8* coverage, int width, int height, int spread, Uint8* field)
+{
+    const std::vector<Neighbour>& neighbours = getNeighbours(spread);
+
+    int fieldWidth  = width  + 2 * spread;
+    int fieldHeight = height + 2 * spread;
+
+    for (int y = 0; y < fieldHeight; ++y)
+    {
+        for (int x = 0; x < fieldWidth; ++x)
+        {
+            int value = coverageAt(coverage, width, height, x - spread, y - spread);
+
+            float distance;
+            if ((value > 0) && (value < 255))
+            {
+                // Partially covered pixels are crossed by the edge, their coverage locates it
+                distance = (value - 127.5f) / 255.f;
+            }
+            else
+            {
+                // Otherwise the edge is found across the closest pixel not fully
+                // on this side, at the distance its own coverage gives. The edge
+                // is within half a pixel of that pixel, so the search stops once
+                // neighbours are too far to get any closer.
+                bool inside = (value == 255);
+                distance = static_cast<float>(spread);
+                for (std::vector<Neighbour>::const_iterator it = neighbours.begin(); it != neighbours.end(); ++it)
+                {
+                    if (it->distance - 0.5f >= distance)
+                        break;
+
+                    int other = coverageAt(coverage, width, height, x - spread + it->dx, y - spread + it->dy);
+                    if (other == value)
+                        continue;
+
+                    float across = (other - 127.5f) / 255.f;
+                    distance = std::min(distance, it->distance + (inside ? across : -across));
+                }
+
+                if (!inside)
+                    distance = -distance;
+            }
+
+            float level = 127.5f + distance * 127.5f / spread + 0.5f;
+            field[x + y * fieldWidth] = static_cast<Uint8>(std::min(std::max(level, 0.f), 255.f));
+        }
+    }
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -26,17 +26,22 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/DistanceField.hpp>
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/InputStream.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/NonCopyable.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
 #include FT_STROKER_H
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 #include <cpp3ds/System/FileSystem.hpp>
 
 
@@ -59,6 +64,54 @@ unsigned long read(FT_Stream rec, unsigned long offset, unsigned char* buffer, u
 void close(FT_Stream)
 {
 }
+
+// Combine outline thickness, boldness and code point into a single 64-bit key
+cpp3ds::Uint64 combine(float outlineThickness, bool bold, cpp3ds::Uint32 codePoint)
+{
+    cpp3ds::Uint32 thickness;
+    std::memcpy(&thickness, &outlineThickness, sizeof(thickness));
+
+    return (static_cast<cpp3ds::Uint64>(thickness) << 32)
+         | (static_cast<cpp3ds::Uint64>(bold ? 1 : 0) << 31)
+         |  static_cast<cpp3ds::Uint64>(codePoint);
+}
+
+// Combine a pair of code points and a character size into a single 64-bit key,
+// code points take up to 21 bits
+cpp3ds::Uint64 combineKerning(cpp3ds::Uint32 first, cpp3ds::Uint32 second, unsigned int characterSize)
+{
+    return (static_cast<cpp3ds::Uint64>(characterSize) << 42)
+         | (static_cast<cpp3ds::Uint64>(first & 0x1FFFFF) << 21)
+         |  static_cast<cpp3ds::Uint64>(second & 0x1FFFFF);
+}
+
+// Lock the mutex shared by the copies of a font, if it has one (an empty font
+// doesn't, there's no face to protect)
+class FontLock : cpp3ds::NonCopyable
+{
+public:
+    explicit FontLock(cpp3ds::Mutex* mutex) : m_mutex(mutex)
+    {
+        if (m_mutex)
+            m_mutex->lock();
+    }
+
+    ~FontLock()
+    {
+        if (m_mutex)
+            m_mutex->unlock();
+    }
+
+private:
+    cpp3ds::Mutex* m_mutex;
+};
+
+// Append the code points from first to last (included)
+void appendRange(std::basic_string<cpp3ds::Uint32>& characters, cpp3ds::Uint32 first, cpp3ds::Uint32 last)
+{
+    for (cpp3ds::Uint32 codePoint = first; codePoint <= last; ++codePoint)
+        characters.push_back(codePoint);
+}
 }
 
 
@@ -69,9 +122,14 @@ Font::Font() :
         m_library  (NULL),
         m_face     (NULL),
         m_streamRec(NULL),
+        m_stroker  (NULL),
         m_refCount (NULL),
-        m_info     ()
+        m_mutex    (NULL),
+        m_info     (),
+        m_distanceFieldSize(0),
+        m_asciiSize(0)
 {
+    std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
 }
 
 
@@ -80,11 +138,19 @@ Font::Font(const Font& copy) :
         m_library    (copy.m_library),
         m_face       (copy.m_face),
         m_streamRec  (copy.m_streamRec),
+        m_stroker    (copy.m_stroker),
         m_refCount   (copy.m_refCount),
+        m_mutex      (copy.m_mutex),
         m_info       (copy.m_info),
         m_pages      (copy.m_pages),
-        m_pixelBuffer(copy.m_pixelBuffer)
+        m_pixelBuffer(copy.m_pixelBuffer),
+        m_scaledGlyphs(copy.m_scaledGlyphs),
+        m_distanceFieldSize(copy.m_distanceFieldSize),
+        m_kerning    (copy.m_kerning),
+        m_asciiSize  (0)
 {
+    // The ASCII glyphs of the copy point into its own tables
+    std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
 
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
@@ -94,6 +160,39 @@ Font::Font(const Font& copy) :
 }
 
 
+////////////////////////////////////////////////////////////
+Font::Font(Font&& other) noexcept :
+        m_library    (other.m_library),
+        m_face       (other.m_face),
+        m_streamRec  (other.m_streamRec),
+        m_stroker    (other.m_stroker),
+        m_refCount   (other.m_refCount),
+        m_mutex      (other.m_mutex),
+        m_info       (std::move(other.m_info)),
+        m_pages      (std::move(other.m_pages)),
+        m_pixelBuffer(std::move(other.m_pixelBuffer)),
+        m_scaledGlyphs(std::move(other.m_scaledGlyphs)),
+        m_distanceFieldSize(other.m_distanceFieldSize),
+        m_kerning    (std::move(other.m_kerning)),
+        m_asciiSize  (0)
+{
+    std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
+
+    // The reference stays with us, the source must not release it
+    other.m_library   = NULL;
+    other.m_face      = NULL;
+    other.m_streamRec = NULL;
+    other.m_stroker   = NULL;
+    other.m_refCount  = NULL;
+    other.m_mutex     = NULL;
+    other.m_info      = Info();
+    other.m_pixelBuffer.clear();
+    other.m_distanceFieldSize = 0;
+    other.m_kerning.clear();
+    other.clearGlyphs();
+}
+
+
 ////////////////////////////////////////////////////////////
 Font::~Font()
 {
@@ -107,6 +206,7 @@ bool Font::loadFromFile(const std::string& filename)
     // Cleanup the previous resources
     cleanup();
     m_refCount = new int(1);
+    m_mutex    = new Mutex;
 
     // Initialize FreeType
     // Note: we initialize FreeType for every font instance in order to avoid having a single
@@ -160,6 +260,7 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
     // Cleanup the previous resources
     cleanup();
     m_refCount = new int(1);
+    m_mutex    = new Mutex;
 
     // Initialize FreeType
     // Note: we initialize FreeType for every font instance in order to avoid having a single
@@ -213,6 +314,7 @@ bool Font::loadFromStream(InputStream& stream)
     // Cleanup the previous resources
     cleanup();
     m_refCount = new int(1);
+    m_mutex    = new Mutex;
 
     // Initialize FreeType
     // Note: we initialize FreeType for every font instance in order to avoid having a single
@@ -292,67 +394,152 @@ const Font::Info& Font::getInfo() const
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
+    FontLock lock(m_mutex);
 
-    // Build the key by combining the code point, bold flag, and outline thickness
-    Uint64 key = (static_cast<Uint64>(*reinterpret_cast<Uint32*>(&outlineThickness)) << 32)
-                 | (static_cast<Uint64>(bold ? 1 : 0) << 31)
-                 |  static_cast<Uint64>(codePoint);
+    // Distance field glyphs are the same for all the outline thicknesses
+    if (m_distanceFieldSize)
+        outlineThickness = 0;
 
-    // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
+    // Filled ASCII glyphs of the last size used are indexed directly
+    bool ascii = (codePoint < 128) && (outlineThickness == 0);
+    if (ascii)
     {
-        // Found: just return it
-        return it->second;
+        if (characterSize != m_asciiSize)
+        {
+            m_asciiSize = characterSize;
+            std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
+        }
+
+        if (const Glyph* glyph = m_asciiGlyphs[bold][codePoint])
+            return *glyph;
     }
-    else
+
+    // Glyphs don't move in their table, the pointer stays valid until it's cleared
+    const Glyph& glyph = findGlyph(codePoint, characterSize, bold, outlineThickness);
+    if (ascii)
+        m_asciiGlyphs[bold][codePoint] = &glyph;
+
+    return glyph;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t Font::preloadGlyphs(const String& characters, unsigned int characterSize, bool bold, float outlineThickness) const
+{
+    FontLock lock(m_mutex);
+
+    if (!m_face)
+        return 0;
+
+    // Distance field glyphs only need to be loaded at the reference size
+    if (m_distanceFieldSize)
+    {
+        characterSize    = m_distanceFieldSize;
+        outlineThickness = 0;
+    }
+
+    Page& page = m_pages[characterSize];
+
+    // Rows from here on are empty, their pixels don't need to be read back
+    if (page.pending.empty())
+        page.pendingRow = page.nextRow;
+
+    // Rasterize and pack all the missing glyphs, keeping their pixels aside
+    // until the drawing thread calls getTexture
+    std::size_t count = 0;
+    for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
     {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold, outlineThickness);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
+        Uint64 key = combine(outlineThickness, bold, *it);
+        if (page.glyphs.find(key))
+            continue;
+
+        page.glyphs.insert(key, loadGlyph(*it, characterSize, bold, outlineThickness, true));
+        ++count;
     }
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+String Font::getAsciiCharacters()
+{
+    std::basic_string<Uint32> characters;
+    appendRange(characters, 0x20, 0x7E);
+
+    return characters;
+}
+
+
+////////////////////////////////////////////////////////////
+String Font::getLatin1Characters()
+{
+    std::basic_string<Uint32> characters;
+    appendRange(characters, 0x20, 0x7E);
+    appendRange(characters, 0xA0, 0xFF);
+
+    return characters;
+}
+
+
+////////////////////////////////////////////////////////////
+String Font::getKanaCharacters()
+{
+    std::basic_string<Uint32> characters;
+    appendRange(characters, 0x3000, 0x303F); // CJK symbols and punctuation
+    appendRange(characters, 0x3041, 0x3096); // Hiragana
+    appendRange(characters, 0x3099, 0x30FF); // Kana marks and katakana
+    appendRange(characters, 0xFF01, 0xFF9F); // Fullwidth ASCII and halfwidth katakana
+
+    return characters;
 }
 
 
 ////////////////////////////////////////////////////////////
 float Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) const
 {
+    FontLock lock(m_mutex);
+
     // Special case where first or second is 0 (null character)
     if (first == 0 || second == 0)
         return 0.f;
 
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
-    {
-        // Convert the characters to indices
-        FT_UInt index1 = FT_Get_Char_Index(face, first);
-        FT_UInt index2 = FT_Get_Char_Index(face, second);
+    // Invalid font, or no kerning
+    if (!face || !FT_HAS_KERNING(face))
+        return 0.f;
 
-        // Get the kerning vector
-        FT_Vector kerning;
-        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
+    // Each pair is only looked up once per size
+    Uint64 key = combineKerning(first, second, characterSize);
+    if (const float* kerning = m_kerning.find(key))
+        return *kerning;
 
-        // X advance is already in pixels for bitmap fonts
-        if (!FT_IS_SCALABLE(face))
-            return static_cast<float>(kerning.x);
-
-        // Return the X advance
-        return static_cast<float>(kerning.x) / static_cast<float>(1 << 6);
-    }
-    else
-    {
-        // Invalid font, or no kerning
+    if (!setCurrentSize(characterSize))
         return 0.f;
-    }
+
+    // Convert the characters to indices
+    FT_UInt index1 = FT_Get_Char_Index(face, first);
+    FT_UInt index2 = FT_Get_Char_Index(face, second);
+
+    // Get the kerning vector
+    FT_Vector kerning;
+    FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
+
+    // X advance is already in pixels for bitmap fonts
+    float advance = static_cast<float>(kerning.x);
+    if (FT_IS_SCALABLE(face))
+        advance /= static_cast<float>(1 << 6);
+
+    return m_kerning.insert(key, advance);
 }
 
 
 ////////////////////////////////////////////////////////////
 float Font::getLineSpacing(unsigned int characterSize) const
 {
+    FontLock lock(m_mutex);
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -369,6 +556,8 @@ float Font::getLineSpacing(unsigned int characterSize) const
 ////////////////////////////////////////////////////////////
 float Font::getUnderlinePosition(unsigned int characterSize) const
 {
+    FontLock lock(m_mutex);
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -389,6 +578,8 @@ float Font::getUnderlinePosition(unsigned int characterSize) const
 ////////////////////////////////////////////////////////////
 float Font::getUnderlineThickness(unsigned int characterSize) const
 {
+    FontLock lock(m_mutex);
+
     FT_Face face = static_cast<FT_Face>(m_face);
 
     if (face && setCurrentSize(characterSize))
@@ -409,7 +600,57 @@ float Font::getUnderlineThickness(unsigned int characterSize) const
 ////////////////////////////////////////////////////////////
 const Texture& Font::getTexture(unsigned int characterSize) const
 {
-    return m_pages[characterSize].texture;
+    FontLock lock(m_mutex);
+
+    // All the sizes are drawn from the distance field page
+    if (m_distanceFieldSize)
+        characterSize = m_distanceFieldSize;
+
+    // Write the glyphs that were preloaded since the last call
+    Page& page = m_pages[characterSize];
+    updatePage(page);
+
+    return page.texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setDistanceField(bool enabled, unsigned int referenceSize)
+{
+    FontLock lock(m_mutex);
+
+    unsigned int size = enabled ? referenceSize : 0;
+    if (size == m_distanceFieldSize)
+        return;
+
+    // The loaded glyphs don't match the new mode anymore
+    m_distanceFieldSize = size;
+    clearGlyphs();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::isDistanceField() const
+{
+    return m_distanceFieldSize != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getDistanceFieldSize() const
+{
+    return m_distanceFieldSize;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int Font::getDistanceFieldSpread() const
+{
+    if (!m_distanceFieldSize)
+        return 0;
+
+    // Enough for outlines of about an eighth of the character size
+    return std::max(m_distanceFieldSize / 8, 2u);
 }
 
 
@@ -421,10 +662,56 @@ Font& Font::operator =(const Font& right)
     std::swap(m_library,     temp.m_library);
     std::swap(m_face,        temp.m_face);
     std::swap(m_streamRec,   temp.m_streamRec);
+    std::swap(m_stroker,     temp.m_stroker);
     std::swap(m_refCount,    temp.m_refCount);
+    std::swap(m_mutex,       temp.m_mutex);
     std::swap(m_info,        temp.m_info);
     std::swap(m_pages,       temp.m_pages);
     std::swap(m_pixelBuffer, temp.m_pixelBuffer);
+    std::swap(m_scaledGlyphs, temp.m_scaledGlyphs);
+    std::swap(m_distanceFieldSize, temp.m_distanceFieldSize);
+    std::swap(m_kerning,     temp.m_kerning);
+
+    // The ASCII glyphs pointed into the old tables
+    std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+Font& Font::operator =(Font&& right) noexcept
+{
+    if (this != &right)
+    {
+        // Release our own reference first
+        cleanup();
+
+        m_library     = right.m_library;
+        m_face        = right.m_face;
+        m_streamRec   = right.m_streamRec;
+        m_stroker     = right.m_stroker;
+        m_refCount    = right.m_refCount;
+        m_mutex       = right.m_mutex;
+        m_info        = std::move(right.m_info);
+        m_pages       = std::move(right.m_pages);
+        m_pixelBuffer = std::move(right.m_pixelBuffer);
+        m_scaledGlyphs = std::move(right.m_scaledGlyphs);
+        m_distanceFieldSize = right.m_distanceFieldSize;
+        m_kerning     = std::move(right.m_kerning);
+
+        right.m_library   = NULL;
+        right.m_face      = NULL;
+        right.m_streamRec = NULL;
+        right.m_stroker   = NULL;
+        right.m_refCount  = NULL;
+        right.m_mutex     = NULL;
+        right.m_info      = Info();
+        right.m_pixelBuffer.clear();
+        right.m_distanceFieldSize = 0;
+        right.m_kerning.clear();
+        right.clearGlyphs();
+    }
 
     return *this;
 }
@@ -442,8 +729,9 @@ void Font::cleanup()
         // Free the resources only if we are the last owner
         if (*m_refCount == 0)
         {
-            // Delete the reference counter
+            // Delete the reference counter and the mutex shared with it
             delete m_refCount;
+            delete m_mutex;
 
             // Destroy the stroker
             if (m_stroker)
@@ -469,13 +757,64 @@ void Font::cleanup()
     m_stroker   = NULL;
     m_streamRec = NULL;
     m_refCount  = NULL;
-    m_pages.clear();
+    m_mutex     = NULL;
     m_pixelBuffer.clear();
+    m_kerning.clear();
+    clearGlyphs();
 }
 
 
 ////////////////////////////////////////////////////////////
-Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
+void Font::clearGlyphs() const
+{
+    m_pages.clear();
+    m_scaledGlyphs.clear();
+    std::memset(m_asciiGlyphs, 0, sizeof(m_asciiGlyphs));
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph& Font::findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness) const
+{
+    // Build the key by combining the code point, bold flag, and outline thickness
+    Uint64 key = combine(outlineThickness, bold, codePoint);
+
+    // Distance field glyphs are loaded once, then scaled to each size
+    if (m_distanceFieldSize)
+    {
+        GlyphTable& scaled = m_scaledGlyphs[characterSize];
+        if (const Glyph* glyph = scaled.find(key))
+            return *glyph;
+
+        // The texture rectangle stays the one of the reference glyph
+        GlyphTable& glyphs = m_pages[m_distanceFieldSize].glyphs;
+        const Glyph* source = glyphs.find(key);
+        Glyph glyph = source ? *source : glyphs.insert(key, loadGlyph(codePoint, m_distanceFieldSize, bold, 0));
+
+        float scale = static_cast<float>(characterSize) / m_distanceFieldSize;
+        glyph.advance       *= scale;
+        glyph.bounds.left   *= scale;
+        glyph.bounds.top    *= scale;
+        glyph.bounds.width  *= scale;
+        glyph.bounds.height *= scale;
+
+        return scaled.insert(key, glyph);
+    }
+
+    // Get the page corresponding to the character size
+    GlyphTable& glyphs = m_pages[characterSize].glyphs;
+
+    // Search the glyph into the cache
+    if (const Glyph* glyph = glyphs.find(key))
+        return *glyph;
+
+    // Not found: we have to load it
+    return glyphs.insert(key, loadGlyph(codePoint, characterSize, bold, outlineThickness));
+}
+
+
+////////////////////////////////////////////////////////////
+Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, float outlineThickness, bool deferred) const
 {
     // The glyph to return
     Glyph glyph;
@@ -546,14 +885,16 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, f
     if ((width > 0) && (height > 0))
     {
         // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbors
-        const unsigned int padding = 1;
+        // pollute them with pixels from neighbors. A distance field spreads
+        // over a wider padding.
+        const unsigned int padding = m_distanceFieldSize ? getDistanceFieldSpread() : 1;
 
         // Get the glyphs page corresponding to the character size
         Page& page = m_pages[characterSize];
 
         // Find a good position for the new glyph into the texture
-        glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
+        IntRect paddedRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
+        glyph.textureRect = paddedRect;
 
         // Make sure the texture data is positioned in the center
         // of the allocated texture rectangle
@@ -568,8 +909,11 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, f
         glyph.bounds.width  =  static_cast<float>(face->glyph->metrics.width)        / static_cast<float>(1 << 6) + outlineThickness * 2;
         glyph.bounds.height =  static_cast<float>(face->glyph->metrics.height)       / static_cast<float>(1 << 6) + outlineThickness * 2;
 
-        // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
+        // Extract the glyph's coverage from the bitmap, after the
+        // pending ones if the texture is written later
+        std::vector<Uint8>& buffer = deferred ? page.pendingPixels : m_pixelBuffer;
+        std::size_t offset = deferred ? buffer.size() : 0;
+        buffer.resize(offset + width * height);
         const Uint8* pixels = bitmap.buffer;
         if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
         {
@@ -578,9 +922,8 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, f
             {
                 for (int x = 0; x < width; ++x)
                 {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
+                    std::size_t index = offset + x + y * width;
+                    buffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
                 }
                 pixels += bitmap.pitch;
             }
@@ -592,30 +935,48 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, f
             {
                 for (int x = 0; x < width; ++x)
                 {
-                    // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
-                    m_pixelBuffer[index] = pixels[x];
+                    std::size_t index = offset + x + y * width;
+                    buffer[index] = pixels[x];
                 }
                 pixels += bitmap.pitch;
             }
         }
 
-        // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left;
-        unsigned int y = glyph.textureRect.top;
-        unsigned int w = glyph.textureRect.width;
-        unsigned int h = glyph.textureRect.height;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
-    }
+        // Replace the coverage by its distance field, which fills the padding
+        // too (unless no room was found for the glyph)
+        IntRect rect = glyph.textureRect;
+        if (m_distanceFieldSize && (paddedRect.width == static_cast<int>(width + 2 * padding)))
+        {
+            std::vector<Uint8> coverage(buffer.begin() + offset, buffer.end());
+            buffer.resize(offset + paddedRect.width * paddedRect.height);
+            priv::computeDistanceField(&coverage[0], width, height, padding, &buffer[offset]);
+            rect = paddedRect;
+        }
 
-    // Delete the FT glyph
-    FT_Done_Glyph(glyphDesc);
+        if (deferred)
+        {
+            // Leave the pixels in the page for writePendingGlyphs
+            PendingGlyph entry;
+            entry.rect   = rect;
+            entry.offset = offset;
+            page.pending.push_back(entry);
+        }
+        else
+        {
+            // Write the pixels to the texture, once it has the size of the page
+            updatePage(page);
+            page.texture.updateTexels(&m_pixelBuffer[0], rect.width, rect.height, rect.width, rect.left, rect.top);
 
-    // Force an OpenGL flush, so that the font's texture will appear updated
-    // in all contexts immediately (solves problems in multi-threaded apps)
+            // Force an OpenGL flush, so that the font's texture will appear updated
+            // in all contexts immediately (solves problems in multi-threaded apps)
 #ifdef EMULATION
-    glCheck(glFlush());
+            glCheck(glFlush());
 #endif
+        }
+    }
+
+    // Delete the FT glyph
+    FT_Done_Glyph(glyphDesc);
 
     // Done :)
     return glyph;
@@ -637,7 +998,7 @@ IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height)
             continue;
 
         // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
+        if (width > page.size.x - it->width)
             continue;
 
         // Make sure that this new row is the best found so far
@@ -653,25 +1014,18 @@ IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height)
     if (!row)
     {
         int rowHeight = height + height / 10;
-        while ((page.nextRow + rowHeight >= page.texture.getSize().y) || (width >= page.texture.getSize().x))
+        while ((page.nextRow + rowHeight >= page.size.y) || (width >= page.size.x))
         {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
-            {
-                // Make the texture 2 times bigger
-                Image newImage;
-                newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
-                newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
-            }
-            else
+            // Not enough space: resize the page if possible
+            if ((page.size.x * 2 > Texture::getMaximumSize()) || (page.size.y * 2 > Texture::getMaximumSize()))
             {
                 // Oops, we've reached the maximum texture size...
                 err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
                 return IntRect(0, 0, 2, 2);
             }
+
+            // Make the page 2 times bigger, the glyphs stay where they are
+            page.size *= 2u;
         }
 
         // We can now create the new row
@@ -690,6 +1044,120 @@ IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height)
 }
 
 
+////////////////////////////////////////////////////////////
+void Font::updatePage(Page& page) const
+{
+    if (page.texture.getSize() == Vector2u(0, 0))
+    {
+        // Make sure that the texture is initialized by default
+        cpp3ds::Image image;
+        image.create(page.size.x, page.size.y, Color(255, 255, 255, 0));
+
+        // Reserve a 2x2 white square for texturing underlines
+        for (int x = 0; x < 2; ++x)
+            for (int y = 0; y < 2; ++y)
+                image.setPixel(x, y, Color(255, 255, 255, 255));
+
+        // Create the texture, only the coverage is stored: the
+        // color comes from the vertices (see Texture::bind)
+        if (!page.texture.loadFromImage(image, IntRect(), Texture::A8))
+        {
+            err() << "Failed to create the texture of a font page" << std::endl;
+            page.pending.clear();
+            std::vector<Uint8>().swap(page.pendingPixels);
+            return;
+        }
+        page.texture.setSmooth(true);
+    }
+    else if (page.texture.getSize() != page.size)
+    {
+        // Make the texture as big as the page, the glyphs stay where they are
+        if (!page.texture.grow(page.size.x, page.size.y, Color(255, 255, 255, 0)))
+        {
+            err() << "Failed to add new characters to the font: the texture couldn't be resized" << std::endl;
+
+            // The glyphs that don't fit stay empty
+            page.size = page.texture.getSize();
+            std::vector<PendingGlyph>::iterator it = page.pending.begin();
+            while (it != page.pending.end())
+            {
+                if ((static_cast<unsigned int>(it->rect.left + it->rect.width) > page.size.x) ||
+                    (static_cast<unsigned int>(it->rect.top + it->rect.height) > page.size.y))
+                    it = page.pending.erase(it);
+                else
+                    ++it;
+            }
+        }
+    }
+
+    if (page.pending.empty())
+        return;
+
+    writePendingGlyphs(page);
+
+    // Don't keep the memory of a large batch around
+    page.pending.clear();
+    std::vector<Uint8>().swap(page.pendingPixels);
+
+#ifdef EMULATION
+    glCheck(glFlush());
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::writePendingGlyphs(Page& page) const
+{
+    const std::vector<PendingGlyph>& pending = page.pending;
+    const std::vector<Uint8>& pixels = page.pendingPixels;
+
+    // Find the area covering all the glyphs
+    int left   = pending[0].rect.left;
+    int top    = pending[0].rect.top;
+    int right  = left + pending[0].rect.width;
+    int bottom = top + pending[0].rect.height;
+    for (std::vector<PendingGlyph>::const_iterator it = pending.begin() + 1; it != pending.end(); ++it)
+    {
+        left   = std::min(left,   it->rect.left);
+        top    = std::min(top,    it->rect.top);
+        right  = std::max(right,  it->rect.left + it->rect.width);
+        bottom = std::max(bottom, it->rect.top + it->rect.height);
+    }
+    IntRect area(left, top, right - left, bottom - top);
+
+    // The area may cover glyphs that are already in the texture, keep them.
+    // If it only covers new rows, it's known to be transparent.
+    std::vector<Uint8> coverage(area.width * area.height, 0);
+    if (static_cast<unsigned int>(area.top) < page.pendingRow)
+    {
+        std::vector<Uint8> texels(coverage.size() * 4);
+        if (!page.texture.readPixels(area, &texels[0]))
+        {
+            // Fall back to one update per glyph
+            for (std::vector<PendingGlyph>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+                page.texture.updateTexels(&pixels[it->offset], it->rect.width, it->rect.height, it->rect.width, it->rect.left, it->rect.top);
+            return;
+        }
+
+        for (std::size_t i = 0; i < coverage.size(); ++i)
+            coverage[i] = texels[i * 4 + 3];
+    }
+
+    // Copy the glyphs into the area, then write it in one go
+    for (std::vector<PendingGlyph>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+        for (int y = 0; y < it->rect.height; ++y)
+        {
+            const Uint8* source = &pixels[it->offset + y * it->rect.width];
+            Uint8* destination = &coverage[(it->rect.top - area.top + y) * area.width + it->rect.left - area.left];
+            std::memcpy(destination, source, it->rect.width);
+        }
+    }
+
+    page.texture.updateTexels(&coverage[0], area.width, area.height, area.width, area.left, area.top);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Font::setCurrentSize(unsigned int characterSize) const
 {
@@ -728,20 +1196,11 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 ////////////////////////////////////////////////////////////
 Font::Page::Page() :
-        nextRow(3)
+        size      (128, 128),
+        nextRow   (3),
+        pendingRow(3)
 {
-    // Make sure that the texture is initialized by default
-    cpp3ds::Image image;
-    image.create(128, 128, Color(255, 255, 255, 0));
-
-    // Reserve a 2x2 white square for texturing underlines
-    for (int x = 0; x < 2; ++x)
-        for (int y = 0; y < 2; ++y)
-            image.setPixel(x, y, Color(255, 255, 255, 255));
-
-    // Create the texture
-    texture.loadFromImage(image);
-    texture.setSmooth(true);
+    // The texture is created by updatePage, on the thread that draws
 }
 
 } // namespace cpp3ds
\ No newline at end of file
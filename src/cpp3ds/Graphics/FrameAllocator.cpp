@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/FrameAllocator.hpp>
+#ifndef EMULATION
+#include <3ds.h>
+#else
+#include <cstdlib>
+#endif
+
+
+namespace
+{
+    // Number of frames the GPU has finished so far
+    cpp3ds::Uint32 frameCount = 0;
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+FrameAllocator::FrameAllocator(std::size_t capacity) :
+m_buffer       (NULL),
+m_capacity     (capacity),
+m_offset       (0),
+m_highWaterMark(0),
+m_frame        (frameCount)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+FrameAllocator::~FrameAllocator()
+{
+    setCapacity(0);
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameAllocator::setCapacity(std::size_t capacity)
+{
+    if (m_buffer)
+    {
+#ifdef EMULATION
+        std::free(m_buffer);
+#else
+        linearFree(m_buffer);
+#endif
+        m_buffer = NULL;
+    }
+
+    m_capacity = capacity;
+    m_offset = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FrameAllocator::getCapacity() const
+{
+    return m_capacity;
+}
+
+
+////////////////////////////////////////////////////////////
+void* FrameAllocator::allocate(std::size_t size, std::size_t alignment)
+{
+    // The GPU is done with the previous frame, recycle the whole buffer
+    if (m_frame != frameCount)
+    {
+        m_frame = frameCount;
+        reset();
+    }
+
+    if (!m_buffer && m_capacity > 0)
+    {
+#ifdef EMULATION
+        m_buffer = static_cast<Uint8*>(std::malloc(m_capacity));
+#else
+        m_buffer = static_cast<Uint8*>(linearAlloc(m_capacity));
+#endif
+        m_offset = 0;
+    }
+
+    std::size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+
+    // Failed requests still count, they tell how big the buffer should be
+    if (offset + size > m_highWaterMark)
+        m_highWaterMark = offset + size;
+
+    if (!m_buffer || offset + size > m_capacity)
+        return NULL;
+
+    m_offset = offset + size;
+    return m_buffer + offset;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameAllocator::reset()
+{
+    m_offset = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FrameAllocator::getSize() const
+{
+    return m_offset;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FrameAllocator::getHighWaterMark() const
+{
+    return m_highWaterMark;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameAllocator::resetHighWaterMark()
+{
+    m_highWaterMark = m_offset;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameAllocator::nextFrame()
+{
+    frameCount++;
+}
+
+} // namespace cpp3ds
@@ -30,6 +30,7 @@
 #include <cpp3ds/System/Err.hpp>
 #include <algorithm>
 #include <cstring>
+#include <utility>
 
 
 namespace cpp3ds
@@ -47,6 +48,50 @@ Image::~Image()
 }
 
 
+////////////////////////////////////////////////////////////
+Image::Image(const Image& copy) :
+m_size  (copy.m_size),
+m_pixels(copy.m_pixels)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Image::Image(Image&& other) noexcept :
+m_size  (other.m_size),
+m_pixels(std::move(other.m_pixels))
+{
+    other.m_size = Vector2u(0, 0);
+    other.m_pixels.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+Image& Image::operator =(const Image& right)
+{
+    m_size   = right.m_size;
+    m_pixels = right.m_pixels;
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+Image& Image::operator =(Image&& right) noexcept
+{
+    if (this != &right)
+    {
+        m_size   = right.m_size;
+        m_pixels = std::move(right.m_pixels);
+
+        right.m_size = Vector2u(0, 0);
+        right.m_pixels.clear();
+    }
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Image::create(unsigned int width, unsigned int height, const Color& color)
 {
@@ -111,6 +156,29 @@ bool Image::loadFromFile(const std::string& filename)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Image::loadFromFile(const std::string& filename, unsigned int maxSize)
+{
+    return loadFromFile(filename, IntRect(), maxSize);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Image::loadFromFile(const std::string& filename, const IntRect& area, unsigned int maxSize)
+{
+    // Decode aside, so that the image is left unchanged on failure
+    std::vector<Uint8> pixels;
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageFromFile(filename, area, maxSize, pixels, size))
+        return false;
+
+    m_pixels.swap(pixels);
+    m_size = size;
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Image::loadFromMemory(const void* data, std::size_t size)
 {
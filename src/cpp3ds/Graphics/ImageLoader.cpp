@@ -29,6 +29,103 @@
 #include <cpp3ds/Resources.hpp>
 #include <cpp3ds/System/InputStream.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace
+{
+    // Memory that stb_image decodes the pixels into, instead of
+    // a block of its own that would have to be copied afterwards
+    struct DecodeTarget
+    {
+        unsigned char* buffer;   // Memory to decode into, NULL if none
+        std::size_t    size;     // Size of the decoded pixels
+        std::size_t    capacity; // Size of the memory
+        bool           spare;    // Can the pixels' block be one byte larger than the memory?
+        bool           inUse;    // Was the memory handed to stb_image?
+    };
+
+    // stb_image's allocator has no user data, so each thread has its
+    // own target and decodes can run on several threads without locking
+    thread_local DecodeTarget   decodeTarget = {NULL, 0, 0, false, false};
+    thread_local cpp3ds::Uint64 decodeCopyCount = 0;
+
+    void* decodeMalloc(std::size_t size)
+    {
+        // The pixels are the first block of their size that is
+        // requested (the JPEG decoder asks for a spare byte)
+        std::size_t capacity = decodeTarget.capacity + (decodeTarget.spare ? 1 : 0);
+        if (decodeTarget.buffer && !decodeTarget.inUse && (size >= decodeTarget.size) && (size <= capacity))
+        {
+            decodeTarget.inUse = true;
+            return decodeTarget.buffer;
+        }
+
+        return std::malloc(size);
+    }
+
+    void decodeFree(void* pointer)
+    {
+        if (pointer && (pointer == decodeTarget.buffer))
+            decodeTarget.inUse = false;
+        else
+            std::free(pointer);
+    }
+
+    void* decodeRealloc(void* pointer, std::size_t size)
+    {
+        if (!pointer || (pointer != decodeTarget.buffer))
+            return std::realloc(pointer, size);
+
+        // A block that was wrongly given the target memory moves out of it
+        void* block = std::malloc(size);
+        if (block)
+        {
+            std::memcpy(block, pointer, std::min(size, decodeTarget.capacity));
+            decodeTarget.inUse = false;
+        }
+
+        return block;
+    }
+
+    // The JPEG decoder never writes its spare byte, so when decoding a JPEG
+    // file, memory without room for it can be given the pixels' block too
+    void beginDecode(unsigned char* buffer, std::size_t size, std::size_t capacity, bool spare = false)
+    {
+        decodeTarget.buffer   = buffer;
+        decodeTarget.size     = size;
+        decodeTarget.capacity = capacity;
+        decodeTarget.spare    = spare;
+        decodeTarget.inUse    = false;
+    }
+
+    // Make sure the pixels decoded by stb_image end up in the target memory
+    bool endDecode(unsigned char* result, std::size_t size)
+    {
+        bool success = result && (size == decodeTarget.size);
+
+        if (result && (result != decodeTarget.buffer))
+        {
+            if (success)
+            {
+                std::memcpy(decodeTarget.buffer, result, size);
+                decodeCopyCount++;
+            }
+            std::free(result);
+        }
+
+        beginDecode(NULL, 0, 0);
+
+        return success;
+    }
+}
+
+#define STBI_MALLOC(size)           decodeMalloc(size)
+#define STBI_REALLOC(pointer, size) decodeRealloc(pointer, size)
+#define STBI_FREE(pointer)          decodeFree(pointer)
+#define STBI_THREAD_LOCAL           thread_local
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <cpp3ds/Graphics/stb_image/stb_image.h>
@@ -39,6 +136,8 @@ extern "C"
     #include <jerror.h>
 }
 #include <cctype>
+#include <csetjmp>
+#include <cstdio>
 #include <cpp3ds/System/FileSystem.hpp>
 
 
@@ -68,6 +167,78 @@ namespace
         cpp3ds::InputStream* stream = static_cast<cpp3ds::InputStream*>(user);
         return stream->tell() >= stream->getSize();
     }
+
+    // libjpeg error handler that jumps back to the decoding function
+    // instead of exiting, keeping the message for the error output
+    struct JpegErrorManager
+    {
+        jpeg_error_mgr manager;
+        jmp_buf        jump;
+        char           message[JMSG_LENGTH_MAX];
+    };
+    void jpegErrorExit(j_common_ptr infos)
+    {
+        JpegErrorManager* errorManager = reinterpret_cast<JpegErrorManager*>(infos->err);
+        (*infos->err->format_message)(infos, errorManager->message);
+        std::longjmp(errorManager->jump, 1);
+    }
+    void jpegOutputMessage(j_common_ptr)
+    {
+        // Warnings about recoverable corrupt data are ignored
+    }
+
+    // Check the start of image marker of a JPEG file
+    bool isJpegFile(const std::string& path)
+    {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file)
+            return false;
+
+        unsigned char marker[3] = {0, 0, 0};
+        std::size_t count = std::fread(marker, 1, 3, file);
+        std::fclose(file);
+
+        return (count == 3) && (marker[0] == 0xFF) && (marker[1] == 0xD8) && (marker[2] == 0xFF);
+    }
+
+    // Crop RGBA pixels to an area and reduce it by a factor, averaging
+    // each block of pixels. The result is written at the start of the
+    // same memory, which is safe as no block is ever read from before
+    // the position its average is written to.
+    void reducePixels(cpp3ds::Uint8* pixels, unsigned int width, const cpp3ds::IntRect& area, unsigned int factor, cpp3ds::Vector2u& size)
+    {
+        size.x = (area.width + factor - 1) / factor;
+        size.y = (area.height + factor - 1) / factor;
+
+        cpp3ds::Uint8* dst = pixels;
+        for (unsigned int y = 0; y < size.y; ++y)
+        {
+            unsigned int top  = area.top + y * factor;
+            unsigned int rows = std::min(factor, area.height - y * factor);
+            for (unsigned int x = 0; x < size.x; ++x)
+            {
+                unsigned int left = area.left + x * factor;
+                unsigned int cols = std::min(factor, area.width - x * factor);
+
+                cpp3ds::Uint64 sum[4] = {0, 0, 0, 0};
+                for (unsigned int j = 0; j < rows; ++j)
+                {
+                    const cpp3ds::Uint8* src = pixels + ((top + j) * width + left) * 4;
+                    for (unsigned int i = 0; i < cols * 4; i += 4)
+                    {
+                        sum[0] += src[i + 0];
+                        sum[1] += src[i + 1];
+                        sum[2] += src[i + 2];
+                        sum[3] += src[i + 3];
+                    }
+                }
+
+                cpp3ds::Uint64 count = rows * cols;
+                for (int i = 0; i < 4; ++i)
+                    *dst++ = static_cast<cpp3ds::Uint8>((sum[i] + count / 2) / count);
+            }
+        }
+    }
 }
 
 
@@ -104,35 +275,162 @@ bool ImageLoader::loadImageFromFile(const std::string& filename, std::vector<Uin
     // Clear the array (just in case)
     pixels.clear();
 
-    // Load the image and get a pointer to the pixels in memory
+    // Read the size first, so that the pixels can be decoded straight into the array
+    std::string path = FileSystem::getFilePath(filename);
     int width, height, channels;
-	unsigned char* ptr = stbi_load(FileSystem::getFilePath(filename).c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (stbi_info(path.c_str(), &width, &height, &channels) && width && height)
+    {
+        pixels.resize(width * height * 4 + 1);
+        beginDecode(&pixels[0], width * height * 4, pixels.size());
+
+        unsigned char* ptr = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (endDecode(ptr, width * height * 4))
+        {
+            // Assign the image properties
+            size.x = width;
+            size.y = height;
+            pixels.resize(width * height * 4);
+
+            return true;
+        }
 
-	if (ptr && width && height)
+        pixels.clear();
+    }
+
+    // Error, failed to load the image
+    err() << "Failed to load image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::loadImageFromFile(const std::string& filename, Uint8* pixels, const Vector2u& size)
+{
+    std::string path = FileSystem::getFilePath(filename);
+    int width, height, channels;
+    beginDecode(pixels, size.x * size.y * 4, size.x * size.y * 4, isJpegFile(path));
+    unsigned char* ptr = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (ptr && ((width != static_cast<int>(size.x)) || (height != static_cast<int>(size.y))))
     {
-        // Assign the image properties
-        size.x = width;
-        size.y = height;
+        endDecode(ptr, 0);
+        err() << "Failed to load image \"" << filename << "\". Reason : Image size changed" << std::endl;
+        return false;
+    }
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
+    if (!endDecode(ptr, size.x * size.y * 4))
+    {
+        err() << "Failed to load image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    return true;
+}
 
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        stbi_image_free(ptr);
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::loadImageFromFile(const std::string& filename, const IntRect& area, unsigned int maxSize, std::vector<Uint8>& pixels, Vector2u& size)
+{
+    // Clear the array (just in case)
+    pixels.clear();
+
+    Vector2u imageSize;
+    if (!loadImageSizeFromFile(filename, imageSize))
+        return false;
+
+    IntRect rect = clampArea(area, imageSize);
+    if ((rect.width <= 0) || (rect.height <= 0))
+    {
+        err() << "Failed to load image \"" << filename << "\". Reason : Region is outside the image" << std::endl;
+        return false;
+    }
+
+    // Find the smallest power of two that makes the area fit
+    unsigned int factor = 1;
+    if (maxSize > 0)
+        while (((rect.width + factor - 1) / factor > maxSize) || ((rect.height + factor - 1) / factor > maxSize))
+            factor *= 2;
+
+    // JPEG files are reduced while decoding, and only the rows of the area are kept
+    std::string path = FileSystem::getFilePath(filename);
+    if (isJpegFile(path))
+        return readJpg(path, rect, factor, pixels, size);
+
+    // Other formats are decoded whole, then cropped and reduced in place
+    if (!loadImageFromFile(filename, pixels, imageSize))
+        return false;
+
+    if ((factor == 1) && (rect == IntRect(0, 0, imageSize.x, imageSize.y)))
+    {
+        size = imageSize;
+        return true;
+    }
+
+    reducePixels(&pixels[0], imageSize.x, rect, factor, size);
+
+    // Give back the memory of the full image
+    pixels.resize(size.x * size.y * 4);
+    std::vector<Uint8>(pixels).swap(pixels);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect ImageLoader::clampArea(const IntRect& area, const Vector2u& size)
+{
+    int width = static_cast<int>(size.x);
+    int height = static_cast<int>(size.y);
+
+    if ((area.width == 0) || (area.height == 0) ||
+       ((area.left <= 0) && (area.top <= 0) && (area.width >= width) && (area.height >= height)))
+        return IntRect(0, 0, width, height);
+
+    IntRect rectangle = area;
+    if (rectangle.left   < 0) rectangle.left = 0;
+    if (rectangle.top    < 0) rectangle.top  = 0;
+    if (rectangle.left + rectangle.width > width)  rectangle.width  = width - rectangle.left;
+    if (rectangle.top + rectangle.height > height) rectangle.height = height - rectangle.top;
+
+    return rectangle;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 ImageLoader::getDecodeCopyCount()
+{
+    return decodeCopyCount;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::loadImageSizeFromFile(const std::string& filename, Vector2u& size)
+{
+    // Only the header is read
+    int width, height, channels;
+    if (stbi_info(FileSystem::getFilePath(filename).c_str(), &width, &height, &channels) && width && height)
+    {
+        size.x = width;
+        size.y = height;
 
         return true;
     }
     else
     {
-        // Error, failed to load the image
-        err() << "Failed to load image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
+        err() << "Failed to read image \"" << filename << "\". Reason : " << stbi_failure_reason() << std::endl;
 
         return false;
     }
 }
 
 
+////////////////////////////////////////////////////////////
+bool ImageLoader::canLoadRegions(const std::string& filename)
+{
+    return isJpegFile(FileSystem::getFilePath(filename));
+}
+
+
 ////////////////////////////////////////////////////////////
 bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, std::vector<Uint8>& pixels, Vector2u& size)
 {
@@ -142,33 +440,32 @@ bool ImageLoader::loadImageFromMemory(const void* data, std::size_t dataSize, st
         // Clear the array (just in case)
         pixels.clear();
 
-        // Load the image and get a pointer to the pixels in memory
+        // Read the size first, so that the pixels can be decoded straight into the array
         int width, height, channels;
         const unsigned char* buffer = static_cast<const unsigned char*>(data);
-        unsigned char* ptr = stbi_load_from_memory(buffer, static_cast<int>(dataSize), &width, &height, &channels, STBI_rgb_alpha);
-
-        if (ptr && width && height)
+        if (stbi_info_from_memory(buffer, static_cast<int>(dataSize), &width, &height, &channels) && width && height)
         {
-            // Assign the image properties
-            size.x = width;
-            size.y = height;
+            pixels.resize(width * height * 4 + 1);
+            beginDecode(&pixels[0], width * height * 4, pixels.size());
 
-            // Copy the loaded pixels to the pixel buffer
-            pixels.resize(width * height * 4);
-            memcpy(&pixels[0], ptr, pixels.size());
+            unsigned char* ptr = stbi_load_from_memory(buffer, static_cast<int>(dataSize), &width, &height, &channels, STBI_rgb_alpha);
+            if (endDecode(ptr, width * height * 4))
+            {
+                // Assign the image properties
+                size.x = width;
+                size.y = height;
+                pixels.resize(width * height * 4);
 
-            // Free the loaded pixels (they are now in our own pixel buffer)
-            stbi_image_free(ptr);
+                return true;
+            }
 
-            return true;
+            pixels.clear();
         }
-        else
-        {
-            // Error, failed to load the image
-            err() << "Failed to load image from memory. Reason : " << stbi_failure_reason() << std::endl;
 
-            return false;
-        }
+        // Error, failed to load the image
+        err() << "Failed to load image from memory. Reason : " << stbi_failure_reason() << std::endl;
+
+        return false;
     }
     else
     {
@@ -193,32 +490,32 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
     callbacks.skip = &skip;
     callbacks.eof  = &eof;
 
-    // Load the image and get a pointer to the pixels in memory
+    // Read the size first, so that the pixels can be decoded straight into the array
     int width, height, channels;
-    unsigned char* ptr = stbi_load_from_callbacks(&callbacks, &stream, &width, &height, &channels, STBI_rgb_alpha);
-
-    if (ptr && width && height)
+    if (stbi_info_from_callbacks(&callbacks, &stream, &width, &height, &channels) && width && height)
     {
-        // Assign the image properties
-        size.x = width;
-        size.y = height;
+        pixels.resize(width * height * 4 + 1);
+        beginDecode(&pixels[0], width * height * 4, pixels.size());
 
-        // Copy the loaded pixels to the pixel buffer
-        pixels.resize(width * height * 4);
-        memcpy(&pixels[0], ptr, pixels.size());
+        stream.seek(0);
+        unsigned char* ptr = stbi_load_from_callbacks(&callbacks, &stream, &width, &height, &channels, STBI_rgb_alpha);
+        if (endDecode(ptr, width * height * 4))
+        {
+            // Assign the image properties
+            size.x = width;
+            size.y = height;
+            pixels.resize(width * height * 4);
 
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        stbi_image_free(ptr);
+            return true;
+        }
 
-        return true;
+        pixels.clear();
     }
-    else
-    {
-        // Error, failed to load the image
-        err() << "Failed to load image from stream. Reason : " << stbi_failure_reason() << std::endl;
 
-        return false;
-    }
+    // Error, failed to load the image
+    err() << "Failed to load image from stream. Reason : " << stbi_failure_reason() << std::endl;
+
+    return false;
 }
 
 
@@ -320,6 +617,110 @@ bool ImageLoader::writeJpg(const std::string& filename, const std::vector<Uint8>
     return true;
 }
 
+
+////////////////////////////////////////////////////////////
+bool ImageLoader::readJpg(const std::string& path, const IntRect& area, unsigned int factor, std::vector<Uint8>& pixels, Vector2u& size)
+{
+    // Open the file to read from
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        err() << "Failed to load image \"" << path << "\". Reason : Unable to open file" << std::endl;
+        return false;
+    }
+
+    // Initialize the error handler. The scratch memory below comes from
+    // libjpeg's pools, so that nothing leaks when an error jumps back here.
+    jpeg_decompress_struct decompressInfos;
+    JpegErrorManager errorManager;
+    decompressInfos.err = jpeg_std_error(&errorManager.manager);
+    errorManager.manager.error_exit     = &jpegErrorExit;
+    errorManager.manager.output_message = &jpegOutputMessage;
+
+    if (setjmp(errorManager.jump))
+    {
+        err() << "Failed to load image \"" << path << "\". Reason : " << errorManager.message << std::endl;
+        jpeg_destroy_decompress(&decompressInfos);
+        fclose(file);
+        pixels.clear();
+        return false;
+    }
+
+    jpeg_create_decompress(&decompressInfos);
+    jpeg_stdio_src(&decompressInfos, file);
+    jpeg_read_header(&decompressInfos, TRUE);
+
+    // The DCT scaling reduces by up to 8, the rest is averaged from the rows
+    unsigned int scale = std::min(factor, 8u);
+    decompressInfos.scale_num       = 1;
+    decompressInfos.scale_denom     = scale;
+    decompressInfos.out_color_space = (decompressInfos.num_components == 1) ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&decompressInfos);
+
+    // Area and remaining reduction in the scaled image
+    unsigned int reduction = factor / scale;
+    unsigned int left      = area.left / scale;
+    unsigned int top       = area.top / scale;
+    unsigned int width     = std::min<unsigned int>((area.width + scale - 1) / scale, decompressInfos.output_width - left);
+    unsigned int height    = std::min<unsigned int>((area.height + scale - 1) / scale, decompressInfos.output_height - top);
+    unsigned int bottom    = top + height;
+    unsigned int channels  = decompressInfos.output_components;
+
+    size.x = (width + reduction - 1) / reduction;
+    size.y = (height + reduction - 1) / reduction;
+    pixels.resize(size.x * size.y * 4);
+
+    j_common_ptr common = reinterpret_cast<j_common_ptr>(&decompressInfos);
+    JSAMPARRAY row = (*decompressInfos.mem->alloc_sarray)(common, JPOOL_IMAGE, decompressInfos.output_width * channels, 1);
+    Uint32* sums = static_cast<Uint32*>((*decompressInfos.mem->alloc_large)(common, JPOOL_IMAGE, size.x * 3 * sizeof(Uint32)));
+    std::memset(sums, 0, size.x * 3 * sizeof(Uint32));
+
+    // Read the rows down to the bottom of the area
+    Uint8* dst = &pixels[0];
+    unsigned int green = (channels > 1) ? 1 : 0;
+    unsigned int blue  = (channels > 1) ? 2 : 0;
+    while (decompressInfos.output_scanline < bottom)
+    {
+        jpeg_read_scanlines(&decompressInfos, row, 1);
+        unsigned int y = decompressInfos.output_scanline - 1;
+        if (y < top)
+            continue;
+
+        // Add the columns of the area to the blocks they belong to
+        const JSAMPLE* src = row[0] + left * channels;
+        for (unsigned int x = 0; x < width; ++x, src += channels)
+        {
+            Uint32* sum = sums + (x / reduction) * 3;
+            sum[0] += src[0];
+            sum[1] += src[green];
+            sum[2] += src[blue];
+        }
+
+        // Write the output row once its blocks are complete
+        if (((y - top + 1) % reduction == 0) || (y + 1 == bottom))
+        {
+            unsigned int rows = (y - top) % reduction + 1;
+            for (unsigned int x = 0; x < size.x; ++x)
+            {
+                Uint32* sum = sums + x * 3;
+                Uint32 count = rows * std::min(reduction, width - x * reduction);
+                *dst++ = static_cast<Uint8>((sum[0] + count / 2) / count);
+                *dst++ = static_cast<Uint8>((sum[1] + count / 2) / count);
+                *dst++ = static_cast<Uint8>((sum[2] + count / 2) / count);
+                *dst++ = 255;
+                sum[0] = sum[1] = sum[2] = 0;
+            }
+        }
+    }
+
+    // The rows below the area are never decoded
+    jpeg_abort_decompress(&decompressInfos);
+    jpeg_destroy_decompress(&decompressInfos);
+    fclose(file);
+
+    return true;
+}
+
 } // namespace priv
 
 } // namespace cpp3ds
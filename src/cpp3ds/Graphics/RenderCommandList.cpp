@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/RenderCommandList.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cstring>
+
+
+namespace
+{
+    bool isIdentity(const cpp3ds::Transform& transform)
+    {
+        return std::memcmp(transform.getMatrix(), cpp3ds::Transform::Identity.getMatrix(), 16 * sizeof(float)) == 0;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+RenderCommandList::RenderCommandList() :
+m_commands(),
+m_vertices()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::clear()
+{
+    m_commands.clear();
+    m_vertices.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderCommandList::isEmpty() const
+{
+    return m_commands.empty();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderCommandList::getCommandCount() const
+{
+    return static_cast<unsigned int>(m_commands.size());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int RenderCommandList::getVertexCount() const
+{
+    return static_cast<unsigned int>(m_vertices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::append(const Vertex* vertices, unsigned int vertexCount,
+                               PrimitiveType type, const RenderStates& states)
+{
+    if (vertexCount < 3)
+        return;
+
+    // Everything is stored as triangle lists, so that draws can be merged. The
+    // leftover vertices of an incomplete triangle are ignored as in a direct draw
+    unsigned int count = (type == Triangles) ? vertexCount - vertexCount % 3 : 3 * (vertexCount - 2);
+
+    // Extend the last command if its states are the same, start a new one otherwise
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if (m_commands.empty() ||
+        (textureId != m_commands.back().textureId) ||
+        (states.blendMode != m_commands.back().blendMode) ||
+        (states.shader != m_commands.back().shader) ||
+        (states.scissor != m_commands.back().scissor))
+    {
+        Command command;
+        command.first     = static_cast<unsigned int>(m_vertices.size());
+        command.count     = 0;
+        command.blendMode = states.blendMode;
+        command.texture   = states.texture;
+        command.textureId = textureId;
+        command.shader    = states.shader;
+        command.scissor   = states.scissor;
+        m_commands.push_back(command);
+    }
+
+    std::size_t first = m_vertices.size();
+    m_vertices.resize(first + count);
+    Vertex* vertex = &m_vertices[first];
+
+    if (type == Triangles)
+    {
+        states.transform.transformVertices(vertices, vertex, count);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < count; ++i, ++vertex)
+        {
+            // Index of the source vertex for the i-th triangle list vertex
+            unsigned int index;
+            if (type == TrianglesStrip)
+                index = i / 3 + i % 3;
+            else
+                index = (i % 3 == 0) ? 0 : i / 3 + i % 3;
+
+            vertex->position  = states.transform.transformPoint(vertices[index].position);
+            vertex->color     = vertices[index].color;
+            vertex->texCoords = vertices[index].texCoords;
+        }
+    }
+
+    m_commands.back().count += count;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandList::draw(RenderTarget& target, RenderStates states) const
+{
+    // Without an offset, the recorded vertices can be sent as they are
+    bool transformed = isIdentity(states.transform) && !target.m_commandList;
+
+    for (std::vector<Command>::const_iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+    {
+        states.blendMode = it->blendMode;
+        states.texture   = it->texture;
+        states.shader    = it->shader;
+        states.scissor   = it->scissor;
+
+        if (transformed)
+        {
+            target.flush();
+            target.drawPrimitives(&m_vertices[it->first], it->count, Triangles, states, true);
+        }
+        else
+        {
+            target.draw(&m_vertices[it->first], it->count, Triangles, states);
+        }
+    }
+}
+
+} // namespace cpp3ds
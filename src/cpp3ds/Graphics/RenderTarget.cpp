@@ -27,11 +27,13 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/RenderTarget.hpp>
 #include <cpp3ds/Graphics/Drawable.hpp>
+#include <cpp3ds/Graphics/RenderCommandList.hpp>
 #include <cpp3ds/Graphics/Shader.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <new>
 #include <c3d/renderbuffer.h>
 #include "CitroHelpers.hpp"
 
@@ -68,6 +70,10 @@ namespace
         }
     }
 
+
+    // Render target whose states cache matches the current GPU states,
+    // as they are shared by all the targets
+    const cpp3ds::RenderTarget* statesOwner = NULL;
 }
 
 
@@ -75,25 +81,38 @@ namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      ()
+m_defaultView    (),
+m_view           (),
+m_cache          (),
+m_vertexAllocator(StatesCache::FrameVertexCount * sizeof(Vertex)),
+m_commandList    (NULL)
 {
-	m_cache.vertexCache = new Vertex[StatesCache::VertexCacheSize];
+	m_cache.vertexCache = NULL;
 	m_cache.glStatesSet = false;
+	m_cache.dirty = StatesCache::AllDirty;
+	m_cache.batchEnabled = false;
+	m_cache.batchVertices = NULL;
+	m_cache.batchCount = 0;
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderTarget::~RenderTarget()
 {
-	delete[] m_cache.vertexCache;
+	// The pending batch won't be drawn, its texture mustn't flush it anymore
+	if ((m_cache.batchCount > 0) && m_cache.batchTexture && (m_cache.batchTexture->m_batchTarget == this))
+		m_cache.batchTexture->m_batchTarget = NULL;
+
+	if (statesOwner == this)
+		statesOwner = NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    flush();
+
     if (activate(true))
     {
         u32 clearColor = (((color.r)&0xFF)<<24) | (((color.g)&0xFF)<<16) | (((color.b)&0xFF)<<8) | (((color.a)&0xFF)<<0);
@@ -107,8 +126,11 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Pending batches must be drawn with the previous view
+    flush();
+
     m_view = view;
-    m_cache.viewChanged = true;
+    m_cache.dirty |= StatesCache::ViewDirty;
 }
 
 
@@ -199,80 +221,267 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
-	// Vertices allocated in the stack (common) can't be converted to physical address
-	if (osConvertVirtToPhys(vertices) == 0)
-	{
-		err() << "RenderTarget::draw() called with vertex array in inaccessible memory space." << std::endl;
-		return;
-	}
+    // Store the draw for later if a command list is being recorded
+    if (m_commandList)
+    {
+        m_commandList->append(vertices, vertexCount, type, states);
+        return;
+    }
+
+    // Merge small meshes into the pending batch if possible
+    if (m_cache.batchEnabled && addToBatch(vertices, vertexCount, type, states))
+        return;
+
+    // Batched draws that came before must reach the GPU first
+    flush();
+
+    drawPrimitives(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    m_cache.batchEnabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_cache.batchEnabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    if (m_cache.batchCount == 0)
+        return;
+
+    RenderStates states;
+    states.blendMode = m_cache.batchBlendMode;
+    states.texture   = m_cache.batchTexture;
+    states.shader    = m_cache.batchShader;
+    states.scissor   = m_cache.batchScissor;
+
+    // The vertices stay in the frame allocator until the GPU is done with
+    // them, the next batch is simply allocated after this one
+    unsigned int vertexCount = m_cache.batchCount;
+    m_cache.batchCount = 0;
+
+    if (states.texture && (states.texture->m_batchTarget == this))
+        states.texture->m_batchTarget = NULL;
+
+    drawPrimitives(m_cache.batchVertices, vertexCount, Triangles, states, true);
+}
+
+
+////////////////////////////////////////////////////////////
+Vertex* RenderTarget::allocateVertices(unsigned int vertexCount)
+{
+    Vertex* vertices = static_cast<Vertex*>(m_vertexAllocator.allocate(vertexCount * sizeof(Vertex)));
+    if (vertices)
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            ::new (&vertices[i]) Vertex();
+
+    return vertices;
+}
+
+
+////////////////////////////////////////////////////////////
+FrameAllocator& RenderTarget::getVertexAllocator()
+{
+    return m_vertexAllocator;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::beginRecording(RenderCommandList& commandList)
+{
+    // Draws made before must not end up in the list
+    flush();
+
+    commandList.clear();
+    m_commandList = &commandList;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::endRecording()
+{
+    m_commandList = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isRecording() const
+{
+    return m_commandList != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::addToBatch(const Vertex* vertices, unsigned int vertexCount,
+                              PrimitiveType type, const RenderStates& states)
+{
+    // Number of vertices once converted to a triangle list, the leftover
+    // vertices of an incomplete triangle are ignored as in a direct draw
+    if (vertexCount < 3)
+        return false;
+    unsigned int count = (type == Triangles) ? vertexCount - vertexCount % 3 : 3 * (vertexCount - 2);
+
+    // Big meshes are cheaper to draw directly than to transform on the CPU
+    if (count > StatesCache::BatchMaxVertexCount)
+        return false;
+
+    // Start a new batch if the states differ from the pending one
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if ((m_cache.batchCount > 0) &&
+        ((textureId != m_cache.batchTextureId) || (states.blendMode != m_cache.batchBlendMode) ||
+         (states.scissor != m_cache.batchScissor) || (states.shader != m_cache.batchShader)))
+        flush();
+
+    // Vertices of the same batch must be contiguous: a pending batch is
+    // extended with an unpadded block, which only ends up right after it
+    // if nothing else was allocated in between
+    std::size_t alignment = (m_cache.batchCount > 0) ? sizeof(float) : 16;
+    Vertex* vertex = static_cast<Vertex*>(m_vertexAllocator.allocate(count * sizeof(Vertex), alignment));
+    if (!vertex)
+    {
+        // Not enough room left in this frame, draw directly
+        flush();
+        return false;
+    }
+
+    if (m_cache.batchCount > 0 && vertex != m_cache.batchVertices + m_cache.batchCount)
+        flush();
+
+    if (m_cache.batchCount == 0)
+    {
+        m_cache.batchVertices  = vertex;
+        m_cache.batchTexture   = states.texture;
+        m_cache.batchTextureId = textureId;
+        m_cache.batchBlendMode = states.blendMode;
+        m_cache.batchScissor   = states.scissor;
+        m_cache.batchShader    = states.shader;
+
+        // The batch only keeps a pointer to the texture, the texture draws
+        // the batch if it goes away first. A texture is in one pending
+        // batch at a time.
+        if (states.texture)
+        {
+            if (states.texture->m_batchTarget)
+                states.texture->m_batchTarget->flush();
+            states.texture->m_batchTarget = this;
+        }
+    }
+
+    if (type == Triangles)
+    {
+        states.transform.transformVertices(vertices, vertex, count);
+    }
+    else
+    {
+        // Transform the positions once, strips and fans reuse them
+        Vector2f positions[StatesCache::BatchMaxVertexCount];
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            positions[i] = states.transform.transformPoint(vertices[i].position);
+
+        for (unsigned int i = 0; i < count; ++i, ++vertex)
+        {
+            // Index of the source vertex for the i-th triangle list vertex
+            unsigned int index;
+            if (type == TrianglesStrip)
+                index = i / 3 + i % 3;
+            else
+                index = (i % 3 == 0) ? 0 : i / 3 + i % 3;
+
+            vertex->position  = positions[index];
+            vertex->color     = vertices[index].color;
+            vertex->texCoords = vertices[index].texCoords;
+        }
+    }
+
+    m_cache.batchCount += count;
+
+    return true;
+}
+
 
+////////////////////////////////////////////////////////////
+void RenderTarget::drawPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                                  PrimitiveType type, const RenderStates& states, bool isTransformed)
+{
     if (activate(true))
     {
         // First set the persistent OpenGL states if it's the very first call
         if (!m_cache.glStatesSet)
             resetGLStates();
 
-        // Check if the vertex count is low enough so that we can pre-transform them
-//        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
-        bool useVertexCache = false;
+        validateCache();
+
+        // Check if the vertex count is low enough so that we can pre-transform them.
+        // The GPU only reads the vertices when the frame is flushed, so each draw
+        // needs its own copy, which is taken from the per-frame allocator.
+        Vertex* transformed = NULL;
+        if (!isTransformed && (vertexCount <= StatesCache::VertexCacheSize))
+            transformed = static_cast<Vertex*>(m_vertexAllocator.allocate(vertexCount * sizeof(Vertex)));
+
+        bool useVertexCache = isTransformed || transformed;
         if (useVertexCache)
         {
-            // Pre-transform the vertices and store them into the vertex cache
-            for (unsigned int i = 0; i < vertexCount; ++i)
+            // Pre-transform the vertices
+            if (transformed)
             {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
+                states.transform.transformVertices(vertices, transformed, vertexCount);
+                vertices = transformed;
             }
 
             // Since vertices are transformed, we must use an identity transform to render them
-            if (!m_cache.useVertexCache)
+            if (!m_cache.useVertexCache || (m_cache.dirty & StatesCache::TransformDirty))
                 applyTransform(Transform::Identity);
         }
         else
         {
+            // Vertices allocated in the stack (common) can't be converted to physical address
+            if (osConvertVirtToPhys(vertices) == 0)
+            {
+                err() << "RenderTarget::draw() called with vertex array in inaccessible memory space." << std::endl;
+                return;
+            }
+
             applyTransform(states.transform);
         }
 
         // Apply the view
-        if (m_cache.viewChanged)
+        if (m_cache.dirty & StatesCache::ViewDirty)
             applyCurrentView();
 
         // Apply the blend mode
-        if (states.blendMode != m_cache.lastBlendMode)
+        if ((m_cache.dirty & StatesCache::BlendModeDirty) || (states.blendMode != m_cache.lastBlendMode))
             applyBlendMode(states.blendMode);
 
         // Apply the scissor mode
-        if (states.scissor != m_cache.lastScissor)
+        if ((m_cache.dirty & StatesCache::ScissorDirty) || (states.scissor != m_cache.lastScissor))
             applyScissor(states.scissor);
 
         // Apply the texture
         Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
-        if (textureId != m_cache.lastTextureId)
+        if ((m_cache.dirty & StatesCache::TextureDirty) || (textureId != m_cache.lastTextureId))
             applyTexture(states.texture);
 
         // Apply the shader
-        if (states.shader)
+        if (states.shader || (m_cache.dirty & StatesCache::ShaderDirty))
             applyShader(states.shader);
 
-        // If we pre-transform the vertices, we must use our internal vertex cache
-        if (useVertexCache)
-        {
-            // ... and if we already used it previously, we don't need to set the pointers again
-            if (!m_cache.useVertexCache)
-                vertices = m_cache.vertexCache;
-            else
-                vertices = NULL;
-        }
-
         // Setup the pointers to the vertices' components
-        if (vertices)
-        {
-            C3D_BufInfo* bufInfo = C3D_GetBufInfo();
-            BufInfo_Init(bufInfo);
-            BufInfo_Add(bufInfo, vertices, sizeof(Vertex), 3, 0x210);
-        }
+        C3D_BufInfo* bufInfo = C3D_GetBufInfo();
+        BufInfo_Init(bufInfo);
+        BufInfo_Add(bufInfo, vertices, sizeof(Vertex), 3, 0x210);
 
         // Find the OpenGL primitive type
         static const GPU_Primitive_t modes[] = {GPU_TRIANGLES, GPU_TRIANGLE_STRIP, GPU_TRIANGLE_FAN, GPU_GEOMETRY_PRIM};
@@ -296,9 +505,19 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    flush();
+
 	if (activate(true))
     {
-        // TODO: implement pushGlStates
+        validateCache();
+
+        StatesCache::SavedStates saved;
+        saved.blendMode      = m_cache.lastBlendMode;
+        saved.textureId      = m_cache.lastTextureId;
+        saved.scissor        = m_cache.lastScissor;
+        saved.useVertexCache = m_cache.useVertexCache;
+        saved.dirty          = m_cache.dirty;
+        m_cache.stack.push_back(saved);
     }
     resetGLStates();
 }
@@ -307,9 +526,45 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flush();
+
+    if (m_cache.stack.empty())
+    {
+        err() << "RenderTarget::popGLStates() called without a matching pushGLStates()" << std::endl;
+        return;
+    }
+
+    StatesCache::SavedStates saved = m_cache.stack.back();
+    m_cache.stack.pop_back();
+
     if (activate(true))
     {
-        // TODO: implement popGLStates
+        validateCache();
+
+        // Apply again the saved states that were known to be on the GPU,
+        // but only the ones that changed since they were pushed
+        if (!(saved.dirty & StatesCache::BlendModeDirty) &&
+            ((m_cache.dirty & StatesCache::BlendModeDirty) || (saved.blendMode != m_cache.lastBlendMode)))
+            applyBlendMode(saved.blendMode);
+
+        if (!(saved.dirty & StatesCache::ScissorDirty) &&
+            ((m_cache.dirty & StatesCache::ScissorDirty) || (saved.scissor != m_cache.lastScissor)))
+            applyScissor(saved.scissor);
+
+        // Other transforms than the identity only last for one draw, no need to restore them
+        if (!(saved.dirty & StatesCache::TransformDirty) && saved.useVertexCache &&
+            ((m_cache.dirty & StatesCache::TransformDirty) || !m_cache.useVertexCache))
+        {
+            applyTransform(Transform::Identity);
+            m_cache.useVertexCache = true;
+        }
+
+        // A saved texture may have been destroyed since, so it is never bound
+        // again here: the next draw binds the one it needs if it differs.
+        // The view doesn't change, and the shader is restored after each draw.
+
+        // States that were unknown when pushed are unknown again
+        m_cache.dirty |= saved.dirty;
     }
 }
 
@@ -317,25 +572,17 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
-	// Check here to make sure a context change does not happen after activate(true)
-    bool shaderAvailable = Shader::isAvailable();
+    // Pending batches must be drawn with the states they were recorded with
+    flush();
 
     if (activate(true))
     {
         m_cache.glStatesSet = true;
+        validateCache();
 
-        // Apply the default SFML states
-        applyBlendMode(BlendAlpha);
-        applyTransform(Transform::Identity);
-        applyTexture(NULL);
-        applyScissor(UintRect());
-        if (shaderAvailable)
-            applyShader(NULL);
-
-        m_cache.useVertexCache = false;
-
-        // Set the default view
-        setView(getView());
+        // Nothing is written to the GPU here: the next draws apply the
+        // states they need, once, and skip the ones they don't use
+        m_cache.dirty = StatesCache::AllDirty;
     }
 }
 
@@ -359,6 +606,17 @@ C3D_RenderTarget* RenderTarget::getCitroTarget()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::validateCache()
+{
+    if (statesOwner != this)
+    {
+        m_cache.dirty = StatesCache::AllDirty;
+        statesOwner = this;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
@@ -370,7 +628,7 @@ void RenderTarget::applyCurrentView()
 	// Set the projection matrix
     memcpy(MtxStack_Cur(CitroGetProjectionMatrix())->m, m_view.getTransform().getMatrix(), sizeof(C3D_Mtx));
 
-    m_cache.viewChanged = false;
+    m_cache.dirty &= ~StatesCache::ViewDirty;
 }
 
 
@@ -386,6 +644,7 @@ void RenderTarget::applyBlendMode(const BlendMode& mode)
                    factorToGlConstant(mode.alphaDstFactor));
 
     m_cache.lastBlendMode = mode;
+    m_cache.dirty &= ~StatesCache::BlendModeDirty;
 }
 
 
@@ -407,6 +666,7 @@ void RenderTarget::applyScissor(const UintRect& rect)
         C3D_SetScissor(GPU_SCISSOR_NORMAL, left, right, top, bottom);
     }
     m_cache.lastScissor = rect;
+    m_cache.dirty &= ~StatesCache::ScissorDirty;
 }
 
 
@@ -414,6 +674,8 @@ void RenderTarget::applyScissor(const UintRect& rect)
 void RenderTarget::applyTransform(const Transform& transform)
 {
     memcpy(MtxStack_Cur(CitroGetModelviewMatrix())->m, transform.getMatrix(), sizeof(C3D_Mtx));
+
+    m_cache.dirty &= ~StatesCache::TransformDirty;
 }
 
 
@@ -423,6 +685,7 @@ void RenderTarget::applyTexture(const Texture* texture)
     Texture::bind(texture, Texture::Pixels);
 
     m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
+    m_cache.dirty &= ~StatesCache::TextureDirty;
 }
 
 
@@ -430,6 +693,8 @@ void RenderTarget::applyTexture(const Texture* texture)
 void RenderTarget::applyShader(const Shader* shader)
 {
     Shader::bind(shader);
+
+    m_cache.dirty &= ~StatesCache::ShaderDirty;
 }
 
 } // namespace cpp3ds
@@ -449,7 +714,16 @@ void RenderTarget::applyShader(const Shader* shader)
 //   lead, in worst case, to changing it every 4 vertices.
 //   To avoid that, when the vertex count is low enough, we
 //   pre-transform them and therefore use an identity transform
-//   to render them.
+//   to render them. The transformed copies are taken from the
+//   per-frame vertex allocator, as the GPU reads them later.
+//
+// * Batching
+//   When enabled, small meshes are transformed on the CPU and
+//   appended to the per-frame vertex allocator as long as the
+//   texture, blend mode, scissor and shader don't change. The
+//   whole run is then drawn at once with an identity transform.
+//   As the GPU only reads the vertices when the frame is
+//   flushed, the allocator is only recycled in the next frame.
 //
 // * Blending mode
 //   Since it overloads the == operator, we can easily check
@@ -113,6 +113,9 @@ bool RenderTexture::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTexture::display()
 {
+    // Submit the pending batched draws
+    flush();
+
     // Update the target texture
     if (setActive(true))
     {
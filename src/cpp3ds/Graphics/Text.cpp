@@ -28,12 +28,15 @@
 #include <cpp3ds/Graphics/Text.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/System/Err.hpp>
 #include <cpp3ds/Resources.hpp>
 #include <cmath>
 #include <iostream>
 #ifndef EMULATION
 #include "CitroHelpers.hpp"
 #include <citro3d.h>
+#else
+#include <cpp3ds/OpenGL.hpp>
 #endif
 
 
@@ -73,6 +76,47 @@ void addGlyphQuad(cpp3ds::VertexArray& vertices, cpp3ds::Vector2f position, cons
     vertices.append(cpp3ds::Vertex(cpp3ds::Vector2f(position.x + right - italic * top    - outlineThickness, position.y + top    - outlineThickness), color, cpp3ds::Vector2f(u2, v1)));
     vertices.append(cpp3ds::Vertex(cpp3ds::Vector2f(position.x + right - italic * bottom - outlineThickness, position.y + bottom - outlineThickness), color, cpp3ds::Vector2f(u2, v2)));
 }
+
+// Extend a distance field glyph over the padding its field spreads to
+cpp3ds::Glyph padGlyph(const cpp3ds::Glyph& glyph, float padding, int texturePadding)
+{
+    cpp3ds::Glyph padded = glyph;
+
+    padded.bounds.left   -= padding;
+    padded.bounds.top    -= padding;
+    padded.bounds.width  += 2 * padding;
+    padded.bounds.height += 2 * padding;
+
+    padded.textureRect.left   -= texturePadding;
+    padded.textureRect.top    -= texturePadding;
+    padded.textureRect.width  += 2 * texturePadding;
+    padded.textureRect.height += 2 * texturePadding;
+
+    return padded;
+}
+
+// Set the distance above which the distance field is drawn, the
+// edge is smoothed over 1 / sharpness around it
+void setDistanceThreshold(float threshold, float sharpness)
+{
+#ifdef EMULATION
+    // Fixed function OpenGL can't rescale the field, edges are hard
+    glCheck(glEnable(GL_ALPHA_TEST));
+    glCheck(glAlphaFunc(GL_GEQUAL, threshold));
+#else
+    CitroSetDistanceFieldEnv(threshold, sharpness);
+#endif
+}
+
+// Restore the regular texturing
+void resetDistanceThreshold()
+{
+#ifdef EMULATION
+    glCheck(glDisable(GL_ALPHA_TEST));
+#else
+    CitroResetDistanceFieldEnv();
+#endif
+}
 }
 
 
@@ -357,16 +401,32 @@ void Text::drawSystemFont(RenderTarget& target, RenderStates states) const
     ensureGeometryUpdate();
     states.transform *= getTransform();
 #ifdef _3DS
-    if (target.m_cache.viewChanged)
+    // Glyphs are drawn directly, so they can't be recorded
+    if (target.m_commandList)
+    {
+        err() << "Text using the system font can't be recorded in a RenderCommandList" << std::endl;
+        return;
+    }
+
+    // Batched draws must come first
+    target.flush();
+
+    if (!target.m_cache.glStatesSet)
+        target.resetGLStates();
+    target.validateCache();
+
+    const Uint8 dirty = target.m_cache.dirty;
+    if (dirty & RenderTarget::StatesCache::ViewDirty)
         target.applyCurrentView();
-    if (states.blendMode != target.m_cache.lastBlendMode)
+    if ((dirty & RenderTarget::StatesCache::BlendModeDirty) || (states.blendMode != target.m_cache.lastBlendMode))
         target.applyBlendMode(states.blendMode);
-    if (states.shader)
+    if (states.shader || (dirty & RenderTarget::StatesCache::ShaderDirty))
         target.applyShader(states.shader);
-    if (states.scissor != target.m_cache.lastScissor)
+    if ((dirty & RenderTarget::StatesCache::ScissorDirty) || (states.scissor != target.m_cache.lastScissor))
         target.applyScissor(states.scissor);
 
     target.applyTransform(states.transform);
+    target.m_cache.useVertexCache = false;
     Mtx_Identity(MtxStack_Cur(CitroGetTextureMatrix()));
     CitroUpdateMatrixStacks();
 
@@ -414,6 +474,12 @@ void Text::draw(RenderTarget& target, RenderStates states) const
         states.transform *= getTransform();
         states.texture = &m_font->getTexture(m_characterSize);
 
+        if (m_font->isDistanceField())
+        {
+            drawDistanceField(target, states);
+            return;
+        }
+
         // Only draw the outline if there is something to draw
         if (m_outlineThickness != 0)
             target.draw(m_outlineVertices, states);
@@ -423,6 +489,44 @@ void Text::draw(RenderTarget& target, RenderStates states) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Text::drawDistanceField(RenderTarget& target, const RenderStates& states) const
+{
+    // The thresholds aren't part of the render states, so the
+    // glyphs can't be recorded nor batched with other draws
+    if (target.m_commandList)
+    {
+        err() << "Text using a distance field font can't be recorded in a RenderCommandList" << std::endl;
+        return;
+    }
+
+    target.flush();
+
+#ifdef EMULATION
+    if (!target.activate(true))
+        return;
+#endif
+
+    // Distance field units covered by one pixel at this size
+    float scale = static_cast<float>(m_characterSize) / m_font->getDistanceFieldSize();
+    float sharpness = 2.f * m_font->getDistanceFieldSpread() * scale;
+
+    // The outline stops further from the glyph edges
+    if (m_outlineThickness != 0)
+    {
+        setDistanceThreshold(std::max(0.5f - m_outlineThickness / sharpness, 1.f / 255.f), sharpness);
+        target.draw(m_outlineVertices, states);
+        target.flush();
+    }
+
+    setDistanceThreshold(0.5f, sharpness);
+    target.draw(m_vertices, states);
+    target.flush();
+
+    resetDistanceThreshold();
+}
+
+
 ////////////////////////////////////////////////////////////
 void Text::ensureGeometryUpdateSystemFont() const
 {
@@ -516,6 +620,11 @@ void Text::ensureGeometryUpdate() const
         return;
     }
 
+    // Distance field glyphs are drawn with their padding, where the field fades out
+    bool  distanceField      = m_font->isDistanceField();
+    int   texturePadding     = static_cast<int>(m_font->getDistanceFieldSpread());
+    float padding            = distanceField ? texturePadding * static_cast<float>(m_characterSize) / m_font->getDistanceFieldSize() : 0.f;
+
     // Compute values related to the text style
     bool  bold               = (m_style & Bold) != 0;
     bool  underlined         = (m_style & Underlined) != 0;
@@ -596,13 +705,19 @@ void Text::ensureGeometryUpdate() const
         {
             const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold, m_outlineThickness);
 
+            // A distance field outline is the filled glyph drawn with a lower threshold,
+            // it grows by the outline thickness on each side
+            float grow   = distanceField ? 2 * m_outlineThickness : 0.f;
             float left   = glyph.bounds.left;
             float top    = glyph.bounds.top;
-            float right  = glyph.bounds.left + glyph.bounds.width;
-            float bottom = glyph.bounds.top  + glyph.bounds.height;
+            float right  = glyph.bounds.left + glyph.bounds.width  + grow;
+            float bottom = glyph.bounds.top  + glyph.bounds.height + grow;
 
             // Add the outline glyph to the vertices
-            addGlyphQuad(m_outlineVertices, Vector2f(x, y), m_outlineColor, glyph, italic, m_outlineThickness);
+            if (distanceField)
+                addGlyphQuad(m_outlineVertices, Vector2f(x, y), m_outlineColor, padGlyph(glyph, padding, texturePadding), italic);
+            else
+                addGlyphQuad(m_outlineVertices, Vector2f(x, y), m_outlineColor, glyph, italic, m_outlineThickness);
 
             // Update the current bounds with the outlined glyph bounds
             minX = std::min(minX, x + left   - italic * bottom - m_outlineThickness);
@@ -615,7 +730,10 @@ void Text::ensureGeometryUpdate() const
         const Glyph& glyph = m_font->getGlyph(curChar, m_characterSize, bold);
 
         // Add the glyph to the vertices
-        addGlyphQuad(m_vertices, Vector2f(x, y), m_fillColor, glyph, italic);
+        if (distanceField)
+            addGlyphQuad(m_vertices, Vector2f(x, y), m_fillColor, padGlyph(glyph, padding, texturePadding), italic);
+        else
+            addGlyphQuad(m_vertices, Vector2f(x, y), m_fillColor, glyph, italic);
 
         // Update the current bounds with the non outlined glyph bounds
         if (m_outlineThickness == 0)
@@ -27,15 +27,23 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/Graphics/TextureLoader.hpp>
+#include <cpp3ds/Graphics/TextureTiling.hpp>
 #include <cpp3ds/OpenGL/GLExtensions.hpp>
 #include <cpp3ds/Window/Window.hpp>
 #include <cpp3ds/System/Mutex.hpp>
 #include <cpp3ds/System/Lock.hpp>
 #include <cpp3ds/System/Err.hpp>
 #include <cpp3ds/OpenGL.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <utility>
 #include <c3d/texture.h>
 #include <cpp3ds/System/FileInputStream.hpp>
 #include <cpp3ds/System/FileSystem.hpp>
@@ -73,58 +81,6 @@ namespace
 		return id++;
 	}
 
-    // Grabbed from Citra Emulator (citra/src/video_core/utils.h)
-    static inline u32 morton_interleave(u32 x, u32 y)
-    {
-        u32 i = (x & 7) | ((y & 7) << 8); // ---- -210
-        i = (i ^ (i << 2)) & 0x1313;      // ---2 --10
-        i = (i ^ (i << 1)) & 0x1515;      // ---2 -1-0
-        i = (i | (	i >> 7)) & 0x3F;
-        return i;
-    }
-
-    //Grabbed from Citra Emulator (citra/src/video_core/utils.h)
-    static inline u32 get_morton_offset(u32 x, u32 y, u32 bytes_per_pixel)
-    {
-        u32 i = morton_interleave(x, y);
-        unsigned int offset = (x & ~7) * 8;
-        return (i + offset) * bytes_per_pixel;
-    }
-
-    void imageTile32(u8* dest, const u8* source, unsigned x, unsigned y, unsigned src_w, unsigned src_h, unsigned dest_w, unsigned dest_h)
-    {
-        int i, j;
-        for (j = 0; j < src_h; j++) {
-            for (i = 0; i < src_w; i++) {
-
-                int pos_y = (dest_h - 1 - j - y);
-
-                u32 coarse_y = pos_y & ~7;
-                u32 dst_offset = get_morton_offset(i+x, pos_y, 4) + coarse_y * dest_w * 4;
-
-                u32 v = ((u32 *)source)[i + j*src_w];
-                *(u32 *)(dest + dst_offset) = __builtin_bswap32(v);
-            }
-        }
-    }
-
-    void imageUntile32(u8* dest, const u8* source, unsigned x, unsigned y, unsigned src_w, unsigned src_h, unsigned dest_w, unsigned dest_h)
-    {
-        int i, j;
-        for (j = 0; j < src_h; j++) {
-            for (i = 0; i < src_w; i++) {
-
-                int pos_y = (dest_h - 1 - j - y);
-
-                u32 coarse_y = pos_y & ~7;
-                u32 src_offset = get_morton_offset(i+x, pos_y, 4) + coarse_y * dest_w * 4;
-
-                u32 v = *(u32 *)(source + src_offset);
-                ((u32 *)dest)[i + j*src_w] = __builtin_bswap32(v);
-            }
-        }
-    }
-
     inline size_t fmtSize(GPU_TEXCOLOR fmt)
     {
         switch (fmt)
@@ -152,6 +108,58 @@ namespace
                 return 0;
         }
     }
+
+    // Size of the base level and the mipmap chain under it, if any
+    size_t getDataSize(GPU_TEXCOLOR fmt, unsigned int width, unsigned int height, unsigned int levels)
+    {
+        size_t size = 0;
+        for (unsigned int i = 0; i < levels; ++i)
+            size += (width >> i) * (height >> i) * fmtSize(fmt) / 8;
+        return size;
+    }
+
+    // Texture format matching a GPU format, RGBA8 if there is none
+    cpp3ds::Texture::Format getTextureFormat(GPU_TEXCOLOR format)
+    {
+        switch (format)
+        {
+            case GPU_RGB565:   return cpp3ds::Texture::RGB565;
+            case GPU_RGBA5551: return cpp3ds::Texture::RGBA5551;
+            case GPU_RGBA4:    return cpp3ds::Texture::RGBA4;
+            case GPU_LA8:      return cpp3ds::Texture::LA8;
+            case GPU_A8:       return cpp3ds::Texture::A8;
+            case GPU_ETC1:     return cpp3ds::Texture::ETC1;
+            case GPU_ETC1A4:   return cpp3ds::Texture::ETC1A4;
+            default:           return cpp3ds::Texture::RGBA8;
+        }
+    }
+
+    GPU_TEXCOLOR getGpuFormat(cpp3ds::Texture::Format format)
+    {
+        switch (format)
+        {
+            case cpp3ds::Texture::RGB565:   return GPU_RGB565;
+            case cpp3ds::Texture::RGBA5551: return GPU_RGBA5551;
+            case cpp3ds::Texture::RGBA4:    return GPU_RGBA4;
+            case cpp3ds::Texture::LA8:      return GPU_LA8;
+            case cpp3ds::Texture::A8:       return GPU_A8;
+            case cpp3ds::Texture::ETC1:     return GPU_ETC1;
+            case cpp3ds::Texture::ETC1A4:   return GPU_ETC1A4;
+            case cpp3ds::Texture::Compressed: return GPU_ETC1A4;
+            default:                        return GPU_RGBA8;
+        }
+    }
+
+    // Pick the compressed format suited to an image
+    cpp3ds::Texture::Format getCompressedFormat(const cpp3ds::Image& image)
+    {
+        const cpp3ds::Uint8* pixels = image.getPixelsPtr();
+        std::size_t size = image.getSize().x * image.getSize().y * 4;
+        for (std::size_t i = 3; i < size; i += 4)
+            if (pixels[i] != 255)
+                return cpp3ds::Texture::ETC1A4;
+        return cpp3ds::Texture::ETC1;
+    }
 }
 
 
@@ -162,13 +170,21 @@ Texture::Texture() :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (nullptr),
+m_format       (RGBA8),
 m_isSmooth     (false),
 m_isRepeated   (false),
+m_hasMipmap    (false),
 m_pixelsFlipped(false),
 m_ownsData     (true),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
 {
-
+    TextureCache::add(*this);
 }
 
 
@@ -177,20 +193,87 @@ Texture::Texture(const Texture& copy) :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (nullptr),
+m_format       (RGBA8),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
+m_hasMipmap    (false),
 m_pixelsFlipped(false),
 m_ownsData     (true),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
 {
-    if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    TextureCache::add(*this);
+
+    if (copy.m_isEvicted)
+    {
+        // Share the source, the copy will be loaded when it's bound
+        m_size         = copy.m_size;
+        m_actualSize   = copy.m_actualSize;
+        m_format       = copy.m_format;
+        m_hasMipmap    = copy.m_hasMipmap;
+        m_retainedData = copy.m_retainedData;
+        m_isEvicted    = true;
+    }
+    else if (copy.m_texture)
+    {
+        loadFromImage(copy.copyToImage(), IntRect(), copy.m_format);
+        if (copy.m_hasMipmap)
+            generateMipmap();
+    }
+
+    m_sourceFile     = copy.m_sourceFile;
+    m_sourceArea     = copy.m_sourceArea;
+    m_isPreprocessed = copy.m_isPreprocessed;
+    m_sourceIndex    = copy.m_sourceIndex;
+}
+
+
+////////////////////////////////////////////////////////////
+Texture::Texture(Texture&& other) noexcept :
+m_size         (0, 0),
+m_actualSize   (0, 0),
+m_texture      (nullptr),
+m_format       (RGBA8),
+m_isSmooth     (false),
+m_isRepeated   (false),
+m_hasMipmap    (false),
+m_pixelsFlipped(false),
+m_ownsData     (true),
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
+{
+    other.flushBatch();
+
+    TextureCache::add(*this);
+    TextureCache::move(other, *this);
+
+    if (other.m_isLoading)
+        TextureLoader::move(other, *this);
+    else
+        moveFrom(other);
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::~Texture()
 {
+    flushBatch();
+
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    TextureCache::remove(*this);
+
     if (m_texture)
     {
         if (m_ownsData)
@@ -201,8 +284,11 @@ Texture::~Texture()
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, Format format)
 {
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
     {
@@ -230,7 +316,13 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.x        = width;
     m_size.y        = height;
     m_actualSize    = actualSize;
+    m_format        = (format == Compressed) ? ETC1A4 : format;
+    m_hasMipmap     = false;
     m_pixelsFlipped = false;
+    m_isEvicted     = false;
+    m_sourceFile.clear();
+    m_isPreprocessed = false;
+    std::vector<Uint8>().swap(m_retainedData);
 
 	ensureGlContext();
 
@@ -242,7 +334,7 @@ bool Texture::create(unsigned int width, unsigned int height)
 
     if (!m_texture)
         return false;
-    if (!C3D_TexInit(m_texture, m_actualSize.x, m_actualSize.y, GPU_RGBA8))
+    if (!C3D_TexInit(m_texture, m_actualSize.x, m_actualSize.y, getGpuFormat(m_format)))
         return false;
 
     C3D_TexSetWrap(m_texture,
@@ -261,8 +353,46 @@ bool Texture::create(unsigned int width, unsigned int height)
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 {
-    Image image;
-    return image.loadFromFile(filename) && loadFromImage(image, area);
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageSizeFromFile(filename, size))
+        return false;
+
+    // A whole image that fills the texture exactly is decoded straight
+    // into texture memory and tiled in place, without an intermediate image
+    if ((area.width == 0 || area.height == 0) &&
+        (size.x == getValidSize(size.x)) && (size.y == getValidSize(size.y)) &&
+        (size.x >= 8) && (size.y >= 8) && (size.x <= getMaximumSize()) && (size.y <= getMaximumSize()))
+    {
+        if (!create(size.x, size.y))
+            return false;
+
+        Uint8* data = static_cast<Uint8*>(m_texture->data);
+        if (!priv::ImageLoader::getInstance().loadImageFromFile(filename, data, size))
+            return false;
+
+        priv::tileImageInPlace(data, size.x, size.y);
+        C3D_TexFlush(m_texture);
+        m_cacheId = getUniqueId();
+    }
+    else
+    {
+        Image image;
+        if (!image.loadFromFile(filename, area) || !loadFromImage(image))
+            return false;
+    }
+
+    // Remember where the pixels come from, in case the texture is evicted
+    m_sourceFile = filename;
+    m_sourceArea = area;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromFileAsync(const std::string& filename, const IntRect& area, Format format)
+{
+    return TextureLoader::load(*this, filename, area, format, NULL);
 }
 
 
@@ -282,8 +412,18 @@ bool Texture::loadFromStream(InputStream& stream, const IntRect& area)
 }
 
 ////////////////////////////////////////////////////////////
-bool Texture::loadFromImage(const Image& image, const IntRect& area)
+bool Texture::loadFromImage(const Image& image, Format format)
 {
+    return loadFromImage(image, IntRect(), format);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromImage(const Image& image, const IntRect& area, Format format)
+{
+    if (format == Compressed)
+        format = getCompressedFormat(image);
+
     // Retrieve the image size
     int width = static_cast<int>(image.getSize().x);
     int height = static_cast<int>(image.getSize().y);
@@ -293,7 +433,7 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
        ((area.left <= 0) && (area.top <= 0) && (area.width >= width) && (area.height >= height)))
     {
         // Load the entire image
-        if (create(image.getSize().x, image.getSize().y))
+        if (create(image.getSize().x, image.getSize().y, format))
         {
             update(image);
             return true;
@@ -308,25 +448,20 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
         // Load a sub-area of the image
 
         // Adjust the rectangle to the size of the image
-        IntRect rectangle = area;
-        if (rectangle.left   < 0) rectangle.left = 0;
-        if (rectangle.top    < 0) rectangle.top  = 0;
-        if (rectangle.left + rectangle.width > width)  rectangle.width  = width - rectangle.left;
-        if (rectangle.top + rectangle.height > height) rectangle.height = height - rectangle.top;
-
-        // Create the texture and upload the pixels
-        if (create(rectangle.width, rectangle.height))
+        IntRect rectangle = priv::ImageLoader::clampArea(area, image.getSize());
+
+        // Nothing left once clamped to the image
+        if (rectangle.width <= 0 || rectangle.height <= 0)
+        {
+            err() << "Failed to load texture from image, the area is outside of the image" << std::endl;
+            return false;
+        }
+
+        // Create the texture and tile the rows of the area straight into it
+        if (create(rectangle.width, rectangle.height, format))
         {
-            err() << "Unsupported texture operation!" << std::endl;
-            // Copy the pixels to the texture, row by row
             const Uint8* pixels = image.getPixelsPtr() + 4 * (rectangle.left + (width * rectangle.top));
-//            glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-            for (int i = 0; i < rectangle.height; ++i)
-            {
-                // TODO: implement GX_TextureCopy
-//                glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, rectangle.width, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-                pixels += 4 * width;
-            }
+            updateRegion(pixels, rectangle.width, rectangle.height, width * 4, 0, 0);
 
             return true;
         }
@@ -340,35 +475,88 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 
 ////////////////////////////////////////////////////////////
 bool Texture::loadFromPreprocessedFile(const std::string& filename)
+{
+    return loadFromPreprocessedFile(filename, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromPreprocessedFile(const std::string& filename, unsigned int index)
 {
     if (filename.empty())
         return false;
 
-    Header header;
     FileInputStream file;
     if (!file.open(filename))
         return false;
 
-    file.read(&header, sizeof(Header));
-    size_t size = file.getSize() - sizeof(Header);
+    if (priv::TextureContainer::isContainer(file))
+    {
+        priv::TextureContainer container;
+        if (!container.openFromStream(file))
+            return false;
+
+        if (index >= container.getTextureCount())
+        {
+            err() << "Failed to load texture " << index << " of \"" << filename << "\", it has "
+                  << container.getTextureCount() << " textures" << std::endl;
+            return false;
+        }
 
-    // Verify header
-    GPU_TEXCOLOR format = static_cast<GPU_TEXCOLOR>(header.format);
-    if (size != header.width * header.height * fmtSize(format) / 8)
+        // The levels are read, or decompressed, straight into texture memory
+        if (!createPreprocessed(container.getTexture(index)) || !container.readTexture(index, m_texture->data))
+            return false;
+    }
+    else
     {
-        err() << "Improper file header: " << filename << std::endl;
-        return false;
+        if (index != 0)
+        {
+            err() << "Failed to load texture " << index << " of \"" << filename << "\", it has 1 texture" << std::endl;
+            return false;
+        }
+
+        Header header;
+        if (file.read(&header, sizeof(Header)) != sizeof(Header))
+        {
+            err() << "Improper file header: " << filename << std::endl;
+            return false;
+        }
+        size_t size = file.getSize() - sizeof(Header);
+
+        // Verify header
+        GPU_TEXCOLOR format = static_cast<GPU_TEXCOLOR>(header.format);
+        unsigned int levels = priv::getMipmapLevelCount(header.width, header.height);
+        bool mipmap = (levels > 1) && (size == getDataSize(format, header.width, header.height, levels));
+        if (!mipmap && (size != getDataSize(format, header.width, header.height, 1)))
+        {
+            err() << "Improper file header: " << filename << std::endl;
+            return false;
+        }
+
+        // The data is read straight into texture memory
+        if (!createPreprocessed(header.width, header.height, format, mipmap) ||
+            (file.read(m_texture->data, size) != static_cast<Int64>(size)))
+            return false;
+
+        m_size.x = header.widthOriginal;
+        m_size.y = header.heightOriginal;
     }
 
-    void *data = malloc(size);
-    file.read(data, size);
+    GSPGPU_FlushDataCache(m_texture->data, getMemorySize());
 
-    bool ret = loadFromPreprocessedMemory(data, size, header.width, header.height, format, true);
-    m_size.x = header.widthOriginal;
-    m_size.y = header.heightOriginal;
+    // Remember where the data comes from, in case the texture is evicted
+    m_sourceFile = filename;
+    m_sourceIndex = index;
+    m_isPreprocessed = true;
 
-    free(data);
-    return ret;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromPreprocessedFileAsync(const std::string& filename, unsigned int index)
+{
+    return TextureLoader::loadPreprocessed(*this, filename, index, NULL);
 }
 
 
@@ -399,11 +587,18 @@ bool Texture::loadFromPreprocessedMemory(void *data, size_t size, size_t width,
     if (!data)
         return false;
 
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
     m_ownsData      = copyData;
     m_size.x        = width;
     m_size.y        = height;
     m_actualSize    = m_size;
     m_pixelsFlipped = false;
+    m_isEvicted     = false;
+    m_sourceFile.clear();
+    m_isPreprocessed = false;
+    std::vector<Uint8>().swap(m_retainedData);
 
     ensureGlContext();
 
@@ -416,20 +611,36 @@ bool Texture::loadFromPreprocessedMemory(void *data, size_t size, size_t width,
     if (!m_texture)
         return false;
 
+    // The data may hold the whole mipmap chain after the base level
+    unsigned int levels = priv::getMipmapLevelCount(width, height);
+    m_hasMipmap = (levels > 1) && (size == getDataSize(format, width, height, levels));
+
     if (copyData)
     {
-        C3D_TexInit(m_texture, width, height, format);
-        C3D_TexUpload(m_texture, data);
+        if (m_hasMipmap)
+        {
+            C3D_TexInitMipmap(m_texture, width, height, format);
+            std::memcpy(m_texture->data, data, size);
+        }
+        else
+        {
+            C3D_TexInit(m_texture, width, height, format);
+            C3D_TexUpload(m_texture, data);
+        }
     }
     else
+    {
         m_texture->data = data;
+        m_texture->maxLevel = m_hasMipmap ? levels - 1 : 0;
+    }
 
     m_texture->size = size;
     m_texture->fmt = format;
+    m_format = getTextureFormat(format);
     m_texture->height = height;
     m_texture->width = width;
 
-    C3D_TexFlush(m_texture);
+    GSPGPU_FlushDataCache(m_texture->data, size);
 
     C3D_TexSetWrap(m_texture,
                    m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
@@ -437,6 +648,8 @@ bool Texture::loadFromPreprocessedMemory(void *data, size_t size, size_t width,
     C3D_TexSetFilter(m_texture,
                      m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
                      m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+    if (m_hasMipmap)
+        C3D_TexSetFilterMipmap(m_texture, GPU_LINEAR);
 
     m_cacheId = getUniqueId();
 
@@ -452,64 +665,88 @@ Vector2u Texture::getSize() const
 
 
 ////////////////////////////////////////////////////////////
-Image Texture::copyToImage() const
+Texture::Format Texture::getFormat() const
 {
-    // Easy case: empty texture
-    if (!m_texture)
-        return Image();
+    return m_format;
+}
 
-    // Create an array of pixels
-    std::vector<Uint8> pixels(m_size.x * m_size.y * 4);
 
-    u32 *data = (u32*)linearAlloc(m_texture->size);
+////////////////////////////////////////////////////////////
+bool Texture::isLoading() const
+{
+    return m_isLoading;
+}
+
 
-        imageUntile32((u8*)data, (u8*)m_texture->data, 0, 0, m_texture->width, m_texture->height, m_texture->width, m_texture->height);
-        GSPGPU_FlushDataCache(data, m_texture->size);
+////////////////////////////////////////////////////////////
+Image Texture::copyToImage() const
+{
+    return copyToImage(IntRect(0, 0, m_size.x, m_size.y));
+}
 
-    if ((m_size == m_actualSize) && !m_pixelsFlipped)
-	{
-		// Texture is not padded nor flipped, we can use a direct copy
-        std::memcpy(&pixels[0], data, pixels.size());
-	}
-	else
-	{
-		// Texture is either padded or flipped, we have to use a slower algorithm
-
-		// All the pixels will first be copied to a temporary array
-		std::vector<Uint8> allPixels(m_actualSize.x * m_actualSize.y * 4);
-        std::memcpy(&allPixels[0], data, allPixels.size());
-
-		// Then we copy the useful pixels from the temporary array to the final one
-		const Uint8* src = &allPixels[0];
-		Uint8* dst = &pixels[0];
-		int srcPitch = m_actualSize.x * 4;
-		int dstPitch = m_size.x * 4;
-
-		// Handle the case where source pixels are flipped vertically
-		if (m_pixelsFlipped)
-		{
-			src += srcPitch * (m_size.y - 1);
-			srcPitch = -srcPitch;
-		}
-
-		for (unsigned int i = 0; i < m_size.y; ++i)
-		{
-			std::memcpy(dst, src, dstPitch);
-			src += srcPitch;
-			dst += dstPitch;
-		}
-	}
+
+////////////////////////////////////////////////////////////
+Image Texture::copyToImage(const IntRect& area) const
+{
+    if (area.width <= 0 || area.height <= 0)
+        return Image();
+
+    // Create an array of pixels
+    std::vector<Uint8> pixels(area.width * area.height * 4);
+    if (!readPixels(area, &pixels[0]))
+        return Image();
 
     // Create the image
     Image image;
-    image.create(m_size.x, m_size.y, &pixels[0]);
-
-    linearFree(data);
+    image.create(area.width, area.height, &pixels[0]);
 
     return image;
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::readPixels(const IntRect& area, Uint8* pixels) const
+{
+    // Bring back the pixels if the texture cache evicted them
+    if (m_isEvicted)
+        const_cast<Texture*>(this)->restore();
+
+    // Easy case: empty texture
+    if (!m_texture)
+        return false;
+
+    if ((area.left < 0) || (area.top < 0) || (area.width <= 0) || (area.height <= 0) ||
+        (static_cast<unsigned int>(area.left + area.width) > m_size.x) ||
+        (static_cast<unsigned int>(area.top + area.height) > m_size.y))
+    {
+        err() << "Failed to read texture pixels, the area is outside of the texture" << std::endl;
+        return false;
+    }
+
+    // Preprocessed textures may use a format without converter
+    if (m_texture->fmt != getGpuFormat(m_format))
+    {
+        err() << "Failed to read texture pixels, no converter for its pixel format" << std::endl;
+        return false;
+    }
+
+    // Source pixels flipped vertically are read from the mirrored rows
+    unsigned int top = m_pixelsFlipped ? m_size.y - area.top - area.height : area.top;
+    unsigned int pitch = area.width * 4;
+
+    // Only the tiles covering the area are converted
+    priv::untileImage(pixels, static_cast<const Uint8*>(m_texture->data), area.left, top, area.width, area.height,
+                      pitch, m_texture->width, m_texture->height, m_format);
+
+    if (m_pixelsFlipped)
+    {
+        for (int i = 0; i < area.height / 2; ++i)
+            std::swap_ranges(pixels + i * pitch, pixels + (i + 1) * pitch, pixels + (area.height - 1 - i) * pitch);
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////
 void Texture::update(const Uint8* pixels)
 {
@@ -520,18 +757,81 @@ void Texture::update(const Uint8* pixels)
 
 ////////////////////////////////////////////////////////////
 void Texture::update(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int x, unsigned int y)
+{
+    updateRegion(pixels, width, height, width * 4, x, y);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateRegion(const Uint8* pixels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int x, unsigned int y)
 {
     assert(x + width <= m_size.x);
     assert(y + height <= m_size.y);
 
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    // The pixels must be updated on top of the evicted ones
+    if (m_isEvicted)
+        restore();
+
     if (pixels && m_texture)
     {
-            u8* dest = (u8*)m_texture->data;
+        // Preprocessed textures may use a format without converter
+        if (m_texture->fmt != getGpuFormat(m_format))
+        {
+            err() << "Failed to update texture, no converter for its pixel format" << std::endl;
+            return;
+        }
+
+        priv::tileImage(static_cast<Uint8*>(m_texture->data), pixels, x, y, width, height,
+                        pitch, m_texture->width, m_texture->height, m_format);
+
+        // Keep the smaller levels in sync with the base one
+        if (m_hasMipmap)
+            generateMipmap();
+        else
+            C3D_TexFlush(m_texture);
+
+        // The texture doesn't match its source anymore, it can't be evicted
+        m_sourceFile.clear();
+        m_isPreprocessed = false;
+        m_pixelsFlipped = false;
+        m_cacheId = getUniqueId();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::updateTexels(const Uint8* texels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int x, unsigned int y)
+{
+    assert(x + width <= m_size.x);
+    assert(y + height <= m_size.y);
+
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    if (m_isEvicted)
+        restore();
+
+    if (texels && m_texture)
+    {
+        if ((m_format == ETC1) || (m_format == ETC1A4) || (m_texture->fmt != getGpuFormat(m_format)))
+        {
+            err() << "Failed to update texture, its texels can't be written directly" << std::endl;
+            return;
+        }
 
-            imageTile32(dest, pixels, x, y, width, height, m_texture->width, m_texture->height);
+        priv::tileImage(static_cast<Uint8*>(m_texture->data), texels, x, y, width, height,
+                        pitch, m_texture->width, m_texture->height, priv::getBitsPerPixel(m_format));
 
+        if (m_hasMipmap)
+            generateMipmap();
+        else
             C3D_TexFlush(m_texture);
 
+        m_sourceFile.clear();
+        m_isPreprocessed = false;
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
     }
@@ -570,6 +870,8 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
     {
         err() << "Function not yet implemented" << std::endl;
 
+        m_sourceFile.clear();
+        m_isPreprocessed = false;
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
     }
@@ -624,18 +926,113 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (m_isEvicted)
+        restore();
+
+    if (!m_texture)
+        return false;
+
+    // Preprocessed textures may use a format without converter
+    if (m_texture->fmt != getGpuFormat(m_format))
+    {
+        err() << "Failed to generate mipmap, no converter for the texture pixel format" << std::endl;
+        return false;
+    }
+
+    unsigned int width = m_texture->width;
+    unsigned int height = m_texture->height;
+    unsigned int levels = priv::getMipmapLevelCount(width, height);
+    size_t baseSize = getDataSize(m_texture->fmt, width, height, 1);
+
+    // Make room for the whole chain, keeping the base level
+    if (!m_hasMipmap)
+    {
+        C3D_Tex* texture = new C3D_Tex();
+        if (!C3D_TexInitMipmap(texture, width, height, m_texture->fmt))
+        {
+            err() << "Failed to generate mipmap, not enough memory for the texture chain" << std::endl;
+            delete texture;
+            return false;
+        }
+
+        std::memcpy(texture->data, m_texture->data, baseSize);
+
+        if (m_ownsData)
+            C3D_TexDelete(m_texture);
+        delete m_texture;
+        m_texture = texture;
+        m_ownsData = true;
+
+        C3D_TexSetWrap(m_texture,
+                       m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
+                       m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE);
+        C3D_TexSetFilter(m_texture,
+                         m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
+                         m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+        C3D_TexSetFilterMipmap(m_texture, GPU_LINEAR);
+    }
+
+    // Read back the base level, then halve and tile it down to the last level
+    std::vector<Uint8> pixels(width * height * 4);
+    std::vector<Uint8> smaller(pixels.size() / 4);
+    priv::untileImage(&pixels[0], static_cast<const Uint8*>(m_texture->data), 0, 0, width, height,
+                      width * 4, width, height, m_format);
+
+    Uint8* level = static_cast<Uint8*>(m_texture->data) + baseSize;
+    for (unsigned int i = 1; i < levels; ++i)
+    {
+        priv::halveImage(&smaller[0], &pixels[0], width, height);
+        width /= 2;
+        height /= 2;
+
+        priv::tileImage(level, &smaller[0], 0, 0, width, height, width * 4, width, height, m_format);
+        level += getDataSize(m_texture->fmt, width, height, 1);
+
+        pixels.swap(smaller);
+    }
+
+    GSPGPU_FlushDataCache(m_texture->data, level - static_cast<Uint8*>(m_texture->data));
+
+    m_hasMipmap = true;
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
+    // Record the use, and reload the texture if it was evicted
+    if (texture)
+        TextureCache::use(*texture);
+
     if (texture && texture->m_texture)
     {
+        // Show the placeholder until the background load is finished
+        const Texture* source = texture->m_isLoading ? &TextureLoader::getPlaceholder() : texture;
+
         // Bind the texture
-        C3D_TexBind(0, texture->m_texture);
+        C3D_TexBind(0, source->m_texture);
 
         C3D_TexEnv* env = C3D_GetTexEnv(0);
-        C3D_TexEnvSrc(env, C3D_Both, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
         C3D_TexEnvOp(env, C3D_Both, 0, 0, 0);
-        C3D_TexEnvFunc(env, C3D_Both, GPU_MODULATE);
+        if (source->m_format == A8)
+        {
+            // Alpha textures sample black, take the color from the vertices only
+            C3D_TexEnvSrc(env, C3D_RGB, GPU_PRIMARY_COLOR, 0, 0);
+            C3D_TexEnvFunc(env, C3D_RGB, GPU_REPLACE);
+            C3D_TexEnvSrc(env, C3D_Alpha, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
+            C3D_TexEnvFunc(env, C3D_Alpha, GPU_MODULATE);
+        }
+        else
+        {
+            C3D_TexEnvSrc(env, C3D_Both, GPU_TEXTURE0, GPU_PRIMARY_COLOR, 0);
+            C3D_TexEnvFunc(env, C3D_Both, GPU_MODULATE);
+        }
 
         // Check if we need to define a special texture matrix
         if ((coordinateType == Pixels) || texture->m_pixelsFlipped)
@@ -690,20 +1087,393 @@ unsigned int Texture::getMaximumSize()
 ////////////////////////////////////////////////////////////
 Texture& Texture::operator =(const Texture& right)
 {
+    flushBatch();
+
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
     Texture temp(right);
 
     std::swap(m_size,          temp.m_size);
     std::swap(m_actualSize,    temp.m_actualSize);
     std::swap(m_texture,       temp.m_texture);
+    std::swap(m_format,        temp.m_format);
     std::swap(m_isSmooth,      temp.m_isSmooth);
     std::swap(m_isRepeated,    temp.m_isRepeated);
+    std::swap(m_hasMipmap,     temp.m_hasMipmap);
     std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
+    std::swap(m_sourceFile,    temp.m_sourceFile);
+    std::swap(m_sourceArea,    temp.m_sourceArea);
+    std::swap(m_isPreprocessed,temp.m_isPreprocessed);
+    std::swap(m_sourceIndex,   temp.m_sourceIndex);
+    std::swap(m_isEvicted,     temp.m_isEvicted);
+    std::swap(m_retainedData,  temp.m_retainedData);
+    std::swap(m_ownsData,      temp.m_ownsData);
     m_cacheId = getUniqueId();
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+Texture& Texture::operator =(Texture&& right) noexcept
+{
+    if (this != &right)
+    {
+        flushBatch();
+        right.flushBatch();
+
+        if (m_isLoading)
+            TextureLoader::cancel(*this);
+
+        if (m_texture)
+        {
+            if (m_ownsData)
+                C3D_TexDelete(m_texture);
+            delete m_texture;
+            m_texture = nullptr;
+        }
+
+        TextureCache::move(right, *this);
+
+        if (right.m_isLoading)
+            TextureLoader::move(right, *this);
+        else
+            moveFrom(right);
+    }
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::moveFrom(Texture& other)
+{
+    m_size           = other.m_size;
+    m_actualSize     = other.m_actualSize;
+    m_texture        = other.m_texture;
+    m_ownsData       = other.m_ownsData;
+    m_format         = other.m_format;
+    m_isSmooth       = other.m_isSmooth;
+    m_isRepeated     = other.m_isRepeated;
+    m_hasMipmap      = other.m_hasMipmap;
+    m_pixelsFlipped  = other.m_pixelsFlipped;
+    m_sourceFile     = std::move(other.m_sourceFile);
+    m_sourceArea     = other.m_sourceArea;
+    m_isPreprocessed = other.m_isPreprocessed;
+    m_sourceIndex    = other.m_sourceIndex;
+    m_isEvicted      = other.m_isEvicted;
+    m_retainedData   = std::move(other.m_retainedData);
+    m_isLoading      = other.m_isLoading;
+
+    // Render targets must not mistake either of them for what they cached
+    m_cacheId       = getUniqueId();
+    other.m_cacheId = getUniqueId();
+
+    other.m_size           = Vector2u(0, 0);
+    other.m_actualSize     = Vector2u(0, 0);
+    other.m_texture        = nullptr;
+    other.m_ownsData       = true;
+    other.m_hasMipmap      = false;
+    other.m_pixelsFlipped  = false;
+    other.m_sourceFile.clear();
+    other.m_sourceArea     = IntRect();
+    other.m_isPreprocessed = false;
+    other.m_sourceIndex    = 0;
+    other.m_isEvicted      = false;
+    other.m_retainedData.clear();
+    other.m_isLoading      = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::flushBatch() const
+{
+    if (m_batchTarget)
+        m_batchTarget->flush();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::grow(unsigned int width, unsigned int height, const Color& color)
+{
+    if (!m_texture || m_isLoading || (width < m_size.x) || (height < m_size.y))
+        return false;
+
+    if (m_isEvicted && !restore())
+        return false;
+
+    // Tile rows are copied from the bottom of the texture
+    if (m_pixelsFlipped)
+    {
+        err() << "Failed to grow texture, its pixels are flipped" << std::endl;
+        return false;
+    }
+
+    Vector2u actualSize(std::max(getValidSize(width), 8u), std::max(getValidSize(height), 8u));
+    unsigned int maxSize = getMaximumSize();
+    if ((actualSize.x > maxSize) || (actualSize.y > maxSize))
+    {
+        err() << "Failed to grow texture, its internal size is too high "
+              << "(" << actualSize.x << "x" << actualSize.y << ", "
+              << "maximum is " << maxSize << "x" << maxSize << ")"
+              << std::endl;
+        return false;
+    }
+
+    C3D_Tex* texture = new C3D_Tex();
+    if (!C3D_TexInit(texture, actualSize.x, actualSize.y, getGpuFormat(m_format)))
+    {
+        delete texture;
+        return false;
+    }
+
+    C3D_TexSetWrap(texture,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE);
+    C3D_TexSetFilter(texture,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+
+    // One tile of the fill color, repeated over the new area
+    std::vector<Uint8> pixels(8 * 8 * 4);
+    for (std::size_t i = 0; i < pixels.size(); i += 4)
+    {
+        pixels[i]     = color.r;
+        pixels[i + 1] = color.g;
+        pixels[i + 2] = color.b;
+        pixels[i + 3] = color.a;
+    }
+    std::vector<Uint8> tile(8 * 8 * 4);
+    priv::tileImage(&tile[0], &pixels[0], 0, 0, 8, 8, 8 * 4, 8, 8, m_format);
+
+    priv::growTiledImage(static_cast<Uint8*>(texture->data), static_cast<const Uint8*>(m_texture->data),
+                         m_actualSize.x, m_actualSize.y, actualSize.x, actualSize.y,
+                         priv::getBitsPerPixel(m_format), &tile[0]);
+    C3D_TexFlush(texture);
+
+    if (m_ownsData)
+        C3D_TexDelete(m_texture);
+    delete m_texture;
+
+    m_texture    = texture;
+    m_ownsData   = true;
+    m_size       = Vector2u(width, height);
+    m_actualSize = actualSize;
+    m_hasMipmap  = false;
+
+    // The pixels can't be reloaded from the source anymore
+    m_sourceFile.clear();
+    m_isPreprocessed = false;
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t Texture::getMemorySize() const
+{
+    if (!m_texture)
+        return 0;
+
+    unsigned int levels = m_hasMipmap ? priv::getMipmapLevelCount(m_texture->width, m_texture->height) : 1;
+    return getDataSize(m_texture->fmt, m_texture->width, m_texture->height, levels);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::evict()
+{
+    // The loader thread may be writing the pixels
+    if (m_isLoading)
+        return false;
+
+    // Data given by the user must stay where it is
+    if (!m_texture || !m_ownsData)
+        return false;
+
+    if (m_sourceFile.empty())
+    {
+        // Without a file to reload, only compressed data is worth keeping in main memory
+        if (m_format != ETC1 && m_format != ETC1A4)
+            return false;
+
+        const Uint8* data = static_cast<const Uint8*>(m_texture->data);
+        m_retainedData.assign(data, data + getMemorySize());
+    }
+
+    C3D_TexDelete(m_texture);
+    delete m_texture;
+    m_texture = nullptr;
+
+    // Render targets must bind the texture again, so that it gets reloaded
+    m_isEvicted = true;
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::restore()
+{
+    if (!m_isEvicted)
+        return m_texture != nullptr;
+
+    // Loading resets the source, keep it to evict the texture again later
+    std::string filename = m_sourceFile;
+    IntRect area = m_sourceArea;
+    unsigned int index = m_sourceIndex;
+    bool preprocessed = m_isPreprocessed;
+    bool mipmap = m_hasMipmap;
+    bool success;
+
+    if (!m_retainedData.empty())
+    {
+        m_texture = new C3D_Tex();
+        GPU_TEXCOLOR format = getGpuFormat(m_format);
+        success = mipmap ? C3D_TexInitMipmap(m_texture, m_actualSize.x, m_actualSize.y, format)
+                         : C3D_TexInit(m_texture, m_actualSize.x, m_actualSize.y, format);
+        if (success)
+        {
+            std::memcpy(m_texture->data, &m_retainedData[0], m_retainedData.size());
+            GSPGPU_FlushDataCache(m_texture->data, m_retainedData.size());
+            std::vector<Uint8>().swap(m_retainedData);
+
+            C3D_TexSetWrap(m_texture,
+                           m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
+                           m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE);
+            C3D_TexSetFilter(m_texture,
+                             m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
+                             m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+            if (mipmap)
+                C3D_TexSetFilterMipmap(m_texture, GPU_LINEAR);
+
+            m_isEvicted = false;
+            m_cacheId = getUniqueId();
+        }
+        else
+        {
+            delete m_texture;
+            m_texture = nullptr;
+        }
+    }
+    else if (preprocessed)
+    {
+        success = loadFromPreprocessedFile(filename, index);
+    }
+    else if (m_format == RGBA8)
+    {
+        success = loadFromFile(filename, area) && (!mipmap || generateMipmap());
+    }
+    else
+    {
+        Image image;
+        success = image.loadFromFile(filename) && loadFromImage(image, area, m_format) &&
+                  (!mipmap || generateMipmap());
+    }
+
+    if (!success)
+    {
+        // Give up rather than retrying on every bind, the texture stays empty
+        err() << "Failed to reload evicted texture " << filename << std::endl;
+        m_isEvicted = false;
+        std::vector<Uint8>().swap(m_retainedData);
+        return false;
+    }
+
+    m_sourceFile = filename;
+    m_sourceArea = area;
+    m_sourceIndex = index;
+    m_isPreprocessed = preprocessed;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::prepareLoad(const Uint8* pixels, unsigned int pitch)
+{
+    // The GPU reads the placeholder meanwhile, the memory can be written freely
+    priv::tileImage(static_cast<Uint8*>(m_texture->data), pixels, 0, 0, m_size.x, m_size.y,
+                    pitch, m_texture->width, m_texture->height, m_format);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::finishLoad(const Uint8* pixels, unsigned int pitch)
+{
+    // Preprocessed loads may have written the mipmap levels too
+    GSPGPU_FlushDataCache(m_texture->data, getMemorySize());
+    m_cacheId = getUniqueId();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::createPreprocessed(unsigned int width, unsigned int height, GPU_TEXCOLOR format, bool mipmap)
+{
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    bool ownedData  = m_ownsData;
+    m_ownsData      = true;
+    m_size.x        = width;
+    m_size.y        = height;
+    m_actualSize    = m_size;
+    m_format        = getTextureFormat(format);
+    m_hasMipmap     = mipmap;
+    m_pixelsFlipped = false;
+    m_isEvicted     = false;
+    m_sourceFile.clear();
+    m_isPreprocessed = false;
+    std::vector<Uint8>().swap(m_retainedData);
+
+    ensureGlContext();
+
+    // Create the citro3d texture, or delete if already created
+    if (!m_texture)
+        m_texture = new C3D_Tex();
+    else if (ownedData)
+        C3D_TexDelete(m_texture);
+
+    if (!(mipmap ? C3D_TexInitMipmap(m_texture, width, height, format)
+                 : C3D_TexInit(m_texture, width, height, format)))
+    {
+        delete m_texture;
+        m_texture = nullptr;
+        return false;
+    }
+
+    C3D_TexSetWrap(m_texture,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE,
+                   m_isRepeated ? GPU_REPEAT : GPU_CLAMP_TO_EDGE);
+    C3D_TexSetFilter(m_texture,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST,
+                     m_isSmooth ? GPU_LINEAR : GPU_NEAREST);
+    if (mipmap)
+        C3D_TexSetFilterMipmap(m_texture, GPU_LINEAR);
+
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::createPreprocessed(const priv::ContainerTexture& info)
+{
+    GPU_TEXCOLOR format = getGpuFormat(static_cast<Format>(info.format));
+    if (!createPreprocessed(info.width, info.height, format, info.levelCount > 1))
+        return false;
+
+    m_size.x = info.originalWidth;
+    m_size.y = info.originalHeight;
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureAtlas.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas() :
+m_padding (0),
+m_usedArea(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::create(unsigned int width, unsigned int height, unsigned int padding)
+{
+	if (!m_texture.create(width, height))
+	{
+		err() << "Failed to create texture atlas (" << width << "x" << height << ")" << std::endl;
+		return false;
+	}
+
+	// Start from a fully transparent texture
+	Vector2u size = m_texture.getSize();
+	std::vector<Uint8> pixels(size.x * size.y * 4, 0);
+	m_texture.update(&pixels[0]);
+
+	m_padding = padding;
+	clear();
+
+	return true;
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect TextureAtlas::add(const Image& image)
+{
+	Vector2u size = image.getSize();
+	if (size.x == 0 || size.y == 0)
+		return IntRect();
+
+	return add(image.getPixelsPtr(), size.x, size.y);
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect TextureAtlas::add(const Uint8* pixels, unsigned int width, unsigned int height)
+{
+	IntRect rect = reserve(width, height);
+
+	if (pixels && rect.width > 0)
+		m_texture.update(pixels, width, height, rect.left, rect.top);
+
+	return rect;
+}
+
+
+////////////////////////////////////////////////////////////
+IntRect TextureAtlas::reserve(unsigned int width, unsigned int height)
+{
+	if (width == 0 || height == 0 || m_skyline.empty())
+		return IntRect();
+
+	// Padding is kept on the left/top of each area, and against the atlas border
+	unsigned int paddedWidth = width + m_padding;
+	unsigned int paddedHeight = height + m_padding;
+
+	// Skyline bottom-left: lowest resting position, then narrowest segment
+	std::size_t bestIndex = m_skyline.size();
+	unsigned int bestY = 0;
+	unsigned int bestWidth = 0;
+	for (std::size_t i = 0; i < m_skyline.size(); ++i)
+	{
+		unsigned int y;
+		if (fit(i, paddedWidth, paddedHeight, y))
+		{
+			if (bestIndex == m_skyline.size() || y < bestY ||
+			    (y == bestY && m_skyline[i].width < bestWidth))
+			{
+				bestIndex = i;
+				bestY = y;
+				bestWidth = m_skyline[i].width;
+			}
+		}
+	}
+
+	if (bestIndex == m_skyline.size())
+		return IntRect();
+
+	// Insert the new segment on top of the placed area
+	Segment segment;
+	segment.x = m_skyline[bestIndex].x;
+	segment.y = bestY + paddedHeight;
+	segment.width = paddedWidth;
+	m_skyline.insert(m_skyline.begin() + bestIndex, segment);
+
+	// Shrink or remove the segments now covered by it
+	for (std::size_t i = bestIndex + 1; i < m_skyline.size(); )
+	{
+		Segment& current = m_skyline[i];
+		unsigned int right = segment.x + segment.width;
+		if (current.x >= right)
+			break;
+
+		unsigned int shrink = right - current.x;
+		if (current.width > shrink)
+		{
+			current.x += shrink;
+			current.width -= shrink;
+			break;
+		}
+		m_skyline.erase(m_skyline.begin() + i);
+	}
+
+	// Merge neighbouring segments at the same height
+	for (std::size_t i = 0; i + 1 < m_skyline.size(); )
+	{
+		if (m_skyline[i].y == m_skyline[i + 1].y)
+		{
+			m_skyline[i].width += m_skyline[i + 1].width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+		}
+		else
+			++i;
+	}
+
+	m_usedArea += paddedWidth * paddedHeight;
+
+	return IntRect(segment.x + m_padding, bestY + m_padding, width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureAtlas::clear()
+{
+	m_skyline.clear();
+	m_usedArea = 0;
+
+	Vector2u size = m_texture.getSize();
+	if (size.x > 0 && size.y > 0)
+	{
+		Segment segment;
+		segment.x = 0;
+		segment.y = 0;
+		segment.width = size.x;
+		m_skyline.push_back(segment);
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureAtlas::getTexture() const
+{
+	return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+Image TextureAtlas::copyToImage() const
+{
+	return m_texture.copyToImage();
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u TextureAtlas::getSize() const
+{
+	return m_texture.getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+float TextureAtlas::getOccupancy() const
+{
+	Vector2u size = m_texture.getSize();
+	if (size.x == 0 || size.y == 0)
+		return 0.f;
+
+	return static_cast<float>(m_usedArea) / (size.x * size.y);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureAtlas::fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const
+{
+	Vector2u size = m_texture.getSize();
+	if (m_skyline[index].x + width > size.x)
+		return false;
+
+	// The rectangle rests on the highest segment it spans
+	y = 0;
+	unsigned int remaining = width;
+	for (std::size_t i = index; remaining > 0; ++i)
+	{
+		if (i == m_skyline.size())
+			return false;
+		y = std::max(y, m_skyline[i].y);
+		if (y + height > size.y)
+			return false;
+		remaining -= std::min(remaining, m_skyline[i].width);
+	}
+
+	return true;
+}
+
+} // namespace cpp3ds
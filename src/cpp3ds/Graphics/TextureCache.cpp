@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    struct CacheState
+    {
+        CacheState() :
+        bound    (NULL),
+        budget   (0),
+        frame    (0),
+        hits     (0),
+        misses   (0),
+        evictions(0)
+        {
+        }
+
+        cpp3ds::Mutex                 mutex;
+        std::vector<cpp3ds::Texture*> textures;
+        const cpp3ds::Texture*        bound;
+        std::size_t                   budget;
+        cpp3ds::Uint32                frame;
+        cpp3ds::Uint64                hits;
+        cpp3ds::Uint64                misses;
+        cpp3ds::Uint64                evictions;
+    };
+
+    // Textures can be global too, make sure the state is
+    // constructed before and destroyed after all of them
+    CacheState& getState()
+    {
+        static CacheState state;
+        return state;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+void TextureCache::setBudget(std::size_t bytes)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    state.budget = bytes;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureCache::getBudget()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    return state.budget;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureCache::getMemoryUsage()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    std::size_t usage = 0;
+    for (std::vector<Texture*>::const_iterator it = state.textures.begin(); it != state.textures.end(); ++it)
+        usage += (*it)->getMemorySize();
+
+    return usage;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 TextureCache::getHitCount()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    return state.hits;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 TextureCache::getMissCount()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    return state.misses;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 TextureCache::getEvictionCount()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    return state.evictions;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::resetCounters()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    state.hits = 0;
+    state.misses = 0;
+    state.evictions = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureCache::trim(std::size_t bytes)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    // Sum up the usage, and collect the textures that weren't
+    // bound in this frame (the GPU may still read the others).
+    // Render targets don't bind the texture again if it's still
+    // bound from a previous frame, so the last one is kept too.
+    std::size_t usage = 0;
+    std::vector<std::pair<Uint32, Texture*> > candidates;
+    for (std::vector<Texture*>::const_iterator it = state.textures.begin(); it != state.textures.end(); ++it)
+    {
+        std::size_t size = (*it)->getMemorySize();
+        usage += size;
+        if (size > 0 && (*it)->m_lastUse != state.frame && *it != state.bound)
+            candidates.push_back(std::make_pair(state.frame - (*it)->m_lastUse, *it));
+    }
+
+    if (usage <= bytes)
+        return usage;
+
+    // Sort by age and evict the oldest first, the age stays right when the frame counter wraps
+    std::sort(candidates.begin(), candidates.end());
+    for (std::size_t i = candidates.size(); i > 0 && usage > bytes; --i)
+    {
+        Texture* texture = candidates[i - 1].second;
+        std::size_t size = texture->getMemorySize();
+        if (texture->evict())
+        {
+            usage -= size;
+            state.evictions++;
+        }
+    }
+
+    return usage;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 TextureCache::getAge(const Texture& texture)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    if (&texture == state.bound)
+        return 0;
+
+    return state.frame - texture.m_lastUse;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::nextFrame()
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    if (state.budget > 0)
+        trim(state.budget);
+
+    state.frame++;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::add(Texture& texture)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    texture.m_lastUse = state.frame;
+    state.textures.push_back(&texture);
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::remove(Texture& texture)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    std::vector<Texture*>::iterator it = std::find(state.textures.begin(), state.textures.end(), &texture);
+    if (it != state.textures.end())
+    {
+        *it = state.textures.back();
+        state.textures.pop_back();
+    }
+
+    if (state.bound == &texture)
+        state.bound = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::move(const Texture& from, const Texture& to)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    // The GPU may still read the data this frame, keep it protected
+    to.m_lastUse = from.m_lastUse;
+    if (state.bound == &from)
+        state.bound = &to;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureCache::use(const Texture& texture)
+{
+    CacheState& state = getState();
+    Lock lock(state.mutex);
+
+    texture.m_lastUse = state.frame;
+    state.bound = &texture;
+
+    if (texture.m_isEvicted)
+    {
+        state.misses++;
+
+        // Make room for the reloaded texture by evicting older ones
+        if (const_cast<Texture&>(texture).restore() && state.budget > 0)
+            trim(state.budget);
+    }
+    else if (texture.m_texture)
+    {
+        state.hits++;
+    }
+}
+
+} // namespace cpp3ds
@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureCompression.hpp>
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+    // ETC1 intensity modifiers, indexed by [table][pixel index]
+    const int modifiers[8][4] =
+    {
+        { 2,   8,  -2,   -8},
+        { 5,  17,  -5,  -17},
+        { 9,  29,  -9,  -29},
+        {13,  42, -13,  -42},
+        {18,  60, -18,  -60},
+        {24,  80, -24,  -80},
+        {33, 106, -33, -106},
+        {47, 183, -47, -183},
+    };
+
+    // Pixels of a 4x4 block, indexed by x * 4 + y like ETC1 pixel indices
+    typedef cpp3ds::Uint8 Block[16][4];
+
+    inline int clamp(int value)
+    {
+        return value < 0 ? 0 : (value > 255 ? 255 : value);
+    }
+
+    // Which half of the block a pixel belongs to: left/right
+    // halves normally, bottom/top ones when flipped
+    inline int getHalf(unsigned int pixel, bool flip)
+    {
+        return flip ? ((pixel & 3) >> 1) : (pixel >> 3);
+    }
+
+    // Pick the modifier table and pixel indices that best fit one half
+    // of the block around a base color. Returns the squared error.
+    cpp3ds::Uint32 fitHalf(const Block& block, int half, bool flip, const int base[3], unsigned int& table, cpp3ds::Uint32& indices)
+    {
+        cpp3ds::Uint32 bestError = 0xFFFFFFFF;
+
+        for (unsigned int t = 0; t < 8; ++t)
+        {
+            cpp3ds::Uint32 error = 0;
+            cpp3ds::Uint32 bits = 0;
+
+            for (unsigned int i = 0; i < 16 && error < bestError; ++i)
+            {
+                if (getHalf(i, flip) != half)
+                    continue;
+
+                cpp3ds::Uint32 bestPixelError = 0xFFFFFFFF;
+                unsigned int bestIndex = 0;
+                for (unsigned int index = 0; index < 4; ++index)
+                {
+                    int modifier = modifiers[t][index];
+                    int r = clamp(base[0] + modifier) - block[i][0];
+                    int g = clamp(base[1] + modifier) - block[i][1];
+                    int b = clamp(base[2] + modifier) - block[i][2];
+                    cpp3ds::Uint32 pixelError = r * r + g * g + b * b;
+                    if (pixelError < bestPixelError)
+                    {
+                        bestPixelError = pixelError;
+                        bestIndex = index;
+                    }
+                }
+
+                error += bestPixelError;
+                bits |= ((bestIndex >> 1) << (16 + i)) | ((bestIndex & 1) << i);
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                table = t;
+                indices = bits;
+            }
+        }
+
+        return bestError;
+    }
+
+    // Encode the colors of a block, trying both orientations in
+    // both individual (4+4 bits) and differential (5+3 bits) modes
+    cpp3ds::Uint64 encodeBlock(const Block& block)
+    {
+        cpp3ds::Uint32 bestError = 0xFFFFFFFF;
+        cpp3ds::Uint64 bestWord = 0;
+
+        for (int flip = 0; flip < 2; ++flip)
+        {
+            // Average color of each half
+            int sums[2][3] = {{0, 0, 0}, {0, 0, 0}};
+            for (unsigned int i = 0; i < 16; ++i)
+                for (unsigned int c = 0; c < 3; ++c)
+                    sums[getHalf(i, flip)][c] += block[i][c];
+
+            for (int differential = 0; differential < 2; ++differential)
+            {
+                int colors[2][3];
+                int bases[2][3];
+                bool valid = true;
+
+                for (unsigned int h = 0; h < 2; ++h)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        if (differential)
+                        {
+                            colors[h][c] = (sums[h][c] * 31 + 1020) / 2040;
+                            bases[h][c] = (colors[h][c] << 3) | (colors[h][c] >> 2);
+                        }
+                        else
+                        {
+                            colors[h][c] = (sums[h][c] * 15 + 1020) / 2040;
+                            bases[h][c] = colors[h][c] * 17;
+                        }
+                    }
+                }
+
+                if (differential)
+                {
+                    for (unsigned int c = 0; c < 3; ++c)
+                    {
+                        int delta = colors[1][c] - colors[0][c];
+                        valid = valid && (delta >= -4) && (delta <= 3);
+                    }
+                }
+
+                if (!valid)
+                    continue;
+
+                unsigned int tables[2];
+                cpp3ds::Uint32 indices[2];
+                cpp3ds::Uint32 error = fitHalf(block, 0, flip != 0, bases[0], tables[0], indices[0]);
+                if (error >= bestError)
+                    continue;
+                error += fitHalf(block, 1, flip != 0, bases[1], tables[1], indices[1]);
+                if (error >= bestError)
+                    continue;
+
+                cpp3ds::Uint32 high = (tables[0] << 5) | (tables[1] << 2) | (differential << 1) | flip;
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    unsigned int shift = 24 - c * 8;
+                    if (differential)
+                        high |= (colors[0][c] << (shift + 3)) | (((colors[1][c] - colors[0][c]) & 7) << shift);
+                    else
+                        high |= (colors[0][c] << (shift + 4)) | (colors[1][c] << shift);
+                }
+
+                bestError = error;
+                bestWord = (static_cast<cpp3ds::Uint64>(high) << 32) | indices[0] | indices[1];
+            }
+        }
+
+        return bestWord;
+    }
+
+    void decodeBlock(cpp3ds::Uint64 word, Block& block)
+    {
+        cpp3ds::Uint32 high = static_cast<cpp3ds::Uint32>(word >> 32);
+        cpp3ds::Uint32 low = static_cast<cpp3ds::Uint32>(word);
+        bool flip = (high & 1) != 0;
+        bool differential = (high & 2) != 0;
+        unsigned int tables[2] = {(high >> 5) & 7, (high >> 2) & 7};
+
+        int bases[2][3];
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            unsigned int shift = 24 - c * 8;
+            if (differential)
+            {
+                int first = (high >> (shift + 3)) & 0x1F;
+                int delta = (high >> shift) & 7;
+                int second = first + (delta >= 4 ? delta - 8 : delta);
+                bases[0][c] = (first << 3) | (first >> 2);
+                bases[1][c] = (second << 3) | (second >> 2);
+            }
+            else
+            {
+                bases[0][c] = ((high >> (shift + 4)) & 0xF) * 17;
+                bases[1][c] = ((high >> shift) & 0xF) * 17;
+            }
+        }
+
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            int half = getHalf(i, flip);
+            unsigned int index = (((low >> (16 + i)) & 1) << 1) | ((low >> i) & 1);
+            int modifier = modifiers[tables[half]][index];
+            for (unsigned int c = 0; c < 3; ++c)
+                block[i][c] = static_cast<cpp3ds::Uint8>(clamp(bases[half][c] + modifier));
+        }
+    }
+
+    // Location of the 4x4 block containing texel (x, y) of the texture,
+    // y counted from the bottom like texture rows
+    inline std::size_t getBlockOffset(unsigned int x, unsigned int y, unsigned int textureWidth, unsigned int blockSize)
+    {
+        std::size_t tile = (y / 8) * (textureWidth / 8) + x / 8;
+        unsigned int subBlock = ((x / 4) & 1) + 2 * ((y / 4) & 1);
+        return (tile * 4 + subBlock) * blockSize;
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+void compressEtc1(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                  unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, bool alpha)
+{
+    if (width == 0 || height == 0)
+        return;
+
+    unsigned int blockSize = alpha ? 16 : 8;
+
+    // Texture rows are numbered from the bottom
+    unsigned int bottom = textureHeight - y - height;
+    unsigned int top = textureHeight - y;
+    unsigned int right = x + width;
+
+    for (unsigned int blockY = bottom & ~3u; blockY < top; blockY += 4)
+    {
+        for (unsigned int blockX = x & ~3u; blockX < right; blockX += 4)
+        {
+            // Gather the block, clamping to the edges of the region
+            Block block;
+            Uint64 alphas = 0;
+            for (unsigned int i = 0; i < 16; ++i)
+            {
+                unsigned int row = blockY + (i & 3);
+                unsigned int column = blockX + (i >> 2);
+                row = std::min(std::max(row, bottom), top - 1);
+                column = std::min(std::max(column, x), right - 1);
+
+                const Uint8* pixel = pixels + (top - 1 - row) * pitch + (column - x) * 4;
+                std::memcpy(block[i], pixel, 4);
+                alphas |= static_cast<Uint64>((pixel[3] * 15 + 127) / 255) << (4 * i);
+            }
+
+            Uint8* destination = texture + getBlockOffset(blockX, blockY, textureWidth, blockSize);
+            if (alpha)
+            {
+                std::memcpy(destination, &alphas, 8);
+                destination += 8;
+            }
+
+            Uint64 word = encodeBlock(block);
+            std::memcpy(destination, &word, 8);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void decompressEtc1(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                    unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, bool alpha)
+{
+    unsigned int blockSize = alpha ? 16 : 8;
+
+    unsigned int bottom = textureHeight - y - height;
+    unsigned int top = textureHeight - y;
+    unsigned int right = x + width;
+
+    for (unsigned int blockY = bottom & ~3u; blockY < top; blockY += 4)
+    {
+        for (unsigned int blockX = x & ~3u; blockX < right; blockX += 4)
+        {
+            const Uint8* source = texture + getBlockOffset(blockX, blockY, textureWidth, blockSize);
+
+            Uint64 alphas = 0xFFFFFFFFFFFFFFFFull;
+            if (alpha)
+            {
+                std::memcpy(&alphas, source, 8);
+                source += 8;
+            }
+
+            Uint64 word;
+            std::memcpy(&word, source, 8);
+
+            Block block;
+            decodeBlock(word, block);
+
+            for (unsigned int i = 0; i < 16; ++i)
+            {
+                unsigned int row = blockY + (i & 3);
+                unsigned int column = blockX + (i >> 2);
+                if (row < bottom || row >= top || column < x || column >= right)
+                    continue;
+
+                Uint8* pixel = pixels + (top - 1 - row) * pitch + (column - x) * 4;
+                pixel[0] = block[i][0];
+                pixel[1] = block[i][1];
+                pixel[2] = block[i][2];
+                pixel[3] = static_cast<Uint8>(((alphas >> (4 * i)) & 0xF) * 17);
+            }
+        }
+    }
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
@@ -0,0 +1,800 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/Graphics/TextureTiling.hpp>
+#include <cpp3ds/System/InputStream.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+namespace
+{
+    const char             magic[4]       = {'C', 'T', 'E', 'X'};
+    const cpp3ds::Uint16   version        = 2;
+    const cpp3ds::Uint16   chunkAlignment = 512; // Sector size of the SD card
+    const unsigned int     maximumSize    = 1024;
+
+    bool isValidSize(unsigned int size)
+    {
+        return (size >= 8) && (size <= maximumSize) && ((size & (size - 1)) == 0);
+    }
+
+    std::size_t getLevelSize(const cpp3ds::priv::ContainerTexture& texture, unsigned int level)
+    {
+        cpp3ds::Texture::Format format = static_cast<cpp3ds::Texture::Format>(texture.format);
+        return (texture.width >> level) * (texture.height >> level) * cpp3ds::priv::getBitsPerPixel(format) / 8;
+    }
+
+    // Reads the data of a chunk through a small buffer
+    class ChunkReader
+    {
+    public :
+
+        ChunkReader(cpp3ds::InputStream& stream, std::size_t size) :
+        m_stream   (stream),
+        m_remaining(size),
+        m_position (0),
+        m_end      (0)
+        {
+        }
+
+        bool get(cpp3ds::Uint8& byte)
+        {
+            if ((m_position == m_end) && !fill())
+                return false;
+
+            byte = m_buffer[m_position++];
+            return true;
+        }
+
+        bool read(cpp3ds::Uint8* data, std::size_t count)
+        {
+            while (count > 0)
+            {
+                if ((m_position == m_end) && !fill())
+                    return false;
+
+                std::size_t available = std::min(count, m_end - m_position);
+                std::memcpy(data, m_buffer + m_position, available);
+                m_position += available;
+                data += available;
+                count -= available;
+            }
+
+            return true;
+        }
+
+        bool atEnd() const
+        {
+            return (m_position == m_end) && (m_remaining == 0);
+        }
+
+    private :
+
+        bool fill()
+        {
+            if (m_remaining == 0)
+                return false;
+
+            cpp3ds::Int64 count = static_cast<cpp3ds::Int64>(std::min(m_remaining, sizeof(m_buffer)));
+            if (m_stream.read(m_buffer, count) != count)
+            {
+                m_remaining = 0;
+                return false;
+            }
+
+            m_remaining -= static_cast<std::size_t>(count);
+            m_position = 0;
+            m_end = static_cast<std::size_t>(count);
+
+            return true;
+        }
+
+        cpp3ds::InputStream& m_stream;
+        std::size_t          m_remaining;
+        std::size_t          m_position;
+        std::size_t          m_end;
+        cpp3ds::Uint8        m_buffer[2048];
+    };
+
+    // Copy a match byte by byte, as it may overlap the bytes it writes
+    inline void copyMatch(cpp3ds::Uint8* output, std::size_t distance, std::size_t length)
+    {
+        const cpp3ds::Uint8* source = output - distance;
+        for (std::size_t i = 0; i < length; ++i)
+            output[i] = source[i];
+    }
+
+    bool decompressLz11(ChunkReader& reader, cpp3ds::Uint8* output, std::size_t outputSize)
+    {
+        cpp3ds::Uint8 header[4];
+        if (!reader.read(header, 4) || (header[0] != 0x11))
+            return false;
+
+        // Sizes that don't fit in 24 bits follow as 32 bits
+        std::size_t size = header[1] | (header[2] << 8) | (header[3] << 16);
+        if (size == 0)
+        {
+            if (!reader.read(header, 4))
+                return false;
+            size = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<std::size_t>(header[3]) << 24);
+        }
+        if (size != outputSize)
+            return false;
+
+        std::size_t written = 0;
+        while (written < size)
+        {
+            cpp3ds::Uint8 flags;
+            if (!reader.get(flags))
+                return false;
+
+            for (int bit = 7; (bit >= 0) && (written < size); --bit)
+            {
+                if (!(flags & (1 << bit)))
+                {
+                    if (!reader.get(output[written]))
+                        return false;
+                    ++written;
+                    continue;
+                }
+
+                // The top 4 bits of the first byte tell how the length is stored
+                cpp3ds::Uint8 bytes[4];
+                if (!reader.read(bytes, 2))
+                    return false;
+
+                std::size_t length, distance;
+                switch (bytes[0] >> 4)
+                {
+                    case 0:
+                        if (!reader.get(bytes[2]))
+                            return false;
+                        length   = (((bytes[0] & 0xF) << 4) | (bytes[1] >> 4)) + 0x11;
+                        distance = (((bytes[1] & 0xF) << 8) | bytes[2]) + 1;
+                        break;
+                    case 1:
+                        if (!reader.read(bytes + 2, 2))
+                            return false;
+                        length   = (((bytes[0] & 0xF) << 12) | (bytes[1] << 4) | (bytes[2] >> 4)) + 0x111;
+                        distance = (((bytes[2] & 0xF) << 8) | bytes[3]) + 1;
+                        break;
+                    default:
+                        length   = (bytes[0] >> 4) + 1;
+                        distance = (((bytes[0] & 0xF) << 8) | bytes[1]) + 1;
+                        break;
+                }
+
+                if ((distance > written) || (length > size - written))
+                    return false;
+
+                copyMatch(output + written, distance, length);
+                written += length;
+            }
+        }
+
+        return true;
+    }
+
+    bool readLz4Length(ChunkReader& reader, std::size_t& length)
+    {
+        cpp3ds::Uint8 byte;
+        do
+        {
+            if (!reader.get(byte))
+                return false;
+            length += byte;
+        }
+        while (byte == 255);
+
+        return true;
+    }
+
+    bool decompressLz4(ChunkReader& reader, cpp3ds::Uint8* output, std::size_t outputSize)
+    {
+        std::size_t written = 0;
+        cpp3ds::Uint8 token;
+        while (reader.get(token))
+        {
+            // Literals
+            std::size_t length = token >> 4;
+            if ((length == 15) && !readLz4Length(reader, length))
+                return false;
+            if ((length > outputSize - written) || !reader.read(output + written, length))
+                return false;
+            written += length;
+
+            // The last sequence has no match
+            if (reader.atEnd())
+                break;
+
+            // Match
+            cpp3ds::Uint8 offset[2];
+            if (!reader.read(offset, 2))
+                return false;
+            std::size_t distance = offset[0] | (offset[1] << 8);
+
+            length = token & 0xF;
+            if ((length == 15) && !readLz4Length(reader, length))
+                return false;
+            length += 4;
+
+            if ((distance == 0) || (distance > written) || (length > outputSize - written))
+                return false;
+
+            copyMatch(output + written, distance, length);
+            written += length;
+        }
+
+        return written == outputSize;
+    }
+
+    inline cpp3ds::Uint32 read32(const cpp3ds::Uint8* data)
+    {
+        cpp3ds::Uint32 value;
+        std::memcpy(&value, data, 4);
+        return value;
+    }
+
+    // Hash of the next bytes, to find earlier occurrences of them
+    inline cpp3ds::Uint32 hash(cpp3ds::Uint32 sequence)
+    {
+        return (sequence * 2654435761u) >> 20;
+    }
+
+    void writeLz4Length(std::vector<cpp3ds::Uint8>& output, std::size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            output.push_back(255);
+        output.push_back(static_cast<cpp3ds::Uint8>(length));
+    }
+
+    void writeLz4Literals(std::vector<cpp3ds::Uint8>& output, const cpp3ds::Uint8* literals, std::size_t count, cpp3ds::Uint8 matchLength)
+    {
+        output.push_back(static_cast<cpp3ds::Uint8>((std::min<std::size_t>(count, 15) << 4) | matchLength));
+        if (count >= 15)
+            writeLz4Length(output, count - 15);
+        output.insert(output.end(), literals, literals + count);
+    }
+
+    template <typename T>
+    void append(std::vector<cpp3ds::Uint8>& data, const T& value)
+    {
+        const cpp3ds::Uint8* bytes = reinterpret_cast<const cpp3ds::Uint8*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+TextureContainer::TextureContainer() :
+m_stream(NULL)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::openFromFile(const std::string& filename)
+{
+    m_stream = NULL;
+
+    if (!m_file.open(filename))
+    {
+        err() << "Failed to open texture container \"" << filename << "\"" << std::endl;
+        return false;
+    }
+
+    return openFromStream(m_file);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::openFromStream(InputStream& stream)
+{
+    m_stream = NULL;
+    m_textures.clear();
+    m_chunks.clear();
+    m_rects.clear();
+
+    ContainerHeader header;
+    if ((stream.seek(0) != 0) || (stream.read(&header, sizeof(header)) != sizeof(header)) ||
+        (std::memcmp(header.magic, magic, 4) != 0))
+    {
+        err() << "Failed to open texture container, invalid header" << std::endl;
+        return false;
+    }
+    if (header.version != version)
+    {
+        err() << "Failed to open texture container, unsupported version " << header.version << std::endl;
+        return false;
+    }
+
+    // Read the tables
+    m_textures.resize(header.textureCount);
+    m_chunks.resize(header.chunkCount);
+    m_rects.resize(header.rectCount);
+
+    Int64 texturesSize = m_textures.size() * sizeof(ContainerTexture);
+    Int64 chunksSize   = m_chunks.size() * sizeof(ContainerChunk);
+    Int64 rectsSize    = m_rects.size() * sizeof(ContainerRect);
+    if ((texturesSize && (stream.read(&m_textures[0], texturesSize) != texturesSize)) ||
+        (chunksSize && (stream.read(&m_chunks[0], chunksSize) != chunksSize)) ||
+        (rectsSize && (stream.read(&m_rects[0], rectsSize) != rectsSize)))
+    {
+        err() << "Failed to open texture container, truncated tables" << std::endl;
+        return false;
+    }
+
+    // Check everything once, so that reading can trust the tables
+    Int64 fileSize = stream.getSize();
+    for (std::vector<ContainerTexture>::const_iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+    {
+        bool valid = (it->format < Texture::Compressed) && isValidSize(it->width) && isValidSize(it->height) &&
+                     (it->originalWidth <= it->width) && (it->originalHeight <= it->height) &&
+                     ((it->levelCount == 1) || (it->levelCount == getMipmapLevelCount(it->width, it->height))) &&
+                     (it->firstChunk + it->levelCount <= m_chunks.size());
+
+        for (unsigned int level = 0; valid && (level < it->levelCount); ++level)
+        {
+            const ContainerChunk& chunk = m_chunks[it->firstChunk + level];
+            valid = (chunk.rawSize == getLevelSize(*it, level)) && (chunk.compression <= ChunkLz4) &&
+                    (static_cast<Int64>(chunk.offset) + chunk.size <= fileSize);
+        }
+
+        if (!valid)
+        {
+            err() << "Failed to open texture container, invalid texture " << (it - m_textures.begin()) << std::endl;
+            return false;
+        }
+    }
+    for (std::vector<ContainerRect>::const_iterator it = m_rects.begin(); it != m_rects.end(); ++it)
+    {
+        if (it->texture >= m_textures.size())
+        {
+            err() << "Failed to open texture container, invalid rect " << (it - m_rects.begin()) << std::endl;
+            return false;
+        }
+    }
+
+    m_stream = &stream;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::isContainer(InputStream& stream)
+{
+    char start[4];
+    bool result = (stream.seek(0) == 0) && (stream.read(start, 4) == 4) && (std::memcmp(start, magic, 4) == 0);
+    stream.seek(0);
+
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureContainer::getTextureCount() const
+{
+    return m_textures.size();
+}
+
+
+////////////////////////////////////////////////////////////
+const ContainerTexture& TextureContainer::getTexture(std::size_t index) const
+{
+    return m_textures[index];
+}
+
+
+////////////////////////////////////////////////////////////
+const ContainerChunk& TextureContainer::getChunk(std::size_t texture, unsigned int level) const
+{
+    return m_chunks[m_textures[texture].firstChunk + level];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureContainer::getRectCount() const
+{
+    return m_rects.size();
+}
+
+
+////////////////////////////////////////////////////////////
+const ContainerRect& TextureContainer::getRect(std::size_t index) const
+{
+    return m_rects[index];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureContainer::getDataSize(std::size_t texture) const
+{
+    std::size_t size = 0;
+    for (unsigned int level = 0; level < m_textures[texture].levelCount; ++level)
+        size += getChunk(texture, level).rawSize;
+
+    return size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainer::readTexture(std::size_t texture, void* data)
+{
+    if (!m_stream || (texture >= m_textures.size()))
+        return false;
+
+    Uint8* output = static_cast<Uint8*>(data);
+    for (unsigned int level = 0; level < m_textures[texture].levelCount; ++level)
+    {
+        const ContainerChunk& chunk = getChunk(texture, level);
+        if ((m_stream->seek(chunk.offset) != chunk.offset) ||
+            !decompressChunk(*m_stream, chunk.size, static_cast<ChunkCompression>(chunk.compression), output, chunk.rawSize))
+        {
+            err() << "Failed to read texture " << texture << " of container, corrupt level " << level << std::endl;
+            return false;
+        }
+
+        output += chunk.rawSize;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+int TextureContainerWriter::addTexture(Texture::Format format, unsigned int width, unsigned int height,
+                                       unsigned int originalWidth, unsigned int originalHeight,
+                                       unsigned int left, unsigned int top)
+{
+    if ((format >= Texture::Compressed) || !isValidSize(width) || !isValidSize(height) ||
+        (originalWidth > width) || (originalHeight > height) || (left > 0xFFFF) || (top > 0xFFFF))
+    {
+        err() << "Failed to add texture to container, invalid parameters" << std::endl;
+        return -1;
+    }
+
+    ContainerTexture texture;
+    texture.format         = static_cast<Uint16>(format);
+    texture.width          = static_cast<Uint16>(width);
+    texture.height         = static_cast<Uint16>(height);
+    texture.originalWidth  = static_cast<Uint16>(originalWidth);
+    texture.originalHeight = static_cast<Uint16>(originalHeight);
+    texture.levelCount     = 0;
+    texture.left           = static_cast<Uint16>(left);
+    texture.top            = static_cast<Uint16>(top);
+    texture.firstChunk     = 0;
+
+    m_textures.push_back(texture);
+    m_levels.push_back(std::vector<Level>());
+
+    return static_cast<int>(m_textures.size() - 1);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainerWriter::addLevel(std::size_t texture, const void* data, std::size_t size, ChunkCompression compression)
+{
+    ContainerTexture& info = m_textures[texture];
+    if ((info.levelCount >= getMipmapLevelCount(info.width, info.height)) || (size != getLevelSize(info, info.levelCount)))
+    {
+        err() << "Failed to add level " << info.levelCount << " to texture " << texture << " of container, invalid size" << std::endl;
+        return false;
+    }
+
+    Level level;
+    level.compression = compression;
+    level.rawSize     = size;
+
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    if (compression == ChunkLz11)
+        compressLz11(bytes, size, level.data);
+    else if (compression == ChunkLz4)
+        compressLz4(bytes, size, level.data);
+
+    // Data that doesn't compress is better read straight into texture memory
+    if ((compression == ChunkRaw) || (level.data.size() >= size))
+    {
+        level.compression = ChunkRaw;
+        level.data.assign(bytes, bytes + size);
+    }
+
+    m_levels[texture].push_back(level);
+    info.levelCount++;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureContainerWriter::addRect(std::size_t texture, const IntRect& rectangle)
+{
+    ContainerRect rect;
+    rect.texture = static_cast<Uint16>(texture);
+    rect.left    = static_cast<Uint16>(rectangle.left);
+    rect.top     = static_cast<Uint16>(rectangle.top);
+    rect.width   = static_cast<Uint16>(rectangle.width);
+    rect.height  = static_cast<Uint16>(rectangle.height);
+    rect.padding = 0;
+
+    m_rects.push_back(rect);
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainerWriter::save(std::vector<Uint8>& data) const
+{
+    data.clear();
+
+    ContainerHeader header;
+    std::memcpy(header.magic, magic, 4);
+    header.version      = version;
+    header.textureCount = static_cast<Uint16>(m_textures.size());
+    header.rectCount    = static_cast<Uint16>(m_rects.size());
+    header.alignment    = chunkAlignment;
+    header.chunkCount   = 0;
+
+    // Number the chunks, and check that the textures are complete
+    std::vector<ContainerTexture> textures = m_textures;
+    for (std::size_t i = 0; i < textures.size(); ++i)
+    {
+        if ((textures[i].levelCount != 1) && (textures[i].levelCount != getMipmapLevelCount(textures[i].width, textures[i].height)))
+        {
+            err() << "Failed to save texture container, texture " << i << " has " << textures[i].levelCount << " levels" << std::endl;
+            return false;
+        }
+
+        textures[i].firstChunk = header.chunkCount;
+        header.chunkCount += textures[i].levelCount;
+    }
+
+    // Place the chunk data after the tables, aligned
+    std::size_t offset = sizeof(ContainerHeader) + textures.size() * sizeof(ContainerTexture) +
+                         header.chunkCount * sizeof(ContainerChunk) + m_rects.size() * sizeof(ContainerRect);
+    std::vector<ContainerChunk> chunks;
+    for (std::size_t i = 0; i < m_levels.size(); ++i)
+    {
+        for (std::size_t j = 0; j < m_levels[i].size(); ++j)
+        {
+            const Level& level = m_levels[i][j];
+            offset = (offset + chunkAlignment - 1) / chunkAlignment * chunkAlignment;
+
+            ContainerChunk chunk;
+            chunk.offset      = static_cast<Uint32>(offset);
+            chunk.size        = static_cast<Uint32>(level.data.size());
+            chunk.rawSize     = static_cast<Uint32>(level.rawSize);
+            chunk.compression = level.compression;
+            chunks.push_back(chunk);
+
+            offset += level.data.size();
+        }
+    }
+
+    append(data, header);
+    for (std::size_t i = 0; i < textures.size(); ++i)
+        append(data, textures[i]);
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+        append(data, chunks[i]);
+    for (std::size_t i = 0; i < m_rects.size(); ++i)
+        append(data, m_rects[i]);
+
+    std::size_t index = 0;
+    for (std::size_t i = 0; i < m_levels.size(); ++i)
+    {
+        for (std::size_t j = 0; j < m_levels[i].size(); ++j)
+        {
+            data.resize(chunks[index++].offset, 0);
+            data.insert(data.end(), m_levels[i][j].data.begin(), m_levels[i][j].data.end());
+        }
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureContainerWriter::saveToFile(const std::string& filename) const
+{
+    std::vector<Uint8> data;
+    if (!save(data))
+        return false;
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    bool success = file && (std::fwrite(&data[0], 1, data.size(), file) == data.size());
+    if (file)
+        success = (std::fclose(file) == 0) && success;
+
+    if (!success)
+        err() << "Failed to save texture container \"" << filename << "\"" << std::endl;
+
+    return success;
+}
+
+
+////////////////////////////////////////////////////////////
+void compressLz11(const Uint8* data, std::size_t size, std::vector<Uint8>& output)
+{
+    output.clear();
+
+    // Sizes that don't fit in 24 bits (or are 0) follow as 32 bits
+    output.push_back(0x11);
+    if ((size > 0) && (size <= 0xFFFFFF))
+    {
+        output.push_back(static_cast<Uint8>(size));
+        output.push_back(static_cast<Uint8>(size >> 8));
+        output.push_back(static_cast<Uint8>(size >> 16));
+    }
+    else
+    {
+        output.insert(output.end(), 3, 0);
+        for (int i = 0; i < 4; ++i)
+            output.push_back(static_cast<Uint8>(size >> (i * 8)));
+    }
+
+    // Last position + 1 of each hashed 3 bytes sequence
+    std::vector<Uint32> table(4096, 0);
+
+    std::size_t position = 0;
+    while (position < size)
+    {
+        std::size_t flags = output.size();
+        output.push_back(0);
+
+        for (int bit = 7; (bit >= 0) && (position < size); --bit)
+        {
+            // Find the last occurrence of the next bytes in the 4KB window
+            std::size_t length = 0;
+            std::size_t distance = 0;
+            if (position + 3 <= size)
+            {
+                Uint32 key = hash(data[position] | (data[position + 1] << 8) | (data[position + 2] << 16));
+                std::size_t candidate = table[key];
+                table[key] = static_cast<Uint32>(position + 1);
+
+                if (candidate && (position - (candidate - 1) <= 0x1000))
+                {
+                    candidate--;
+                    std::size_t maximum = std::min<std::size_t>(0x10110, size - position);
+                    while ((length < maximum) && (data[candidate + length] == data[position + length]))
+                        ++length;
+                    distance = position - candidate;
+                }
+            }
+
+            if (length < 3)
+            {
+                output.push_back(data[position++]);
+                continue;
+            }
+
+            output[flags] |= 1 << bit;
+            std::size_t d = distance - 1;
+            if (length <= 0x10)
+            {
+                output.push_back(static_cast<Uint8>(((length - 1) << 4) | (d >> 8)));
+            }
+            else if (length <= 0x110)
+            {
+                std::size_t l = length - 0x11;
+                output.push_back(static_cast<Uint8>(l >> 4));
+                output.push_back(static_cast<Uint8>(((l & 0xF) << 4) | (d >> 8)));
+            }
+            else
+            {
+                std::size_t l = length - 0x111;
+                output.push_back(static_cast<Uint8>(0x10 | (l >> 12)));
+                output.push_back(static_cast<Uint8>(l >> 4));
+                output.push_back(static_cast<Uint8>(((l & 0xF) << 4) | (d >> 8)));
+            }
+            output.push_back(static_cast<Uint8>(d));
+
+            // Remember the positions inside the match too
+            for (std::size_t end = position + length; ++position < end; )
+                if (position + 3 <= size)
+                    table[hash(data[position] | (data[position + 1] << 8) | (data[position + 2] << 16))] = static_cast<Uint32>(position + 1);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void compressLz4(const Uint8* data, std::size_t size, std::vector<Uint8>& output)
+{
+    output.clear();
+
+    // Last position + 1 of each hashed 4 bytes sequence
+    std::vector<Uint32> table(4096, 0);
+
+    // Decoders expect the last match to start 12 bytes before the
+    // end of the block, and the last 5 bytes to be literals
+    std::size_t anchor = 0;
+    std::size_t position = 0;
+    std::size_t limit = (size > 12) ? size - 12 : 0;
+    while (position < limit)
+    {
+        Uint32 sequence = read32(data + position);
+        Uint32 key = hash(sequence);
+        std::size_t candidate = table[key];
+        table[key] = static_cast<Uint32>(position + 1);
+
+        if (!candidate || (position - (candidate - 1) > 0xFFFF) || (read32(data + candidate - 1) != sequence))
+        {
+            ++position;
+            continue;
+        }
+        candidate--;
+
+        std::size_t length = 4;
+        while ((position + length < size - 5) && (data[candidate + length] == data[position + length]))
+            ++length;
+
+        std::size_t matchLength = length - 4;
+        writeLz4Literals(output, data + anchor, position - anchor, static_cast<Uint8>(std::min<std::size_t>(matchLength, 15)));
+        output.push_back(static_cast<Uint8>(position - candidate));
+        output.push_back(static_cast<Uint8>((position - candidate) >> 8));
+        if (matchLength >= 15)
+            writeLz4Length(output, matchLength - 15);
+
+        // Remember the positions inside the match too
+        for (std::size_t end = position + length; ++position < end; )
+            if (position < limit)
+                table[hash(read32(data + position))] = static_cast<Uint32>(position + 1);
+        anchor = position;
+    }
+
+    writeLz4Literals(output, data + anchor, size - anchor, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool decompressChunk(InputStream& stream, std::size_t size, ChunkCompression compression, Uint8* output, std::size_t outputSize)
+{
+    if (compression == ChunkRaw)
+        return (size == outputSize) && (stream.read(output, static_cast<Int64>(size)) == static_cast<Int64>(size));
+
+    ChunkReader reader(stream, size);
+    if (compression == ChunkLz11)
+        return decompressLz11(reader, output, outputSize);
+    else if (compression == ChunkLz4)
+        return decompressLz4(reader, output, outputSize);
+
+    return false;
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
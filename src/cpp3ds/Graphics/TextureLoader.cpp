@@ -0,0 +1,466 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureLoader.hpp>
+#include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/System/Err.hpp>
+#include <cpp3ds/System/Mutex.hpp>
+#include <cpp3ds/System/Lock.hpp>
+#include <cpp3ds/System/Sleep.hpp>
+#include <cpp3ds/System/Thread.hpp>
+#include <list>
+#include <vector>
+
+
+namespace
+{
+    struct Job
+    {
+        enum State
+        {
+            Queued,   ///< Waiting for the loader thread
+            Decoding, ///< Being decoded by the loader thread
+            Decoded,  ///< Ready to be finished by the render thread
+            Failed    ///< The file couldn't be loaded
+        };
+
+        cpp3ds::Texture*       texture;
+        cpp3ds::TextureLoader* group;
+        std::string            filename;
+        cpp3ds::IntRect        area;
+        unsigned int           index;
+        bool                   preprocessed;
+        cpp3ds::Image          image;
+        const cpp3ds::Uint8*   pixels;
+        unsigned int           pitch;
+        State                  state;
+    };
+
+    struct LoaderState
+    {
+        LoaderState() :
+        thread          (NULL),
+        running         (false),
+        placeholderColor(128, 128, 128)
+        {
+        }
+
+        ~LoaderState()
+        {
+            if (thread)
+            {
+                thread->wait();
+                delete thread;
+            }
+        }
+
+        cpp3ds::Mutex   mutex;
+        std::list<Job>  jobs;
+        cpp3ds::Thread* thread;
+        bool            running;
+        cpp3ds::Texture placeholder;
+        cpp3ds::Color   placeholderColor;
+    };
+
+    // Constructed on first use, textures waiting for a load may be global
+    LoaderState& getState()
+    {
+        static LoaderState state;
+        return state;
+    }
+}
+
+
+namespace cpp3ds
+{
+////////////////////////////////////////////////////////////
+TextureLoader::TextureLoader() :
+m_failures(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+TextureLoader::~TextureLoader()
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    for (std::list<Job>::iterator it = state.jobs.begin(); it != state.jobs.end(); ++it)
+        if (it->group == this)
+            it->group = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureLoader::loadFromFile(Texture& texture, const std::string& filename, const IntRect& area, Texture::Format format)
+{
+    return load(texture, filename, area, format, this);
+}
+
+
+#ifndef EMULATION
+////////////////////////////////////////////////////////////
+bool TextureLoader::loadFromPreprocessedFile(Texture& texture, const std::string& filename, unsigned int index)
+{
+    return loadPreprocessed(texture, filename, index, this);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureLoader::getPendingCount() const
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    std::size_t count = 0;
+    for (std::list<Job>::const_iterator it = state.jobs.begin(); it != state.jobs.end(); ++it)
+        if (it->group == this)
+            count++;
+
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t TextureLoader::getFailureCount() const
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    return m_failures;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureLoader::wait()
+{
+    for (;;)
+    {
+        update();
+        if (getPendingCount() == 0)
+            break;
+        sleep(milliseconds(1));
+    }
+
+    return getFailureCount() == 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::update()
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    std::list<Job>::iterator it = state.jobs.begin();
+    while (it != state.jobs.end())
+    {
+        if (it->state != Job::Decoded && it->state != Job::Failed)
+        {
+            ++it;
+            continue;
+        }
+
+        Texture& texture = *it->texture;
+        texture.m_isLoading = false;
+
+        if (it->state == Job::Decoded)
+        {
+            texture.finishLoad(it->pixels, it->pitch);
+
+            // The texture can be evicted and reloaded like a synchronous one
+            texture.m_sourceFile     = it->filename;
+            texture.m_sourceArea     = it->area;
+            texture.m_sourceIndex    = it->index;
+            texture.m_isPreprocessed = it->preprocessed;
+        }
+        else
+        {
+            // Don't leave uninitialized memory on screen
+            std::vector<Uint8> pixels(texture.m_size.x * texture.m_size.y * 4, 0);
+            texture.update(&pixels[0]);
+
+            if (it->group)
+                it->group->m_failures++;
+        }
+
+        it = state.jobs.erase(it);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::setPlaceholderColor(const Color& color)
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    state.placeholderColor = color;
+    if (state.placeholder.getSize().x > 0)
+    {
+        std::vector<Color> pixels(8 * 8, color);
+        state.placeholder.update(reinterpret_cast<const Uint8*>(&pixels[0]));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool TextureLoader::load(Texture& texture, const std::string& filename, const IntRect& area, Texture::Format format, TextureLoader* group)
+{
+    // Only the header is read here, to give the texture its final size right away
+    Vector2u size;
+    if (!priv::ImageLoader::getInstance().loadImageSizeFromFile(filename, size))
+        return false;
+
+    // The area is clamped like the worker thread's decode will do
+    IntRect rectangle = priv::ImageLoader::clampArea(area, size);
+    if ((rectangle.width <= 0) || (rectangle.height <= 0))
+    {
+        err() << "Failed to load texture \"" << filename << "\". Reason : Region is outside the image" << std::endl;
+        return false;
+    }
+
+    if (!texture.create(rectangle.width, rectangle.height, format))
+        return false;
+
+    start(texture, filename, area, 0, false, group);
+
+    return true;
+}
+
+
+#ifndef EMULATION
+////////////////////////////////////////////////////////////
+bool TextureLoader::loadPreprocessed(Texture& texture, const std::string& filename, unsigned int index, TextureLoader* group)
+{
+    // Only the tables are read here, to give the texture its final size and format right away
+    priv::TextureContainer container;
+    if (!container.openFromFile(filename))
+        return false;
+
+    if (index >= container.getTextureCount())
+    {
+        err() << "Failed to load texture " << index << " of \"" << filename << "\", it has "
+              << container.getTextureCount() << " textures" << std::endl;
+        return false;
+    }
+
+    if (!texture.createPreprocessed(container.getTexture(index)))
+        return false;
+
+    start(texture, filename, IntRect(), index, true, group);
+
+    return true;
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::start(Texture& texture, const std::string& filename, const IntRect& area, unsigned int index, bool preprocessed, TextureLoader* group)
+{
+    LoaderState& state = getState();
+    Lock lock(state.mutex);
+
+    if (state.placeholder.getSize().x == 0)
+    {
+        std::vector<Color> pixels(8 * 8, state.placeholderColor);
+        state.placeholder.create(8, 8);
+        state.placeholder.update(reinterpret_cast<const Uint8*>(&pixels[0]));
+    }
+
+    Job job;
+    job.texture      = &texture;
+    job.group        = group;
+    job.filename     = filename;
+    job.area         = area;
+    job.index        = index;
+    job.preprocessed = preprocessed;
+    job.pixels       = NULL;
+    job.pitch        = 0;
+    job.state        = Job::Queued;
+    state.jobs.push_back(job);
+
+    texture.m_isLoading = true;
+
+    // The thread stops when the queue is empty, start it again if needed
+    if (!state.running)
+    {
+        if (!state.thread)
+        {
+            state.thread = new Thread(&TextureLoader::run);
+            state.thread->setStackSize(64 * 1024);
+        }
+
+        state.running = true;
+        state.thread->launch();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::cancel(Texture& texture)
+{
+    LoaderState& state = getState();
+
+    for (;;)
+    {
+        {
+            Lock lock(state.mutex);
+
+            std::list<Job>::iterator it = state.jobs.begin();
+            while (it != state.jobs.end() && it->texture != &texture)
+                ++it;
+
+            // The loader thread writes into the texture while decoding, wait for it
+            if (it == state.jobs.end() || it->state != Job::Decoding)
+            {
+                if (it != state.jobs.end())
+                    state.jobs.erase(it);
+
+                texture.m_isLoading = false;
+                return;
+            }
+        }
+
+        sleep(milliseconds(1));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::move(Texture& from, Texture& to)
+{
+    LoaderState& state = getState();
+
+    for (;;)
+    {
+        {
+            Lock lock(state.mutex);
+
+            std::list<Job>::iterator it = state.jobs.begin();
+            while (it != state.jobs.end() && it->texture != &from)
+                ++it;
+
+            // The loader thread writes into the texture while decoding, wait for it
+            if (it == state.jobs.end() || it->state != Job::Decoding)
+            {
+                if (it != state.jobs.end())
+                    it->texture = &to;
+
+                to.moveFrom(from);
+                return;
+            }
+        }
+
+        sleep(milliseconds(1));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& TextureLoader::getPlaceholder()
+{
+    return getState().placeholder;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextureLoader::run()
+{
+    LoaderState& state = getState();
+
+    for (;;)
+    {
+        Job* job = NULL;
+        {
+            Lock lock(state.mutex);
+
+            for (std::list<Job>::iterator it = state.jobs.begin(); it != state.jobs.end(); ++it)
+            {
+                if (it->state == Job::Queued)
+                {
+                    job = &*it;
+                    break;
+                }
+            }
+
+            if (!job)
+            {
+                state.running = false;
+                return;
+            }
+
+            job->state = Job::Decoding;
+        }
+
+        // The job can't be removed while decoding, no need to lock
+        bool success;
+#ifndef EMULATION
+        if (job->preprocessed)
+        {
+            // The levels are read straight into the texture memory.
+            // The file may have changed since its tables were read.
+            Texture& texture = *job->texture;
+            priv::TextureContainer container;
+            success = container.openFromFile(job->filename) && (job->index < container.getTextureCount()) &&
+                      (container.getDataSize(job->index) == texture.getMemorySize()) &&
+                      container.readTexture(job->index, texture.m_texture->data);
+
+            Lock lock(state.mutex);
+            job->state = success ? Job::Decoded : Job::Failed;
+            continue;
+        }
+#endif
+
+        // Only the area is decoded, the tiles of a BigTexture for example
+        success = job->image.loadFromFile(job->filename, job->area);
+        if (success)
+        {
+            Texture& texture = *job->texture;
+
+            // The file may have changed since its size was read
+            success = (job->image.getSize() == texture.m_size);
+            if (success)
+            {
+                job->pitch = job->image.getSize().x * 4;
+                job->pixels = job->image.getPixelsPtr();
+                texture.prepareLoad(job->pixels, job->pitch);
+            }
+        }
+
+        Lock lock(state.mutex);
+        job->state = success ? Job::Decoded : Job::Failed;
+    }
+}
+
+} // namespace cpp3ds
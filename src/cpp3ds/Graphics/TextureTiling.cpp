@@ -0,0 +1,582 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2014 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <cpp3ds/Graphics/TextureTiling.hpp>
+#include <cpp3ds/Graphics/TextureCompression.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+    // Offset of each pixel inside an 8x8 tile (Z-order), indexed by [y][x].
+    // Pixels come in horizontal pairs: [y][2n + 1] is always [y][2n] + 1.
+    const cpp3ds::Uint8 tileOffsets[8][8] =
+    {
+        { 0,  1,  4,  5, 16, 17, 20, 21},
+        { 2,  3,  6,  7, 18, 19, 22, 23},
+        { 8,  9, 12, 13, 24, 25, 28, 29},
+        {10, 11, 14, 15, 26, 27, 30, 31},
+        {32, 33, 36, 37, 48, 49, 52, 53},
+        {34, 35, 38, 39, 50, 51, 54, 55},
+        {40, 41, 44, 45, 56, 57, 60, 61},
+        {42, 43, 46, 47, 58, 59, 62, 63},
+    };
+
+    // Pixel policies used by the tiling kernels. Each one knows the
+    // size of a pixel on both sides and how to store (image to texture)
+    // and load (texture to image) one pixel or two adjacent pixels.
+
+    // Raw pixels of the same size on both sides, 24 and 32 bits
+    // ones have their bytes reversed (the conversion is symmetric)
+    template <unsigned int Bytes>
+    struct Raw;
+
+    template <>
+    struct Raw<4>
+    {
+        enum {ImageBytes = 4, TextureBytes = 4};
+
+        static inline void store(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint32 pixel;
+            std::memcpy(&pixel, src, 4);
+            pixel = __builtin_bswap32(pixel);
+            std::memcpy(dst, &pixel, 4);
+        }
+
+        static inline void storePair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint32 pixels[2];
+            std::memcpy(pixels, src, 8);
+            pixels[0] = __builtin_bswap32(pixels[0]);
+            pixels[1] = __builtin_bswap32(pixels[1]);
+            std::memcpy(dst, pixels, 8);
+        }
+
+        static inline void load(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)     {store(dst, src);}
+        static inline void loadPair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src) {storePair(dst, src);}
+    };
+
+    template <>
+    struct Raw<3>
+    {
+        enum {ImageBytes = 3, TextureBytes = 3};
+
+        static inline void store(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint8 first = src[0];
+            dst[1] = src[1];
+            dst[0] = src[2];
+            dst[2] = first;
+        }
+
+        static inline void storePair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            store(dst, src);
+            store(dst + 3, src + 3);
+        }
+
+        static inline void load(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)     {store(dst, src);}
+        static inline void loadPair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src) {storePair(dst, src);}
+    };
+
+    template <unsigned int Bytes>
+    struct Raw
+    {
+        enum {ImageBytes = Bytes, TextureBytes = Bytes};
+
+        static inline void store(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)     {std::memcpy(dst, src, Bytes);}
+        static inline void storePair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src) {std::memcpy(dst, src, 2 * Bytes);}
+        static inline void load(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)      {std::memcpy(dst, src, Bytes);}
+        static inline void loadPair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)  {std::memcpy(dst, src, 2 * Bytes);}
+    };
+
+    // Channel quantization, rounded to nearest
+    inline cpp3ds::Uint32 reduce(cpp3ds::Uint8 value, cpp3ds::Uint32 max)
+    {
+        return (value * max + 127) / 255;
+    }
+
+    // 16 bits codecs, from/to RGBA pixels
+    struct Rgb565
+    {
+        static inline cpp3ds::Uint16 encode(const cpp3ds::Uint8* p)
+        {
+            return static_cast<cpp3ds::Uint16>((reduce(p[0], 31) << 11) | (reduce(p[1], 63) << 5) | reduce(p[2], 31));
+        }
+
+        static inline void decode(cpp3ds::Uint16 v, cpp3ds::Uint8* p)
+        {
+            cpp3ds::Uint8 r = v >> 11, g = (v >> 5) & 0x3F, b = v & 0x1F;
+            p[0] = (r << 3) | (r >> 2);
+            p[1] = (g << 2) | (g >> 4);
+            p[2] = (b << 3) | (b >> 2);
+            p[3] = 255;
+        }
+    };
+
+    struct Rgba5551
+    {
+        static inline cpp3ds::Uint16 encode(const cpp3ds::Uint8* p)
+        {
+            return static_cast<cpp3ds::Uint16>((reduce(p[0], 31) << 11) | (reduce(p[1], 31) << 6) | (reduce(p[2], 31) << 1) | (p[3] >> 7));
+        }
+
+        static inline void decode(cpp3ds::Uint16 v, cpp3ds::Uint8* p)
+        {
+            cpp3ds::Uint8 r = v >> 11, g = (v >> 6) & 0x1F, b = (v >> 1) & 0x1F;
+            p[0] = (r << 3) | (r >> 2);
+            p[1] = (g << 3) | (g >> 2);
+            p[2] = (b << 3) | (b >> 2);
+            p[3] = (v & 1) ? 255 : 0;
+        }
+    };
+
+    struct Rgba4
+    {
+        static inline cpp3ds::Uint16 encode(const cpp3ds::Uint8* p)
+        {
+            return static_cast<cpp3ds::Uint16>((reduce(p[0], 15) << 12) | (reduce(p[1], 15) << 8) | (reduce(p[2], 15) << 4) | reduce(p[3], 15));
+        }
+
+        static inline void decode(cpp3ds::Uint16 v, cpp3ds::Uint8* p)
+        {
+            p[0] = (v >> 12) * 17;
+            p[1] = ((v >> 8) & 0xF) * 17;
+            p[2] = ((v >> 4) & 0xF) * 17;
+            p[3] = (v & 0xF) * 17;
+        }
+    };
+
+    struct La8
+    {
+        static inline cpp3ds::Uint16 encode(const cpp3ds::Uint8* p)
+        {
+            cpp3ds::Uint32 luminance = (p[0] * 77 + p[1] * 150 + p[2] * 29 + 128) >> 8;
+            return static_cast<cpp3ds::Uint16>((luminance << 8) | p[3]);
+        }
+
+        static inline void decode(cpp3ds::Uint16 v, cpp3ds::Uint8* p)
+        {
+            p[0] = p[1] = p[2] = v >> 8;
+            p[3] = v & 0xFF;
+        }
+    };
+
+    template <typename Codec>
+    struct Packed16
+    {
+        enum {ImageBytes = 4, TextureBytes = 2};
+
+        static inline void store(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint16 texel = Codec::encode(src);
+            std::memcpy(dst, &texel, 2);
+        }
+
+        static inline void storePair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint16 texels[2] = {Codec::encode(src), Codec::encode(src + 4)};
+            std::memcpy(dst, texels, 4);
+        }
+
+        static inline void load(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint16 texel;
+            std::memcpy(&texel, src, 2);
+            Codec::decode(texel, dst);
+        }
+
+        static inline void loadPair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            cpp3ds::Uint16 texels[2];
+            std::memcpy(texels, src, 4);
+            Codec::decode(texels[0], dst);
+            Codec::decode(texels[1], dst + 4);
+        }
+    };
+
+    struct Alpha8
+    {
+        enum {ImageBytes = 4, TextureBytes = 1};
+
+        static inline void store(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            *dst = src[3];
+        }
+
+        static inline void storePair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            dst[0] = src[3];
+            dst[1] = src[7];
+        }
+
+        static inline void load(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            dst[0] = dst[1] = dst[2] = 255;
+            dst[3] = *src;
+        }
+
+        static inline void loadPair(cpp3ds::Uint8* dst, const cpp3ds::Uint8* src)
+        {
+            load(dst, src);
+            load(dst + 4, src + 1);
+        }
+    };
+
+    // Walk the region one 8x8 tile at a time. Full tile rows are
+    // converted in pairs of pixels, edges one pixel at a time.
+    template <typename Pixel, bool ToTexture>
+    void convert(cpp3ds::Uint8* texture, cpp3ds::Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                 unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight)
+    {
+        const unsigned int imageBytes = Pixel::ImageBytes;
+        const unsigned int textureBytes = Pixel::TextureBytes;
+
+        // Texture rows are numbered from the bottom
+        unsigned int bottom = textureHeight - y - height;
+        unsigned int top = textureHeight - y;
+        unsigned int right = x + width;
+
+        for (unsigned int tileY = bottom & ~7u; tileY < top; tileY += 8)
+        {
+            unsigned int rowBegin = std::max(bottom, tileY) - tileY;
+            unsigned int rowEnd = std::min(top, tileY + 8) - tileY;
+
+            for (unsigned int tileX = x & ~7u; tileX < right; tileX += 8)
+            {
+                unsigned int columnBegin = std::max(x, tileX) - tileX;
+                unsigned int columnEnd = std::min(right, tileX + 8) - tileX;
+                cpp3ds::Uint8* tile = texture + (tileY * textureWidth + tileX * 8) * textureBytes;
+
+                for (unsigned int row = rowBegin; row < rowEnd; ++row)
+                {
+                    const cpp3ds::Uint8* offsets = tileOffsets[row];
+                    cpp3ds::Uint8* line = pixels + (top - 1 - tileY - row) * pitch + (tileX + columnBegin - x) * imageBytes;
+
+                    if (columnBegin == 0 && columnEnd == 8)
+                    {
+                        for (unsigned int column = 0; column < 8; column += 2, line += 2 * imageBytes)
+                        {
+                            if (ToTexture)
+                                Pixel::storePair(tile + offsets[column] * textureBytes, line);
+                            else
+                                Pixel::loadPair(line, tile + offsets[column] * textureBytes);
+                        }
+                    }
+                    else
+                    {
+                        for (unsigned int column = columnBegin; column < columnEnd; ++column, line += imageBytes)
+                        {
+                            if (ToTexture)
+                                Pixel::store(tile + offsets[column] * textureBytes, line);
+                            else
+                                Pixel::load(line, tile + offsets[column] * textureBytes);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Dispatch a region conversion to the right pixel policy
+    template <typename Pixel>
+    void convertRegion(bool toTexture, cpp3ds::Uint8* texture, cpp3ds::Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                       unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight)
+    {
+        if (toTexture)
+            convert<Pixel, true>(texture, pixels, x, y, width, height, pitch, textureWidth, textureHeight);
+        else
+            convert<Pixel, false>(texture, pixels, x, y, width, height, pitch, textureWidth, textureHeight);
+    }
+
+    // Convert pixels without tiling them
+    template <typename Pixel>
+    void convertLinear(cpp3ds::Uint8* texels, const cpp3ds::Uint8* pixels, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            Pixel::store(texels + i * Pixel::TextureBytes, pixels + i * Pixel::ImageBytes);
+    }
+
+    // 4 bits pixels are packed two per byte, first pixel in the low nibble
+    template <bool ToTexture>
+    void convert4(cpp3ds::Uint8* texture, cpp3ds::Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                  unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight)
+    {
+        unsigned int bottom = textureHeight - y - height;
+        unsigned int top = textureHeight - y;
+        unsigned int right = x + width;
+
+        for (unsigned int tileY = bottom & ~7u; tileY < top; tileY += 8)
+        {
+            unsigned int rowBegin = std::max(bottom, tileY) - tileY;
+            unsigned int rowEnd = std::min(top, tileY + 8) - tileY;
+
+            for (unsigned int tileX = x & ~7u; tileX < right; tileX += 8)
+            {
+                unsigned int columnBegin = std::max(x, tileX) - tileX;
+                unsigned int columnEnd = std::min(right, tileX + 8) - tileX;
+                unsigned int tile = tileY * textureWidth + tileX * 8;
+
+                for (unsigned int row = rowBegin; row < rowEnd; ++row)
+                {
+                    cpp3ds::Uint8* line = pixels + (top - 1 - tileY - row) * pitch;
+
+                    for (unsigned int column = columnBegin; column < columnEnd; ++column)
+                    {
+                        unsigned int texel = tile + tileOffsets[row][column];
+                        unsigned int pixel = tileX + column - x;
+                        cpp3ds::Uint8* dst;
+                        unsigned int dstShift, value;
+
+                        if (ToTexture)
+                        {
+                            value = (line[pixel / 2] >> ((pixel & 1) * 4)) & 0xF;
+                            dst = texture + texel / 2;
+                            dstShift = (texel & 1) * 4;
+                        }
+                        else
+                        {
+                            value = (texture[texel / 2] >> ((texel & 1) * 4)) & 0xF;
+                            dst = line + pixel / 2;
+                            dstShift = (pixel & 1) * 4;
+                        }
+
+                        *dst = static_cast<cpp3ds::Uint8>((*dst & ~(0xF << dstShift)) | (value << dstShift));
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+namespace cpp3ds
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool tileImage(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+               unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel)
+{
+    Uint8* source = const_cast<Uint8*>(pixels);
+
+    switch (bitsPerPixel)
+    {
+        case 32: convertRegion<Raw<4> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 24: convertRegion<Raw<3> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 16: convertRegion<Raw<2> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 8:  convertRegion<Raw<1> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 4:  convert4<true>(texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        default: return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool untileImage(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                 unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel)
+{
+    Uint8* source = const_cast<Uint8*>(texture);
+
+    switch (bitsPerPixel)
+    {
+        case 32: convertRegion<Raw<4> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 24: convertRegion<Raw<3> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 16: convertRegion<Raw<2> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 8:  convertRegion<Raw<1> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case 4:  convert4<false>(source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        default: return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool tileImage(Uint8* texture, const Uint8* pixels, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+               unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, Texture::Format format)
+{
+    Uint8* source = const_cast<Uint8*>(pixels);
+
+    switch (format)
+    {
+        case Texture::RGBA8:    convertRegion<Raw<4> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGB565:   convertRegion<Packed16<Rgb565> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGBA5551: convertRegion<Packed16<Rgba5551> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGBA4:    convertRegion<Packed16<Rgba4> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::LA8:      convertRegion<Packed16<La8> >(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::A8:       convertRegion<Alpha8>(true, texture, source, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::ETC1:     compressEtc1(texture, pixels, x, y, width, height, pitch, textureWidth, textureHeight, false); return true;
+        case Texture::ETC1A4:   compressEtc1(texture, pixels, x, y, width, height, pitch, textureWidth, textureHeight, true); return true;
+        default:                return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool untileImage(Uint8* pixels, const Uint8* texture, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+                 unsigned int pitch, unsigned int textureWidth, unsigned int textureHeight, Texture::Format format)
+{
+    Uint8* source = const_cast<Uint8*>(texture);
+
+    switch (format)
+    {
+        case Texture::RGBA8:    convertRegion<Raw<4> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGB565:   convertRegion<Packed16<Rgb565> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGBA5551: convertRegion<Packed16<Rgba5551> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::RGBA4:    convertRegion<Packed16<Rgba4> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::LA8:      convertRegion<Packed16<La8> >(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::A8:       convertRegion<Alpha8>(false, source, pixels, x, y, width, height, pitch, textureWidth, textureHeight); return true;
+        case Texture::ETC1:     decompressEtc1(pixels, texture, x, y, width, height, pitch, textureWidth, textureHeight, false); return true;
+        case Texture::ETC1A4:   decompressEtc1(pixels, texture, x, y, width, height, pitch, textureWidth, textureHeight, true); return true;
+        default:                return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void tileImageInPlace(Uint8* pixels, unsigned int width, unsigned int height)
+{
+    // Tile rows start from the bottom of the image, so the band of 8 rows
+    // at the top ends up where the band at the bottom was, and so on:
+    // bands are swapped in pairs, going through two small buffers
+    unsigned int bandSize = width * 8 * 4;
+    unsigned int bands = height / 8;
+    std::vector<Uint8> top(bandSize);
+    std::vector<Uint8> bottom(bandSize);
+
+    for (unsigned int i = 0; i < (bands + 1) / 2; ++i)
+    {
+        unsigned int j = bands - 1 - i;
+        std::memcpy(&top[0], pixels + i * bandSize, bandSize);
+        std::memcpy(&bottom[0], pixels + j * bandSize, bandSize);
+
+        tileImage(pixels, &top[0], 0, i * 8, width, 8, width * 4, width, height, Texture::RGBA8);
+        if (j != i)
+            tileImage(pixels, &bottom[0], 0, j * 8, width, 8, width * 4, width, height, Texture::RGBA8);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void growTiledImage(Uint8* texture, const Uint8* source, unsigned int sourceWidth, unsigned int sourceHeight,
+                    unsigned int textureWidth, unsigned int textureHeight, unsigned int bitsPerPixel, const Uint8* fillTile)
+{
+    std::size_t tileSize = 64 * bitsPerPixel / 8;
+    std::size_t sourceRowSize = (sourceWidth / 8) * tileSize;
+    std::size_t textureRowSize = (textureWidth / 8) * tileSize;
+
+    // Tile rows start from the bottom of the image, so the source
+    // rows go to the end of the larger texture
+    unsigned int rows = textureHeight / 8;
+    unsigned int firstSourceRow = rows - sourceHeight / 8;
+
+    for (unsigned int row = 0; row < rows; ++row)
+    {
+        Uint8* destination = texture + row * textureRowSize;
+        std::size_t filled = 0;
+
+        if (row >= firstSourceRow)
+        {
+            std::memcpy(destination, source + (row - firstSourceRow) * sourceRowSize, sourceRowSize);
+            filled = sourceRowSize;
+        }
+
+        for (; filled < textureRowSize; filled += tileSize)
+            std::memcpy(destination + filled, fillTile, tileSize);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void convertPixels(Uint8* texels, const Uint8* pixels, std::size_t count, Texture::Format format)
+{
+    switch (format)
+    {
+        case Texture::RGBA8:    convertLinear<Raw<4> >(texels, pixels, count); break;
+        case Texture::RGB565:   convertLinear<Packed16<Rgb565> >(texels, pixels, count); break;
+        case Texture::RGBA5551: convertLinear<Packed16<Rgba5551> >(texels, pixels, count); break;
+        case Texture::RGBA4:    convertLinear<Packed16<Rgba4> >(texels, pixels, count); break;
+        case Texture::LA8:      convertLinear<Packed16<La8> >(texels, pixels, count); break;
+        case Texture::A8:       convertLinear<Alpha8>(texels, pixels, count); break;
+        default:                break;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int getBitsPerPixel(Texture::Format format)
+{
+    switch (format)
+    {
+        case Texture::RGBA8:  return 32;
+        case Texture::A8:
+        case Texture::ETC1A4: return 8;
+        case Texture::ETC1:   return 4;
+        default:              return 16;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void halveImage(Uint8* destination, const Uint8* source, unsigned int width, unsigned int height)
+{
+    unsigned int pitch = width * 4;
+
+    for (unsigned int y = 0; y < height / 2; ++y)
+    {
+        const Uint8* top = source + y * 2 * pitch;
+        const Uint8* bottom = top + pitch;
+
+        for (unsigned int x = 0; x < width / 2; ++x, top += 8, bottom += 8)
+        {
+            for (unsigned int c = 0; c < 4; ++c)
+                *destination++ = static_cast<Uint8>((top[c] + top[c + 4] + bottom[c] + bottom[c + 4] + 2) >> 2);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int getMipmapLevelCount(unsigned int width, unsigned int height)
+{
+    unsigned int levels = 1;
+    while (width >= 16 && height >= 16)
+    {
+        width /= 2;
+        height /= 2;
+        ++levels;
+    }
+
+    return levels;
+}
+
+} // namespace priv
+
+} // namespace cpp3ds
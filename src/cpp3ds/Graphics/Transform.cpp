@@ -26,6 +26,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Transform.hpp>
+#include <cpp3ds/Graphics/Vertex.hpp>
 #include <cmath>
 #include "CitroHelpers.hpp"
 
@@ -155,6 +156,54 @@ FloatRect Transform::transformRect(const FloatRect& rectangle) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Transform::transformVertices(const Vertex* source, Vertex* destination, std::size_t count) const
+{
+    // Only the 2D affine part of the matrix is needed
+    const float a = m_matrix.m[3], b = m_matrix.m[2], tx = m_matrix.m[0];
+    const float c = m_matrix.m[7], d = m_matrix.m[6], ty = m_matrix.m[4];
+
+    const Vertex* __restrict in = source;
+    Vertex* __restrict out = destination;
+
+    // Handle four vertices per iteration: loading all the positions first
+    // leaves the multiply-adds independent from each other
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4, in += 4, out += 4)
+    {
+        const float x0 = in[0].position.x, y0 = in[0].position.y;
+        const float x1 = in[1].position.x, y1 = in[1].position.y;
+        const float x2 = in[2].position.x, y2 = in[2].position.y;
+        const float x3 = in[3].position.x, y3 = in[3].position.y;
+
+        out[0].position.x = a * x0 + b * y0 + tx;
+        out[1].position.x = a * x1 + b * y1 + tx;
+        out[2].position.x = a * x2 + b * y2 + tx;
+        out[3].position.x = a * x3 + b * y3 + tx;
+        out[0].position.y = c * x0 + d * y0 + ty;
+        out[1].position.y = c * x1 + d * y1 + ty;
+        out[2].position.y = c * x2 + d * y2 + ty;
+        out[3].position.y = c * x3 + d * y3 + ty;
+
+        for (int j = 0; j < 4; ++j)
+        {
+            out[j].color     = in[j].color;
+            out[j].texCoords = in[j].texCoords;
+        }
+    }
+
+    // Remaining vertices
+    for (; i < count; ++i, ++in, ++out)
+    {
+        const float x = in->position.x, y = in->position.y;
+        out->position.x = a * x + b * y + tx;
+        out->position.y = c * x + d * y + ty;
+        out->color      = in->color;
+        out->texCoords  = in->texCoords;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 Transform& Transform::combine(const Transform& transform)
 {
@@ -30,6 +30,7 @@
 #include <cpp3ds/System/String.hpp>
 #include <cstring>
 #include <cwchar>
+#include <utility>
 
 
 namespace cpp3ds
@@ -51,6 +52,63 @@ Packet::~Packet()
 }
 
 
+////////////////////////////////////////////////////////////
+Packet::Packet(const Packet& copy) :
+m_data   (copy.m_data),
+m_readPos(copy.m_readPos),
+m_sendPos(copy.m_sendPos),
+m_isValid(copy.m_isValid)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+Packet::Packet(Packet&& other) noexcept :
+m_data   (std::move(other.m_data)),
+m_readPos(other.m_readPos),
+m_sendPos(other.m_sendPos),
+m_isValid(other.m_isValid)
+{
+    other.m_data.clear();
+    other.m_readPos = 0;
+    other.m_sendPos = 0;
+    other.m_isValid = true;
+}
+
+
+////////////////////////////////////////////////////////////
+Packet& Packet::operator =(const Packet& right)
+{
+    m_data    = right.m_data;
+    m_readPos = right.m_readPos;
+    m_sendPos = right.m_sendPos;
+    m_isValid = right.m_isValid;
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+Packet& Packet::operator =(Packet&& right) noexcept
+{
+    if (this != &right)
+    {
+        m_data    = std::move(right.m_data);
+        m_readPos = right.m_readPos;
+        m_sendPos = right.m_sendPos;
+        m_isValid = right.m_isValid;
+
+        right.m_data.clear();
+        right.m_readPos = 0;
+        right.m_sendPos = 0;
+        right.m_isValid = true;
+    }
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Packet::append(const void* data, std::size_t sizeInBytes)
 {
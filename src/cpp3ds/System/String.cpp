@@ -29,6 +29,7 @@
 #include <cpp3ds/System/Utf.hpp>
 #include <iterator>
 #include <cstring>
+#include <utility>
 
 
 namespace cpp3ds
@@ -132,6 +133,14 @@ m_string(copy.m_string)
 }
 
 
+////////////////////////////////////////////////////////////
+String::String(String&& other) noexcept :
+m_string(std::move(other.m_string))
+{
+    other.m_string.clear();
+}
+
+
 ////////////////////////////////////////////////////////////
 String::operator std::string() const
 {
@@ -217,6 +226,18 @@ String& String::operator =(const String& right)
 }
 
 
+////////////////////////////////////////////////////////////
+String& String::operator =(String&& right) noexcept
+{
+    if (this != &right)
+    {
+        m_string = std::move(right.m_string);
+        right.m_string.clear();
+    }
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 String& String::operator +=(const String& right)
 {
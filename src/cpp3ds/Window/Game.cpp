@@ -75,12 +75,12 @@ void Game::render()
 	if (!console.isEnabledBasic() || console.getScreen() != TopScreen) {
 		C3D_RenderTarget* target = windowTop.getCitroTarget();
 		C3D_RenderBufBind(&target->renderBuf);
-		windowTop.resetGLStates();
 		renderTopScreen(windowTop);
 		if (console.isEnabled() && console.getScreen() == TopScreen) {
 			windowTop.setView(windowTop.getDefaultView());
 			windowTop.draw(console);
 		}
+		windowTop.flush();
 		C3D_Flush();
 		C3D_RenderBufTransfer(&target->renderBuf, (u32*)gfxGetFramebuffer(GFX_TOP, GFX_LEFT, NULL, NULL), target->transferFlags);
 	}
@@ -88,16 +88,21 @@ void Game::render()
 	if (!console.isEnabledBasic() || console.getScreen() != BottomScreen) {
 		C3D_RenderTarget* target = windowBottom.getCitroTarget();
 		C3D_RenderBufBind(&target->renderBuf);
-		windowBottom.resetGLStates();
 		renderBottomScreen(windowBottom);
 		if (console.isEnabled() && console.getScreen() == BottomScreen) {
 			windowBottom.setView(windowBottom.getDefaultView());
 			windowBottom.draw(console);
 		}
+		windowBottom.flush();
 		C3D_Flush();
 		C3D_RenderBufTransfer(&target->renderBuf, (u32*)gfxGetFramebuffer(GFX_BOTTOM, GFX_LEFT, NULL, NULL), target->transferFlags);
 	}
 
+	// The GPU is done with this frame's vertices and textures
+	FrameAllocator::nextFrame();
+	TextureCache::nextFrame();
+	TextureLoader::update();
+
 	gfxSwapBuffersGpu();
 	gspWaitForVBlank();
 
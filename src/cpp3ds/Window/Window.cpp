@@ -181,6 +181,9 @@ void Window::setFramerateLimit(unsigned int limit)
 ////////////////////////////////////////////////////////////
 void Window::display()
 {
+	// Submit the pending batched draws
+	flush();
+
 	// Display the backbuffer on screen
 	if (setActive())
 		m_context->display();
@@ -33,6 +33,7 @@
 #include "ALCheck.hpp"
 #include <cpp3ds/System/Err.hpp>
 #include <memory>
+#include <utility>
 #include <iostream>
 
 namespace cpp3ds
@@ -62,6 +63,24 @@ m_sounds  () // don't copy the attached sounds
 }
 
 
+////////////////////////////////////////////////////////////
+SoundBuffer::SoundBuffer(SoundBuffer&& other) noexcept :
+m_duration    (other.m_duration),
+m_sounds      (),
+m_sampleRate  (other.m_sampleRate),
+m_channelCount(other.m_channelCount),
+m_buffer      (other.m_buffer),
+m_samples     (std::move(other.m_samples))
+{
+    // The OpenAL sources stay bound to the same buffer, only its owner changes
+    takeSounds(other);
+
+    other.m_buffer = 0;
+    other.m_samples.clear();
+    other.m_duration = Time::Zero;
+}
+
+
 ////////////////////////////////////////////////////////////
 SoundBuffer::~SoundBuffer()
 {
@@ -214,6 +233,36 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 }
 
 
+////////////////////////////////////////////////////////////
+SoundBuffer& SoundBuffer::operator =(SoundBuffer&& right) noexcept
+{
+    if (this != &right)
+    {
+        // Detach the sounds before their buffer is destroyed (to avoid OpenAL errors)
+        SoundList sounds;
+        sounds.swap(m_sounds);
+        for (SoundList::const_iterator it = sounds.begin(); it != sounds.end(); ++it)
+            (*it)->resetBuffer();
+
+        if (m_buffer)
+            alCheck(alDeleteBuffers(1, &m_buffer));
+
+        m_buffer       = right.m_buffer;
+        m_samples      = std::move(right.m_samples);
+        m_duration     = right.m_duration;
+        m_sampleRate   = right.m_sampleRate;
+        m_channelCount = right.m_channelCount;
+        takeSounds(right);
+
+        right.m_buffer = 0;
+        right.m_samples.clear();
+        right.m_duration = Time::Zero;
+    }
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool SoundBuffer::initialize(InputSoundFile& file)
 {
@@ -288,4 +337,14 @@ void SoundBuffer::detachSound(Sound* sound) const
     m_sounds.erase(sound);
 }
 
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::takeSounds(SoundBuffer& other)
+{
+    // Our own list is empty at this point, swapping it allocates nothing
+    m_sounds.swap(other.m_sounds);
+    for (SoundList::const_iterator it = m_sounds.begin(); it != m_sounds.end(); ++it)
+        (*it)->m_buffer = this;
+}
+
 } // namespace cpp3ds
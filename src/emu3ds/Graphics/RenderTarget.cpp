@@ -27,11 +27,13 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/RenderTarget.hpp>
 #include <cpp3ds/Graphics/Drawable.hpp>
+#include <cpp3ds/Graphics/RenderCommandList.hpp>
 #include <cpp3ds/Graphics/Shader.hpp>
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/VertexArray.hpp>
 #include <cpp3ds/OpenGL.hpp>
 #include <cpp3ds/System/Err.hpp>
+#include <new>
 
 
 namespace
@@ -66,6 +68,11 @@ namespace
             case cpp3ds::BlendMode::Subtract:        return GL_FUNC_SUBTRACT;
         }
     }
+
+
+    // Render target that drew last, the states caches of the
+    // other targets can't be trusted anymore
+    const cpp3ds::RenderTarget* statesOwner = NULL;
 }
 
 
@@ -73,12 +80,18 @@ namespace cpp3ds
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      ()
+m_defaultView    (),
+m_view           (),
+m_cache          (),
+m_vertexAllocator(StatesCache::FrameVertexCount * sizeof(Vertex)),
+m_commandList    (NULL)
 {
 	m_cache.vertexCache = new Vertex[StatesCache::VertexCacheSize];
 	m_cache.glStatesSet = false;
+	m_cache.dirty = StatesCache::AllDirty;
+	m_cache.batchEnabled = false;
+	m_cache.batchVertices = NULL;
+	m_cache.batchCount = 0;
 }
 
 
@@ -86,12 +99,21 @@ m_cache      ()
 RenderTarget::~RenderTarget()
 {
 	delete[] m_cache.vertexCache;
+
+	// The pending batch won't be drawn, its texture mustn't flush it anymore
+	if ((m_cache.batchCount > 0) && m_cache.batchTexture && (m_cache.batchTexture->m_batchTarget == this))
+		m_cache.batchTexture->m_batchTarget = NULL;
+
+	if (statesOwner == this)
+		statesOwner = NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    flush();
+
     if (activate(true))
     {
         // Unbind texture to fix RenderTexture preventing clear
@@ -111,8 +133,11 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Pending batches must be drawn with the previous view
+    flush();
+
     m_view = view;
-    m_cache.viewChanged = true;
+    m_cache.dirty |= StatesCache::ViewDirty;
 }
 
 
@@ -203,6 +228,201 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
     if (!vertices || (vertexCount == 0))
         return;
 
+    // Store the draw for later if a command list is being recorded
+    if (m_commandList)
+    {
+        m_commandList->append(vertices, vertexCount, type, states);
+        return;
+    }
+
+    // Merge small meshes into the pending batch if possible
+    if (m_cache.batchEnabled && addToBatch(vertices, vertexCount, type, states))
+        return;
+
+    // Batched draws that came before must reach the GPU first
+    flush();
+
+    drawPrimitives(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    m_cache.batchEnabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_cache.batchEnabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    if (m_cache.batchCount == 0)
+        return;
+
+    RenderStates states;
+    states.blendMode = m_cache.batchBlendMode;
+    states.texture   = m_cache.batchTexture;
+    states.shader    = m_cache.batchShader;
+    states.scissor   = m_cache.batchScissor;
+
+    // The vertices stay in the frame allocator until the GPU is done with
+    // them, the next batch is simply allocated after this one
+    unsigned int vertexCount = m_cache.batchCount;
+    m_cache.batchCount = 0;
+
+    if (states.texture && (states.texture->m_batchTarget == this))
+        states.texture->m_batchTarget = NULL;
+
+    drawPrimitives(m_cache.batchVertices, vertexCount, Triangles, states, true);
+}
+
+
+////////////////////////////////////////////////////////////
+Vertex* RenderTarget::allocateVertices(unsigned int vertexCount)
+{
+    Vertex* vertices = static_cast<Vertex*>(m_vertexAllocator.allocate(vertexCount * sizeof(Vertex)));
+    if (vertices)
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            ::new (&vertices[i]) Vertex();
+
+    return vertices;
+}
+
+
+////////////////////////////////////////////////////////////
+FrameAllocator& RenderTarget::getVertexAllocator()
+{
+    return m_vertexAllocator;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::beginRecording(RenderCommandList& commandList)
+{
+    // Draws made before must not end up in the list
+    flush();
+
+    commandList.clear();
+    m_commandList = &commandList;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::endRecording()
+{
+    m_commandList = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isRecording() const
+{
+    return m_commandList != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::addToBatch(const Vertex* vertices, unsigned int vertexCount,
+                              PrimitiveType type, const RenderStates& states)
+{
+    // Number of vertices once converted to a triangle list, the leftover
+    // vertices of an incomplete triangle are ignored as in a direct draw
+    if (vertexCount < 3)
+        return false;
+    unsigned int count = (type == Triangles) ? vertexCount - vertexCount % 3 : 3 * (vertexCount - 2);
+
+    // Big meshes are cheaper to draw directly than to transform on the CPU
+    if (count > StatesCache::BatchMaxVertexCount)
+        return false;
+
+    // Start a new batch if the states differ from the pending one
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+    if ((m_cache.batchCount > 0) &&
+        ((textureId != m_cache.batchTextureId) || (states.blendMode != m_cache.batchBlendMode) ||
+         (states.scissor != m_cache.batchScissor) || (states.shader != m_cache.batchShader)))
+        flush();
+
+    // Vertices of the same batch must be contiguous: a pending batch is
+    // extended with an unpadded block, which only ends up right after it
+    // if nothing else was allocated in between
+    std::size_t alignment = (m_cache.batchCount > 0) ? sizeof(float) : 16;
+    Vertex* vertex = static_cast<Vertex*>(m_vertexAllocator.allocate(count * sizeof(Vertex), alignment));
+    if (!vertex)
+    {
+        // Not enough room left in this frame, draw directly
+        flush();
+        return false;
+    }
+
+    if (m_cache.batchCount > 0 && vertex != m_cache.batchVertices + m_cache.batchCount)
+        flush();
+
+    if (m_cache.batchCount == 0)
+    {
+        m_cache.batchVertices  = vertex;
+        m_cache.batchTexture   = states.texture;
+        m_cache.batchTextureId = textureId;
+        m_cache.batchBlendMode = states.blendMode;
+        m_cache.batchScissor   = states.scissor;
+        m_cache.batchShader    = states.shader;
+
+        // The batch only keeps a pointer to the texture, the texture draws
+        // the batch if it goes away first. A texture is in one pending
+        // batch at a time.
+        if (states.texture)
+        {
+            if (states.texture->m_batchTarget)
+                states.texture->m_batchTarget->flush();
+            states.texture->m_batchTarget = this;
+        }
+    }
+
+    if (type == Triangles)
+    {
+        states.transform.transformVertices(vertices, vertex, count);
+    }
+    else
+    {
+        // Transform the positions once, strips and fans reuse them
+        Vector2f positions[StatesCache::BatchMaxVertexCount];
+        for (unsigned int i = 0; i < vertexCount; ++i)
+            positions[i] = states.transform.transformPoint(vertices[i].position);
+
+        for (unsigned int i = 0; i < count; ++i, ++vertex)
+        {
+            // Index of the source vertex for the i-th triangle list vertex
+            unsigned int index;
+            if (type == TrianglesStrip)
+                index = i / 3 + i % 3;
+            else
+                index = (i % 3 == 0) ? 0 : i / 3 + i % 3;
+
+            vertex->position  = positions[index];
+            vertex->color     = vertices[index].color;
+            vertex->texCoords = vertices[index].texCoords;
+        }
+    }
+
+    m_cache.batchCount += count;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawPrimitives(const Vertex* vertices, unsigned int vertexCount,
+                                  PrimitiveType type, const RenderStates& states, bool isTransformed)
+{
 	// Vertices allocated in the stack (common) can't be converted to physical address
 	#ifndef EMULATION
 	if (osConvertVirtToPhys(vertices) == 0)
@@ -220,21 +440,21 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         if (!m_cache.glStatesSet)
             resetGLStates();
 
+        validateCache();
+
         // Check if the vertex count is low enough so that we can pre-transform them
-        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+        bool useVertexCache = isTransformed || (vertexCount <= StatesCache::VertexCacheSize);
         if (useVertexCache)
         {
             // Pre-transform the vertices and store them into the vertex cache
-            for (unsigned int i = 0; i < vertexCount; ++i)
+            if (!isTransformed)
             {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
+                states.transform.transformVertices(vertices, m_cache.vertexCache, vertexCount);
+                vertices = m_cache.vertexCache;
             }
 
             // Since vertices are transformed, we must use an identity transform to render them
-            if (!m_cache.useVertexCache)
+            if (!m_cache.useVertexCache || (m_cache.dirty & StatesCache::TransformDirty))
                 applyTransform(Transform::Identity);
         }
         else
@@ -243,44 +463,32 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         }
 
         // Apply the view
-        if (m_cache.viewChanged)
+        if (m_cache.dirty & StatesCache::ViewDirty)
             applyCurrentView();
 
         // Apply the blend mode
-        if (states.blendMode != m_cache.lastBlendMode)
+        if ((m_cache.dirty & StatesCache::BlendModeDirty) || (states.blendMode != m_cache.lastBlendMode))
             applyBlendMode(states.blendMode);
 
         // Apply the scissor mode
-        if (states.scissor != m_cache.lastScissor)
+        if ((m_cache.dirty & StatesCache::ScissorDirty) || (states.scissor != m_cache.lastScissor))
             applyScissor(states.scissor);
 
         // Apply the texture
         Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
-        if (textureId != m_cache.lastTextureId)
+        if ((m_cache.dirty & StatesCache::TextureDirty) || (textureId != m_cache.lastTextureId))
             applyTexture(states.texture);
 
         // Apply the shader
-        if (states.shader)
+        if (states.shader || (m_cache.dirty & StatesCache::ShaderDirty))
             applyShader(states.shader);
 
-        // If we pre-transform the vertices, we must use our internal vertex cache
-        if (useVertexCache)
-        {
-            // ... and if we already used it previously, we don't need to set the pointers again
-            if (!m_cache.useVertexCache)
-                vertices = m_cache.vertexCache;
-            else
-                vertices = NULL;
-        }
-
-        // Setup the pointers to the vertices' components
-        if (vertices)
-        {
-            const char* data = reinterpret_cast<const char*>(vertices);
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8)); // 8 = sizeof(Vector2f)
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12)); // 12 = 8 + sizeof(Color)
-        }
+        // Setup the pointers to the vertices' components. They're always set, as
+        // pre-transformed vertices may come from the vertex cache or from a batch.
+        const char* data = reinterpret_cast<const char*>(vertices);
+        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8)); // 8 = sizeof(Vector2f)
+        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12)); // 12 = 8 + sizeof(Color)
 
         // Find the OpenGL primitive type
         static const GLenum modes[] = {GL_TRIANGLES, GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
@@ -302,6 +510,8 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    flush();
+
 	if (activate(true))
     {
         #ifdef CPP3DS_DEBUG
@@ -324,6 +534,16 @@ void RenderTarget::pushGLStates()
 		glCheck(glPushMatrix());
 		glCheck(glMatrixMode(GL_TEXTURE));
 		glCheck(glPushMatrix());
+
+        validateCache();
+
+        StatesCache::SavedStates saved;
+        saved.blendMode      = m_cache.lastBlendMode;
+        saved.textureId      = m_cache.lastTextureId;
+        saved.scissor        = m_cache.lastScissor;
+        saved.useVertexCache = m_cache.useVertexCache;
+        saved.dirty          = m_cache.dirty;
+        m_cache.stack.push_back(saved);
     }
     resetGLStates();
 }
@@ -332,6 +552,17 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flush();
+
+    if (m_cache.stack.empty())
+    {
+        err() << "RenderTarget::popGLStates() called without a matching pushGLStates()" << std::endl;
+        return;
+    }
+
+    StatesCache::SavedStates saved = m_cache.stack.back();
+    m_cache.stack.pop_back();
+
     if (activate(true))
     {
 		glCheck(glMatrixMode(GL_PROJECTION));
@@ -343,6 +574,15 @@ void RenderTarget::popGLStates()
 
 		glCheck(glPopClientAttrib());
 		glCheck(glPopAttrib());
+
+        // OpenGL restored the saved states by itself, the cache only has to follow.
+        // The view is always applied again, as the projection matrix was popped.
+        validateCache();
+        m_cache.lastBlendMode  = saved.blendMode;
+        m_cache.lastTextureId  = saved.textureId;
+        m_cache.lastScissor    = saved.scissor;
+        m_cache.useVertexCache = saved.useVertexCache;
+        m_cache.dirty          = saved.dirty | StatesCache::ViewDirty;
     }
 }
 
@@ -350,6 +590,9 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
+    // Pending batches must be drawn with the states they were recorded with
+    flush();
+
 	// Check here to make sure a context change does not happen after activate(true)
     bool shaderAvailable = Shader::isAvailable();
 
@@ -376,6 +619,7 @@ void RenderTarget::resetGLStates()
 		glCheck(glEnableClientState(GL_COLOR_ARRAY));
 		glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
         m_cache.glStatesSet = true;
+        validateCache();
 
         // Apply the default SFML states
         applyBlendMode(BlendAlpha);
@@ -405,6 +649,17 @@ void RenderTarget::initialize()
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::validateCache()
+{
+    if (statesOwner != this)
+    {
+        m_cache.dirty = StatesCache::AllDirty;
+        statesOwner = this;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
@@ -420,7 +675,7 @@ void RenderTarget::applyCurrentView()
     // Go back to model-view mode
     glCheck(glMatrixMode(GL_MODELVIEW));
 
-    m_cache.viewChanged = false;
+    m_cache.dirty &= ~StatesCache::ViewDirty;
 }
 
 
@@ -437,6 +692,7 @@ void RenderTarget::applyBlendMode(const BlendMode& mode)
 		equationToGlConstant(mode.alphaEquation)));
 
     m_cache.lastBlendMode = mode;
+    m_cache.dirty &= ~StatesCache::BlendModeDirty;
 }
 
 
@@ -452,6 +708,7 @@ void RenderTarget::applyScissor(const UintRect& rect)
 		glScissor(rect.left, y, rect.width, rect.height);
 	}
 	m_cache.lastScissor = rect;
+	m_cache.dirty &= ~StatesCache::ScissorDirty;
 }
 
 
@@ -461,6 +718,8 @@ void RenderTarget::applyTransform(const Transform& transform)
     // No need to call glMatrixMode(GL_MODELVIEW), it is always the
     // current mode (for optimization purpose, since it's the most used)
     glCheck(glLoadMatrixf(transform.getMatrix()));
+
+    m_cache.dirty &= ~StatesCache::TransformDirty;
 }
 
 
@@ -470,6 +729,7 @@ void RenderTarget::applyTexture(const Texture* texture)
     Texture::bind(texture, Texture::Pixels);
 
     m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
+    m_cache.dirty &= ~StatesCache::TextureDirty;
 }
 
 
@@ -477,6 +737,8 @@ void RenderTarget::applyTexture(const Texture* texture)
 void RenderTarget::applyShader(const Shader* shader)
 {
     Shader::bind(shader);
+
+    m_cache.dirty &= ~StatesCache::ShaderDirty;
 }
 
 } // namespace cpp3ds
@@ -498,6 +760,12 @@ void RenderTarget::applyShader(const Shader* shader)
 //   pre-transform them and therefore use an identity transform
 //   to render them.
 //
+// * Batching
+//   When enabled, small meshes are transformed on the CPU and
+//   appended to a client-side buffer as long as the texture,
+//   blend mode, scissor and shader don't change. The whole run
+//   is then drawn at once with an identity transform.
+//
 // * Blending mode
 //   Since it overloads the == operator, we can easily check
 //   whether any of the 6 blending components changed and,
@@ -27,7 +27,12 @@
 ////////////////////////////////////////////////////////////
 #include <cpp3ds/Graphics/Texture.hpp>
 #include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/RenderTarget.hpp>
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/TextureLoader.hpp>
 #include <cpp3ds/Graphics/TextureSaver.hpp>
+#include <cpp3ds/Graphics/TextureTiling.hpp>
 #include <cpp3ds/OpenGL/GLExtensions.hpp>
 #include <cpp3ds/Window/Window.hpp>
 #include <cpp3ds/System/Mutex.hpp>
@@ -36,6 +41,8 @@
 #include <cpp3ds/OpenGL.hpp>
 #include <cassert>
 #include <cstring>
+#include <utility>
+#include <vector>
 #ifndef EMULATION
 #include <3ds.h>
 #endif
@@ -68,6 +75,82 @@ namespace
 
 		return static_cast<unsigned int>(size);
 	}
+
+	// OpenGL formats closest to the 3DS texture formats
+	struct GlFormat
+	{
+		GLint  internalFormat;
+		GLenum format;
+		GLenum type;
+	};
+
+	GlFormat getGlFormat(cpp3ds::Texture::Format format)
+	{
+		GlFormat formats[] =
+		{
+			{GL_RGBA,                GL_RGBA,            GL_UNSIGNED_BYTE},          // RGBA8
+			{GL_RGB5,                GL_RGB,             GL_UNSIGNED_SHORT_5_6_5},   // RGB565
+			{GL_RGB5_A1,             GL_RGBA,            GL_UNSIGNED_SHORT_5_5_5_1}, // RGBA5551
+			{GL_RGBA4,               GL_RGBA,            GL_UNSIGNED_SHORT_4_4_4_4}, // RGBA4
+			{GL_LUMINANCE8_ALPHA8,   GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE},          // LA8
+			{GL_ALPHA8,              GL_ALPHA,           GL_UNSIGNED_BYTE},          // A8
+			{GL_RGBA,                GL_RGBA,            GL_UNSIGNED_BYTE},          // ETC1 (decoded)
+			{GL_RGBA,                GL_RGBA,            GL_UNSIGNED_BYTE},          // ETC1A4 (decoded)
+		};
+		return formats[format];
+	}
+
+	// Upload RGBA pixels to the bound texture, converted
+	// the same way they would be on the 3DS
+	void uploadPixels(cpp3ds::Texture::Format format, int level, int x, int y, int width, int height, const cpp3ds::Uint8* pixels, int pitch)
+	{
+		if (format == cpp3ds::Texture::RGBA8)
+		{
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch / 4));
+			glCheck(glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+			glCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+			return;
+		}
+
+		if (format == cpp3ds::Texture::ETC1 || format == cpp3ds::Texture::ETC1A4)
+		{
+			// Desktop OpenGL has no ETC1, upload what the 3DS would decode instead
+			unsigned int tiledWidth = (width + 7) & ~7u;
+			unsigned int tiledHeight = (height + 7) & ~7u;
+			std::vector<cpp3ds::Uint8> blocks(tiledWidth * tiledHeight * cpp3ds::priv::getBitsPerPixel(format) / 8);
+			std::vector<cpp3ds::Uint8> decoded(width * height * 4);
+			cpp3ds::priv::tileImage(&blocks[0], pixels, 0, 0, width, height, pitch, tiledWidth, tiledHeight, format);
+			cpp3ds::priv::untileImage(&decoded[0], &blocks[0], 0, 0, width, height, width * 4, tiledWidth, tiledHeight, format);
+			glCheck(glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &decoded[0]));
+			return;
+		}
+
+		std::size_t rowSize = width * cpp3ds::priv::getBitsPerPixel(format) / 8;
+		std::vector<cpp3ds::Uint8> texels(rowSize * height);
+		for (int i = 0; i < height; ++i)
+			cpp3ds::priv::convertPixels(&texels[i * rowSize], pixels + i * pitch, width, format);
+
+		// The 3DS stores alpha before luminance, OpenGL wants it after
+		if (format == cpp3ds::Texture::LA8)
+			for (std::size_t i = 0; i < texels.size(); i += 2)
+				std::swap(texels[i], texels[i + 1]);
+
+		GlFormat glFormat = getGlFormat(format);
+		glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+		glCheck(glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, glFormat.format, glFormat.type, &texels[0]));
+		glCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	}
+
+	// Pick the compressed format suited to an image
+	cpp3ds::Texture::Format getCompressedFormat(const cpp3ds::Image& image)
+	{
+		const cpp3ds::Uint8* pixels = image.getPixelsPtr();
+		std::size_t size = image.getSize().x * image.getSize().y * 4;
+		for (std::size_t i = 3; i < size; i += 4)
+			if (pixels[i] != 255)
+				return cpp3ds::Texture::ETC1A4;
+		return cpp3ds::Texture::ETC1;
+	}
 }
 
 
@@ -78,12 +161,20 @@ Texture::Texture() :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (0),
+m_format       (RGBA8),
 m_isSmooth     (false),
 m_isRepeated   (false),
+m_hasMipmap    (false),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
 {
-
+    TextureCache::add(*this);
 }
 
 
@@ -92,19 +183,85 @@ Texture::Texture(const Texture& copy) :
 m_size         (0, 0),
 m_actualSize   (0, 0),
 m_texture      (0),
+m_format       (RGBA8),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
+m_hasMipmap    (false),
+m_pixelsFlipped(false),
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
+{
+    TextureCache::add(*this);
+
+    if (copy.m_isEvicted)
+    {
+        // Share the source, the copy will be loaded when it's bound
+        m_size         = copy.m_size;
+        m_actualSize   = copy.m_actualSize;
+        m_format       = copy.m_format;
+        m_hasMipmap    = copy.m_hasMipmap;
+        m_retainedData = copy.m_retainedData;
+        m_isEvicted    = true;
+    }
+    else if (copy.m_texture)
+    {
+        loadFromImage(copy.copyToImage(), IntRect(), copy.m_format);
+        if (copy.m_hasMipmap)
+            generateMipmap();
+    }
+
+    m_sourceFile     = copy.m_sourceFile;
+    m_sourceArea     = copy.m_sourceArea;
+    m_isPreprocessed = copy.m_isPreprocessed;
+    m_sourceIndex    = copy.m_sourceIndex;
+}
+
+
+////////////////////////////////////////////////////////////
+Texture::Texture(Texture&& other) noexcept :
+m_size         (0, 0),
+m_actualSize   (0, 0),
+m_texture      (0),
+m_format       (RGBA8),
+m_isSmooth     (false),
+m_isRepeated   (false),
+m_hasMipmap    (false),
 m_pixelsFlipped(false),
-m_cacheId      (getUniqueId())
+m_cacheId      (getUniqueId()),
+m_isPreprocessed(false),
+m_sourceIndex  (0),
+m_isEvicted    (false),
+m_lastUse      (0),
+m_isLoading    (false),
+m_batchTarget  (NULL)
 {
-    if (copy.m_texture)
-        loadFromImage(copy.copyToImage());
+    other.flushBatch();
+
+    TextureCache::add(*this);
+    TextureCache::move(other, *this);
+
+    if (other.m_isLoading)
+        TextureLoader::move(other, *this);
+    else
+        moveFrom(other);
 }
 
 
 ////////////////////////////////////////////////////////////
 Texture::~Texture()
 {
+    flushBatch();
+
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    TextureCache::remove(*this);
+
     // Destroy the OpenGL texture
     if (m_texture)
     {
@@ -117,8 +274,11 @@ Texture::~Texture()
 
 
 ////////////////////////////////////////////////////////////
-bool Texture::create(unsigned int width, unsigned int height)
+bool Texture::create(unsigned int width, unsigned int height, Format format)
 {
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
     // Check if texture parameters are valid before creating it
     if ((width == 0) || (height == 0))
     {
@@ -144,7 +304,13 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.x        = width;
     m_size.y        = height;
     m_actualSize    = actualSize;
+    m_format        = (format == Compressed) ? ETC1A4 : format;
+    m_hasMipmap     = false;
     m_pixelsFlipped = false;
+    m_isEvicted     = false;
+    m_sourceFile.clear();
+    m_isPreprocessed = false;
+    std::vector<Uint8>().swap(m_retainedData);
 
 	ensureGlContext();
 
@@ -161,11 +327,13 @@ bool Texture::create(unsigned int width, unsigned int height)
 
     // Initialize the texture
 	glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-	glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+	GlFormat glFormat = getGlFormat(m_format);
+	glCheck(glTexImage2D(GL_TEXTURE_2D, 0, glFormat.internalFormat, m_actualSize.x, m_actualSize.y, 0, glFormat.format, glFormat.type, NULL));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
 	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
 
     m_cacheId = getUniqueId();
 
@@ -177,7 +345,21 @@ bool Texture::create(unsigned int width, unsigned int height)
 bool Texture::loadFromFile(const std::string& filename, const IntRect& area)
 {
     Image image;
-    return image.loadFromFile(filename) && loadFromImage(image, area);
+    if (!image.loadFromFile(filename, area) || !loadFromImage(image))
+        return false;
+
+    // Remember where the pixels come from, in case the texture is evicted
+    m_sourceFile = filename;
+    m_sourceArea = area;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromFileAsync(const std::string& filename, const IntRect& area, Format format)
+{
+    return TextureLoader::load(*this, filename, area, format, NULL);
 }
 
 
@@ -197,8 +379,18 @@ bool Texture::loadFromStream(InputStream& stream, const IntRect& area)
 }
 
 ////////////////////////////////////////////////////////////
-bool Texture::loadFromImage(const Image& image, const IntRect& area)
+bool Texture::loadFromImage(const Image& image, Format format)
 {
+    return loadFromImage(image, IntRect(), format);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromImage(const Image& image, const IntRect& area, Format format)
+{
+    if (format == Compressed)
+        format = getCompressedFormat(image);
+
     // Retrieve the image size
     int width = static_cast<int>(image.getSize().x);
     int height = static_cast<int>(image.getSize().y);
@@ -208,7 +400,7 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
        ((area.left <= 0) && (area.top <= 0) && (area.width >= width) && (area.height >= height)))
     {
         // Load the entire image
-        if (create(image.getSize().x, image.getSize().y))
+        if (create(image.getSize().x, image.getSize().y, format))
         {
             update(image);
             // Force an OpenGL flush, so that the texture will appear updated
@@ -226,26 +418,18 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
         // Load a sub-area of the image
 
         // Adjust the rectangle to the size of the image
-        IntRect rectangle = area;
-        if (rectangle.left   < 0) rectangle.left = 0;
-        if (rectangle.top    < 0) rectangle.top  = 0;
-        if (rectangle.left + rectangle.width > width)  rectangle.width  = width - rectangle.left;
-        if (rectangle.top + rectangle.height > height) rectangle.height = height - rectangle.top;
+        IntRect rectangle = priv::ImageLoader::clampArea(area, image.getSize());
 
         // Create the texture and upload the pixels
-        if (create(rectangle.width, rectangle.height))
+        if (create(rectangle.width, rectangle.height, format))
         {
             // Make sure that the current texture binding will be preserved
             priv::TextureSaver save;
 
-            // Copy the pixels to the texture, row by row
+            // Copy the pixels to the texture, skipping the rest of each image row
             const Uint8* pixels = image.getPixelsPtr() + 4 * (rectangle.left + (width * rectangle.top));
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-            for (int i = 0; i < rectangle.height; ++i)
-            {
-                glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, rectangle.width, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
-                pixels += 4 * width;
-            }
+            uploadPixels(m_format, 0, 0, 0, rectangle.width, rectangle.height, pixels, 4 * width);
 
             // Force an OpenGL flush, so that the texture will appear updated
             // in all contexts immediately (solves problems in multi-threaded apps)
@@ -268,9 +452,27 @@ Vector2u Texture::getSize() const
 }
 
 
+////////////////////////////////////////////////////////////
+Texture::Format Texture::getFormat() const
+{
+    return m_format;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::isLoading() const
+{
+    return m_isLoading;
+}
+
+
 ////////////////////////////////////////////////////////////
 Image Texture::copyToImage() const
 {
+    // Bring back the pixels if the texture cache evicted them
+    if (m_isEvicted)
+        const_cast<Texture*>(this)->restore();
+
     // Easy case: empty texture
     if (!m_texture)
         return Image();
@@ -336,6 +538,11 @@ Image Texture::copyToImage() const
 		}
 	}
 #endif
+    // Alpha textures read back black, the 3DS ones read back white
+    if (m_format == A8)
+        for (std::size_t i = 0; i < pixels.size(); i += 4)
+            pixels[i] = pixels[i + 1] = pixels[i + 2] = 255;
+
     // Create the image
     Image image;
     image.create(m_size.x, m_size.y, &pixels[0]);
@@ -344,6 +551,80 @@ Image Texture::copyToImage() const
 }
 
 
+
+////////////////////////////////////////////////////////////
+Image Texture::copyToImage(const IntRect& area) const
+{
+    if (area.width <= 0 || area.height <= 0)
+        return Image();
+
+    // Create an array of pixels
+    std::vector<Uint8> pixels(area.width * area.height * 4);
+    if (!readPixels(area, &pixels[0]))
+        return Image();
+
+    // Create the image
+    Image image;
+    image.create(area.width, area.height, &pixels[0]);
+
+    return image;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::readPixels(const IntRect& area, Uint8* pixels) const
+{
+    // Bring back the pixels if the texture cache evicted them
+    if (m_isEvicted)
+        const_cast<Texture*>(this)->restore();
+
+    // Easy case: empty texture
+    if (!m_texture)
+        return false;
+
+    if ((area.left < 0) || (area.top < 0) || (area.width <= 0) || (area.height <= 0) ||
+        (static_cast<unsigned int>(area.left + area.width) > m_size.x) ||
+        (static_cast<unsigned int>(area.top + area.height) > m_size.y))
+    {
+        err() << "Failed to read texture pixels, the area is outside of the texture" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Desktop OpenGL can only read whole textures, the area is copied from there
+    std::vector<Uint8> allPixels(m_actualSize.x * m_actualSize.y * 4);
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &allPixels[0]));
+
+    int srcPitch = m_actualSize.x * 4;
+    int dstPitch = area.width * 4;
+    const Uint8* src = &allPixels[(area.top * m_actualSize.x + area.left) * 4];
+
+    // Handle the case where source pixels are flipped vertically
+    if (m_pixelsFlipped)
+    {
+        src = &allPixels[((m_size.y - 1 - area.top) * m_actualSize.x + area.left) * 4];
+        srcPitch = -srcPitch;
+    }
+
+    for (int i = 0; i < area.height; ++i)
+    {
+        std::memcpy(pixels + i * dstPitch, src, dstPitch);
+        src += srcPitch;
+    }
+
+    // Alpha textures read back black, the 3DS ones read back white
+    if (m_format == A8)
+        for (int i = 0; i < area.width * area.height * 4; i += 4)
+            pixels[i] = pixels[i + 1] = pixels[i + 2] = 255;
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////
 void Texture::update(const Uint8* pixels)
 {
@@ -358,6 +639,13 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
     assert(x + width <= m_size.x);
     assert(y + height <= m_size.y);
 
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
+    // The pixels must be updated on top of the evicted ones
+    if (m_isEvicted)
+        restore();
+
     if (pixels && m_texture)
     {
 		ensureGlContext();
@@ -367,13 +655,46 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
 
         // Copy pixels from the given array to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        uploadPixels(m_format, 0, x, y, width, height, pixels, width * 4);
+
+        // Keep the smaller levels in sync with the base one
+        if (m_hasMipmap)
+            generateMipmap();
+
+        // The texture doesn't match its source anymore, it can't be evicted
+        m_sourceFile.clear();
+        m_isPreprocessed = false;
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
     }
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::updateTexels(const Uint8* texels, unsigned int width, unsigned int height, unsigned int pitch, unsigned int x, unsigned int y)
+{
+    if (!texels || !m_texture)
+        return;
+
+    if ((m_format == ETC1) || (m_format == ETC1A4))
+    {
+        err() << "Failed to update texture, its texels can't be written directly" << std::endl;
+        return;
+    }
+
+    // Go through the 3DS layout to get the pixels it would sample
+    unsigned int tiledWidth = (width + 7) & ~7u;
+    unsigned int tiledHeight = (height + 7) & ~7u;
+    unsigned int bitsPerPixel = priv::getBitsPerPixel(m_format);
+    std::vector<Uint8> tiled(tiledWidth * tiledHeight * bitsPerPixel / 8);
+    std::vector<Uint8> pixels(width * height * 4);
+    priv::tileImage(&tiled[0], texels, 0, 0, width, height, pitch, tiledWidth, tiledHeight, bitsPerPixel);
+    priv::untileImage(&pixels[0], &tiled[0], 0, 0, width, height, width * 4, tiledWidth, tiledHeight, m_format);
+
+    update(&pixels[0], width, height, x, y);
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::update(const Image& image)
 {
@@ -410,6 +731,8 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
         // Copy pixels from the back-buffer to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
+        m_sourceFile.clear();
+        m_isPreprocessed = false;
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
     }
@@ -432,7 +755,9 @@ void Texture::setSmooth(bool smooth)
 
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
             glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+            GLint minFilter = m_hasMipmap ? (m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR)
+                                          : (m_isSmooth ? GL_LINEAR : GL_NEAREST);
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
         }
     }
 }
@@ -474,15 +799,69 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (m_isEvicted)
+        restore();
+
+    if (!m_texture)
+        return false;
+
+	ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Read back the base level, it already holds the 3DS conversion losses
+    unsigned int width = m_actualSize.x;
+    unsigned int height = m_actualSize.y;
+    std::vector<Uint8> pixels(width * height * 4);
+    std::vector<Uint8> smaller(pixels.size() / 4);
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+
+    // Build the same chain as the 3DS: box filter, down to 8x8
+    GlFormat glFormat = getGlFormat(m_format);
+    unsigned int levels = priv::getMipmapLevelCount(width, height);
+    for (unsigned int i = 1; i < levels; ++i)
+    {
+        priv::halveImage(&smaller[0], &pixels[0], width, height);
+        width /= 2;
+        height /= 2;
+
+        glCheck(glTexImage2D(GL_TEXTURE_2D, i, glFormat.internalFormat, width, height, 0, glFormat.format, glFormat.type, NULL));
+        uploadPixels(m_format, i, 0, 0, width, height, &smaller[0], width * 4);
+
+        pixels.swap(smaller);
+    }
+
+	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+	glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR));
+
+    m_hasMipmap = true;
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
 	ensureGlContext();
 
+    // Record the use, and reload the texture if it was evicted
+    if (texture)
+        TextureCache::use(*texture);
+
     if (texture && texture->m_texture)
     {
+        // Show the placeholder until the background load is finished
+        const Texture* source = texture->m_isLoading ? &TextureLoader::getPlaceholder() : texture;
+
         // Bind the texture
-        glCheck(glBindTexture(GL_TEXTURE_2D, texture->m_texture));
+        glCheck(glBindTexture(GL_TEXTURE_2D, source->m_texture));
 
         // Check if we need to define a special texture matrix
         if ((coordinateType == Pixels) || texture->m_pixelsFlipped)
@@ -545,20 +924,257 @@ unsigned int Texture::getMaximumSize()
 ////////////////////////////////////////////////////////////
 Texture& Texture::operator =(const Texture& right)
 {
+    flushBatch();
+
+    if (m_isLoading)
+        TextureLoader::cancel(*this);
+
     Texture temp(right);
 
     std::swap(m_size,          temp.m_size);
     std::swap(m_actualSize,    temp.m_actualSize);
     std::swap(m_texture,       temp.m_texture);
+    std::swap(m_format,        temp.m_format);
     std::swap(m_isSmooth,      temp.m_isSmooth);
     std::swap(m_isRepeated,    temp.m_isRepeated);
+    std::swap(m_hasMipmap,     temp.m_hasMipmap);
     std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
+    std::swap(m_sourceFile,    temp.m_sourceFile);
+    std::swap(m_sourceArea,    temp.m_sourceArea);
+    std::swap(m_isPreprocessed,temp.m_isPreprocessed);
+    std::swap(m_sourceIndex,   temp.m_sourceIndex);
+    std::swap(m_isEvicted,     temp.m_isEvicted);
+    std::swap(m_retainedData,  temp.m_retainedData);
     m_cacheId = getUniqueId();
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+Texture& Texture::operator =(Texture&& right) noexcept
+{
+    if (this != &right)
+    {
+        flushBatch();
+        right.flushBatch();
+
+        if (m_isLoading)
+            TextureLoader::cancel(*this);
+
+        if (m_texture)
+        {
+            ensureGlContext();
+
+            GLuint texture = static_cast<GLuint>(m_texture);
+            glCheck(glDeleteTextures(1, &texture));
+            m_texture = 0;
+        }
+
+        TextureCache::move(right, *this);
+
+        if (right.m_isLoading)
+            TextureLoader::move(right, *this);
+        else
+            moveFrom(right);
+    }
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::moveFrom(Texture& other)
+{
+    m_size           = other.m_size;
+    m_actualSize     = other.m_actualSize;
+    m_texture        = other.m_texture;
+    m_format         = other.m_format;
+    m_isSmooth       = other.m_isSmooth;
+    m_isRepeated     = other.m_isRepeated;
+    m_hasMipmap      = other.m_hasMipmap;
+    m_pixelsFlipped  = other.m_pixelsFlipped;
+    m_sourceFile     = std::move(other.m_sourceFile);
+    m_sourceArea     = other.m_sourceArea;
+    m_isPreprocessed = other.m_isPreprocessed;
+    m_sourceIndex    = other.m_sourceIndex;
+    m_isEvicted      = other.m_isEvicted;
+    m_retainedData   = std::move(other.m_retainedData);
+    m_isLoading      = other.m_isLoading;
+
+    // Render targets must not mistake either of them for what they cached
+    m_cacheId       = getUniqueId();
+    other.m_cacheId = getUniqueId();
+
+    other.m_size           = Vector2u(0, 0);
+    other.m_actualSize     = Vector2u(0, 0);
+    other.m_texture        = 0;
+    other.m_hasMipmap      = false;
+    other.m_pixelsFlipped  = false;
+    other.m_sourceFile.clear();
+    other.m_sourceArea     = IntRect();
+    other.m_isPreprocessed = false;
+    other.m_sourceIndex    = 0;
+    other.m_isEvicted      = false;
+    other.m_retainedData.clear();
+    other.m_isLoading      = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::flushBatch() const
+{
+    if (m_batchTarget)
+        m_batchTarget->flush();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::grow(unsigned int width, unsigned int height, const Color& color)
+{
+    if (!m_texture || m_isLoading || (width < m_size.x) || (height < m_size.y))
+        return false;
+
+    if (m_isEvicted && !restore())
+        return false;
+
+    // The emulator has no tiles to copy, go through an image
+    Image image;
+    image.create(width, height, color);
+    image.copy(copyToImage(), 0, 0);
+
+    Format format = m_format;
+    if (!create(width, height, format))
+        return false;
+    update(image);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t Texture::getMemorySize() const
+{
+    if (!m_texture)
+        return 0;
+
+    // Count what the texture takes on the 3DS, not in the emulator's OpenGL
+    unsigned int levels = m_hasMipmap ? priv::getMipmapLevelCount(m_actualSize.x, m_actualSize.y) : 1;
+    std::size_t size = 0;
+    for (unsigned int i = 0; i < levels; ++i)
+        size += (m_actualSize.x >> i) * (m_actualSize.y >> i) * priv::getBitsPerPixel(m_format) / 8;
+
+    return size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::evict()
+{
+    // The loader thread may be writing the pixels
+    if (m_isLoading)
+        return false;
+
+    if (!m_texture)
+        return false;
+
+    if (m_sourceFile.empty())
+    {
+        // Without a file to reload, only compressed data is worth keeping in main memory.
+        // The emulator stores it decoded, keep the pixels as they are.
+        if (m_format != ETC1 && m_format != ETC1A4)
+            return false;
+
+        Image image = copyToImage();
+        m_retainedData.assign(image.getPixelsPtr(), image.getPixelsPtr() + m_size.x * m_size.y * 4);
+    }
+
+	ensureGlContext();
+
+    GLuint texture = static_cast<GLuint>(m_texture);
+    glCheck(glDeleteTextures(1, &texture));
+    m_texture = 0;
+
+    // Render targets must bind the texture again, so that it gets reloaded
+    m_isEvicted = true;
+    m_cacheId = getUniqueId();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::restore()
+{
+    if (!m_isEvicted)
+        return m_texture != 0;
+
+    // Loading resets the source, keep it to evict the texture again later
+    std::string filename = m_sourceFile;
+    IntRect area = m_sourceArea;
+    bool mipmap = m_hasMipmap;
+    bool success;
+
+    if (!m_retainedData.empty())
+    {
+        std::vector<Uint8> pixels;
+        pixels.swap(m_retainedData);
+
+        // The pixels are already decoded, upload them without compressing again
+        success = create(m_size.x, m_size.y, m_format);
+        if (success)
+        {
+            priv::TextureSaver save;
+            glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+            glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_size.x, m_size.y, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+            success = !mipmap || generateMipmap();
+        }
+    }
+    else
+    {
+        Image image;
+        success = image.loadFromFile(filename) && loadFromImage(image, area, m_format) &&
+                  (!mipmap || generateMipmap());
+    }
+
+    if (!success)
+    {
+        // Give up rather than retrying on every bind, the texture stays empty
+        err() << "Failed to reload evicted texture " << filename << std::endl;
+        m_isEvicted = false;
+        std::vector<Uint8>().swap(m_retainedData);
+        return false;
+    }
+
+    m_sourceFile = filename;
+    m_sourceArea = area;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::prepareLoad(const Uint8* pixels, unsigned int pitch)
+{
+    // OpenGL calls must stay on the rendering thread, the pixels are uploaded by finishLoad
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::finishLoad(const Uint8* pixels, unsigned int pitch)
+{
+	ensureGlContext();
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    uploadPixels(m_format, 0, 0, 0, m_size.x, m_size.y, pixels, pitch);
+
+    m_cacheId = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
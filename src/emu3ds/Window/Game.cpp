@@ -4,6 +4,9 @@
 #include <cpp3ds/Window/EventManager.hpp>
 #include <cpp3ds/System/Clock.hpp>
 #include <cpp3ds/Window/Keyboard.hpp>
+#include <cpp3ds/Graphics/FrameAllocator.hpp>
+#include <cpp3ds/Graphics/TextureCache.hpp>
+#include <cpp3ds/Graphics/TextureLoader.hpp>
 #include <cpp3ds/Graphics/Sprite.hpp>
 #include "../Audio/AudioDevice.hpp"
 
@@ -45,6 +48,7 @@ void Game::render()
 	// Top Screen
 	m_frameTextureTop.setActive(true);
 	renderTopScreen(windowTop);
+	windowTop.flush();
 	m_frameTextureTop.display();
 	m_frameSpriteTop.setTexture(m_frameTextureTop.getTexture());
 	_emulator->screen->draw(m_frameSpriteTop);
@@ -52,10 +56,15 @@ void Game::render()
 	// Bottom Screen
 	m_frameTextureBottom.setActive(true);
 	renderBottomScreen(windowBottom);
+	windowBottom.flush();
 	m_frameTextureBottom.display();
 	m_frameSpriteBottom.setTexture(m_frameTextureBottom.getTexture());
 	_emulator->screen->draw(m_frameSpriteBottom);
 #endif
+
+	FrameAllocator::nextFrame();
+	TextureCache::nextFrame();
+	TextureLoader::update();
 }
 
 
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/DistanceField.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	int coverageAt(const std::vector<Uint8>& coverage, int width, int height, int x, int y)
+	{
+		if ((x < 0) || (y < 0) || (x >= width) || (y >= height))
+			return 0;
+		return coverage[x + y * width];
+	}
+
+	// Exhaustive search over every pixel within spread, as done before the neighbour table
+	std::vector<Uint8> referenceField(const std::vector<Uint8>& coverage, int width, int height, int spread)
+	{
+		int fieldWidth = width + 2 * spread;
+		int fieldHeight = height + 2 * spread;
+		std::vector<Uint8> field(fieldWidth * fieldHeight);
+
+		for (int y = 0; y < fieldHeight; ++y)
+		{
+			for (int x = 0; x < fieldWidth; ++x)
+			{
+				int value = coverageAt(coverage, width, height, x - spread, y - spread);
+
+				float distance;
+				if ((value > 0) && (value < 255))
+					distance = (value - 127.5f) / 255.f;
+				else
+				{
+					bool inside = (value == 255);
+					distance = static_cast<float>(spread);
+					for (int dy = -spread; dy <= spread; ++dy)
+					{
+						for (int dx = -spread; dx <= spread; ++dx)
+						{
+							int other = coverageAt(coverage, width, height, x - spread + dx, y - spread + dy);
+							if (other == value)
+								continue;
+							float across = (other - 127.5f) / 255.f;
+							float candidate = std::sqrt(static_cast<float>(dx * dx + dy * dy)) + (inside ? across : -across);
+							distance = std::min(distance, candidate);
+						}
+					}
+					if (!inside)
+						distance = -distance;
+				}
+
+				float level = 127.5f + distance * 127.5f / spread + 0.5f;
+				field[x + y * fieldWidth] = static_cast<Uint8>(std::min(std::max(level, 0.f), 255.f));
+			}
+		}
+
+		return field;
+	}
+
+	std::vector<Uint8> computeField(const std::vector<Uint8>& coverage, int width, int height, int spread)
+	{
+		std::vector<Uint8> field((width + 2 * spread) * (height + 2 * spread));
+		priv::computeDistanceField(&coverage[0], width, height, spread, &field[0]);
+		return field;
+	}
+
+	// Anti-aliased disc, off-center so that mirroring changes it
+	std::vector<Uint8> makeDisc(int width, int height)
+	{
+		std::vector<Uint8> coverage(width * height);
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				float dx = x + 0.5f - width * 0.4f;
+				float dy = y + 0.5f - height * 0.6f;
+				float level = (width * 0.3f - std::sqrt(dx * dx + dy * dy)) * 255.f + 127.5f;
+				coverage[x + y * width] = static_cast<Uint8>(std::min(std::max(level, 0.f), 255.f));
+			}
+		}
+		return coverage;
+	}
+}
+
+
+TEST(DistanceField, StraightEdge)
+{
+	// Covered on the left, half covered column at x = 12, empty on the right
+	const int spread = 4;
+	const int width = 24;
+	const int height = 2 * spread + 1;
+	const int edge = 12;
+
+	std::vector<Uint8> coverage(width * height);
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			coverage[x + y * width] = (x < edge) ? 255 : (x == edge) ? 128 : 0;
+
+	std::vector<Uint8> field = computeField(coverage, width, height, spread);
+	const int fieldWidth = width + 2 * spread;
+	const Uint8* row = &field[(spread + height / 2) * fieldWidth + spread];
+
+	EXPECT_EQ(128, row[edge]);
+	EXPECT_EQ(255, row[edge - spread]);
+	EXPECT_EQ(0, row[edge + spread]);
+
+	// Levels move away from the edge at the same rate on both sides
+	for (int distance = 1; distance < spread; ++distance)
+	{
+		EXPECT_GT(row[edge - distance], row[edge - distance + 1]);
+		EXPECT_LT(row[edge + distance], row[edge + distance - 1]);
+		EXPECT_NEAR(255, row[edge - distance] + row[edge + distance], 1) << distance;
+	}
+}
+
+
+TEST(DistanceField, MirroredCoverage)
+{
+	const int spread = 5;
+	const int width = 21;
+	const int height = 17;
+	const int fieldWidth = width + 2 * spread;
+	const int fieldHeight = height + 2 * spread;
+
+	std::vector<Uint8> coverage = makeDisc(width, height);
+	std::vector<Uint8> flipped(coverage.size());
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			flipped[(width - 1 - x) + (height - 1 - y) * width] = coverage[x + y * width];
+
+	std::vector<Uint8> field = computeField(coverage, width, height, spread);
+	std::vector<Uint8> flippedField = computeField(flipped, width, height, spread);
+	for (int y = 0; y < fieldHeight; ++y)
+		for (int x = 0; x < fieldWidth; ++x)
+			ASSERT_EQ(field[x + y * fieldWidth], flippedField[(fieldWidth - 1 - x) + (fieldHeight - 1 - y) * fieldWidth]) << x << "," << y;
+}
+
+
+TEST(DistanceField, MatchesExhaustiveSearch)
+{
+	const int width = 19;
+	const int height = 23;
+
+	std::vector<Uint8> coverage = makeDisc(width, height);
+	for (int i = 0; i < width * height; i += 13)
+		coverage[i] = static_cast<Uint8>(i * 37);
+
+	for (int spread = 1; spread <= 8; ++spread)
+		EXPECT_EQ(referenceField(coverage, width, height, spread), computeField(coverage, width, height, spread)) << spread;
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Resources.hpp>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	bool loadDefaultFont(Font& font)
+	{
+		priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+		return font.loadFromMemory(resource.data, resource.size);
+	}
+}
+
+
+TEST(Font, PreloadedGlyphsAreReused)
+{
+	Font font;
+	ASSERT_TRUE(loadDefaultFont(font));
+
+	String characters = Font::getLatin1Characters();
+	EXPECT_EQ(characters.getSize(), font.preloadGlyphs(characters, 24));
+	EXPECT_EQ(0u, font.preloadGlyphs(characters, 24));
+
+	// The glyphs are packed like they would be one at a time
+	Font reference;
+	ASSERT_TRUE(loadDefaultFont(reference));
+	for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
+		reference.getGlyph(*it, 24, false);
+
+	// The texture is written when it's requested, then getGlyph doesn't add anything to it
+	Vector2u size = font.getTexture(24).getSize();
+	EXPECT_EQ(reference.getTexture(24).getSize(), size);
+	for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
+		EXPECT_EQ(reference.getGlyph(*it, 24, false).textureRect, font.getGlyph(*it, 24, false).textureRect);
+	EXPECT_EQ(size, font.getTexture(24).getSize());
+}
+
+
+TEST(Font, AsciiGlyphsFollowTheirSize)
+{
+	Font font;
+	ASSERT_TRUE(loadDefaultFont(font));
+
+	// Switching sizes back and forth gives the glyph of each size
+	Glyph small = font.getGlyph('a', 16, false);
+	Glyph large = font.getGlyph('a', 32, false);
+	EXPECT_GT(large.advance, small.advance);
+	EXPECT_EQ(small.bounds, font.getGlyph('a', 16, false).bounds);
+	EXPECT_EQ(small.textureRect, font.getGlyph('a', 16, false).textureRect);
+	EXPECT_EQ(&font.getGlyph('a', 16, false), &font.getGlyph('a', 16, false));
+
+	// Bold and regular glyphs don't share their entry
+	Glyph bold = font.getGlyph('a', 16, true);
+	EXPECT_GT(bold.advance, small.advance);
+	EXPECT_NE(small.textureRect, bold.textureRect);
+	EXPECT_EQ(small.advance, font.getGlyph('a', 16, false).advance);
+	EXPECT_EQ(bold.advance, font.getGlyph('a', 16, true).advance);
+
+	// Loading another font drops the glyphs of the previous one
+	ASSERT_TRUE(font.loadFromFile("sansation.ttf"));
+	Font sansation;
+	ASSERT_TRUE(sansation.loadFromFile("sansation.ttf"));
+	EXPECT_EQ(sansation.getGlyph('a', 16, false).advance, font.getGlyph('a', 16, false).advance);
+	EXPECT_EQ(sansation.getGlyph('a', 16, false).bounds, font.getGlyph('a', 16, false).bounds);
+
+	// So does switching to a distance field
+	font.setDistanceField(true, 32);
+	sansation.setDistanceField(true, 32);
+	EXPECT_EQ(sansation.getGlyph('a', 16, false).bounds, font.getGlyph('a', 16, false).bounds);
+	EXPECT_EQ(sansation.getGlyph('a', 16, false).textureRect, font.getGlyph('a', 16, false).textureRect);
+}
+
+
+TEST(Font, KerningIsCached)
+{
+	// Unlike the default font, this one has a kern table
+	Font font;
+	ASSERT_TRUE(font.loadFromFile("sansation.ttf"));
+
+	const char* pairs[] = {"AV", "VA", "To", "LT", "Wa", "ab"};
+	const unsigned int sizes[] = {12, 16, 30};
+	const std::size_t pairCount = sizeof(pairs) / sizeof(pairs[0]);
+	const std::size_t sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+
+	std::vector<float> values;
+	for (std::size_t i = 0; i < pairCount; ++i)
+		for (std::size_t j = 0; j < sizeCount; ++j)
+			values.push_back(font.getKerning(pairs[i][0], pairs[i][1], sizes[j]));
+
+	EXPECT_LT(font.getKerning('A', 'V', 30), 0.f);
+	EXPECT_LT(font.getKerning('A', 'V', 30), font.getKerning('A', 'V', 12));
+
+	// The cached values, and the ones of a font looking them up in
+	// another order, are the same
+	Font other;
+	ASSERT_TRUE(other.loadFromFile("sansation.ttf"));
+	for (std::size_t n = values.size(); n-- > 0; )
+	{
+		const char* pair = pairs[n / sizeCount];
+		unsigned int size = sizes[n % sizeCount];
+		EXPECT_EQ(values[n], other.getKerning(pair[0], pair[1], size));
+		EXPECT_EQ(values[n], font.getKerning(pair[0], pair[1], size));
+	}
+}
+
+
+TEST(Font, MoveConstructionKeepsPages)
+{
+	Font font;
+	ASSERT_TRUE(loadDefaultFont(font));
+	const Glyph* glyph = &font.getGlyph('A', 24, false);
+	const Glyph* accented = &font.getGlyph(0xE9, 24, false);
+	const Texture* texture = &font.getTexture(24);
+	IntRect rect = glyph->textureRect;
+
+	Font moved(std::move(font));
+
+	// The pages are handed over, not copied
+	EXPECT_EQ(texture, &moved.getTexture(24));
+	EXPECT_EQ(glyph, &moved.getGlyph('A', 24, false));
+	EXPECT_EQ(accented, &moved.getGlyph(0xE9, 24, false));
+	EXPECT_EQ(rect, moved.getGlyph('A', 24, false).textureRect);
+	EXPECT_FALSE(moved.getInfo().family.empty());
+
+	// The source is left empty
+	EXPECT_TRUE(font.getInfo().family.empty());
+	EXPECT_EQ(0.f, font.getGlyph('A', 24, false).advance);
+	EXPECT_EQ(0.f, font.getKerning('A', 'V', 24));
+}
+
+
+TEST(Font, MoveAssignmentKeepsPages)
+{
+	Font font;
+	ASSERT_TRUE(loadDefaultFont(font));
+	const Glyph* glyph = &font.getGlyph('A', 24, false);
+	const Texture* texture = &font.getTexture(24);
+
+	Font moved;
+	ASSERT_TRUE(loadDefaultFont(moved));
+	moved.getGlyph('B', 12, false);
+	moved = std::move(font);
+
+	EXPECT_EQ(texture, &moved.getTexture(24));
+	EXPECT_EQ(glyph, &moved.getGlyph('A', 24, false));
+	EXPECT_FALSE(moved.getInfo().family.empty());
+
+	EXPECT_TRUE(font.getInfo().family.empty());
+	EXPECT_EQ(0.f, font.getGlyph('A', 24, false).advance);
+}
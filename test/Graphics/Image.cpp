@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/Image.hpp>
+#include <cpp3ds/Graphics/ImageLoader.hpp>
+#include <cpp3ds/Graphics/Texture.hpp>
+#include <cpp3ds/Graphics/TextureLoader.hpp>
+#include <cpp3ds/System/FileSystem.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace cpp3ds;
+
+// Containers only move their elements when this holds, they copy them otherwise
+static_assert(std::is_nothrow_move_constructible<Image>::value, "Image must be nothrow movable");
+static_assert(std::is_nothrow_move_assignable<Image>::value, "Image must be nothrow move assignable");
+static_assert(std::is_nothrow_move_constructible<Texture>::value, "Texture must be nothrow movable");
+static_assert(std::is_nothrow_move_assignable<Texture>::value, "Texture must be nothrow move assignable");
+static_assert(std::is_nothrow_move_constructible<Font>::value, "Font must be nothrow movable");
+static_assert(std::is_nothrow_move_assignable<Font>::value, "Font must be nothrow move assignable");
+
+namespace
+{
+	// Saves a test image where each pixel encodes its position
+	Image makeImageFile(const std::string& filename, unsigned int width, unsigned int height)
+	{
+		Image image;
+		image.create(width, height);
+		for (unsigned int y = 0; y < height; ++y)
+			for (unsigned int x = 0; x < width; ++x)
+				image.setPixel(x, y, Color(x, y, 128));
+		image.saveToFile(FileSystem::getFilePath(filename));
+		return image;
+	}
+
+	// JPEG is lossy, the colors are only checked approximately
+	void expectColorNear(const Color& color, float red, float green, float blue)
+	{
+		EXPECT_NEAR(red, color.r, 6.f);
+		EXPECT_NEAR(green, color.g, 6.f);
+		EXPECT_NEAR(blue, color.b, 6.f);
+		EXPECT_EQ(255, color.a);
+	}
+}
+
+
+TEST(Image, MoveConstructionKeepsPixels)
+{
+	Image image;
+	image.create(64, 32, Color::Red);
+	const Uint8* pixels = image.getPixelsPtr();
+
+	Image moved(std::move(image));
+
+	EXPECT_EQ(pixels, moved.getPixelsPtr());
+	EXPECT_EQ(Vector2u(64, 32), moved.getSize());
+	EXPECT_EQ(Color::Red, moved.getPixel(63, 31));
+
+	EXPECT_EQ(Vector2u(0, 0), image.getSize());
+}
+
+
+TEST(Image, MoveAssignmentKeepsPixels)
+{
+	Image image;
+	image.create(16, 16, Color::Blue);
+	const Uint8* pixels = image.getPixelsPtr();
+
+	Image moved;
+	moved.create(8, 8);
+	moved = std::move(image);
+
+	EXPECT_EQ(pixels, moved.getPixelsPtr());
+	EXPECT_EQ(Vector2u(16, 16), moved.getSize());
+	EXPECT_EQ(Vector2u(0, 0), image.getSize());
+}
+
+
+TEST(Image, VectorGrowthMovesImages)
+{
+	std::vector<Image> images(1);
+	images[0].create(32, 32, Color::Green);
+	const Uint8* pixels = images[0].getPixelsPtr();
+
+	// Growing past the capacity relocates the elements
+	images.resize(images.capacity() + 1);
+
+	EXPECT_EQ(pixels, images[0].getPixelsPtr());
+	EXPECT_EQ(Color::Green, images[0].getPixel(0, 0));
+}
+
+
+TEST(Image, LoadAreaIsClamped)
+{
+	// A negative position moves into the image, keeping the size
+	EXPECT_EQ(IntRect(0, 0, 100, 100), priv::ImageLoader::clampArea(IntRect(-10, 0, 100, 100), Vector2u(200, 120)));
+	EXPECT_EQ(IntRect(150, 20, 50, 100), priv::ImageLoader::clampArea(IntRect(150, 20, 100, 500), Vector2u(200, 120)));
+	EXPECT_EQ(IntRect(0, 0, 200, 120), priv::ImageLoader::clampArea(IntRect(-5, -5, 300, 300), Vector2u(200, 120)));
+	EXPECT_EQ(IntRect(0, 0, 200, 120), priv::ImageLoader::clampArea(IntRect(), Vector2u(200, 120)));
+	EXPECT_GE(0, priv::ImageLoader::clampArea(IntRect(250, 0, 10, 10), Vector2u(200, 120)).width);
+
+	Image source = makeImageFile("area.png", 200, 120);
+
+	// Images, textures and background loads all get the same area
+	const IntRect areas[] = {IntRect(-10, 0, 100, 100), IntRect(150, 20, 100, 500)};
+	for (std::size_t i = 0; i < sizeof(areas) / sizeof(areas[0]); ++i)
+	{
+		IntRect rect = priv::ImageLoader::clampArea(areas[i], source.getSize());
+		Vector2u size(rect.width, rect.height);
+
+		Image image;
+		ASSERT_TRUE(image.loadFromFile("area.png", areas[i]));
+		EXPECT_EQ(size, image.getSize());
+		EXPECT_EQ(source.getPixel(rect.left, rect.top), image.getPixel(0, 0));
+		EXPECT_EQ(source.getPixel(rect.left + rect.width - 1, rect.top + rect.height - 1), image.getPixel(size.x - 1, size.y - 1));
+
+		Texture texture;
+		ASSERT_TRUE(texture.loadFromFile("area.png", areas[i]));
+		EXPECT_EQ(size, texture.getSize());
+
+		TextureLoader loader;
+		Texture asyncTexture;
+		ASSERT_TRUE(loader.loadFromFile(asyncTexture, "area.png", areas[i]));
+		EXPECT_EQ(size, asyncTexture.getSize());
+		EXPECT_TRUE(loader.wait());
+		EXPECT_EQ(size, asyncTexture.getSize());
+	}
+
+	// Nothing left of the image
+	Image image;
+	EXPECT_FALSE(image.loadFromFile("area.png", IntRect(250, 0, 10, 10)));
+}
+
+
+TEST(Image, LoadJpegRegions)
+{
+	makeImageFile("gradient.jpg", 256, 192);
+
+	// Whole image
+	Image image;
+	ASSERT_TRUE(image.loadFromFile("gradient.jpg"));
+	EXPECT_EQ(Vector2u(256, 192), image.getSize());
+	expectColorNear(image.getPixel(0, 0), 0, 0, 128);
+	expectColorNear(image.getPixel(100, 50), 100, 50, 128);
+	expectColorNear(image.getPixel(255, 191), 255, 191, 128);
+
+	// Area at an odd offset, only the rows down to it are decoded
+	ASSERT_TRUE(image.loadFromFile("gradient.jpg", IntRect(37, 21, 101, 55)));
+	EXPECT_EQ(Vector2u(101, 55), image.getSize());
+	expectColorNear(image.getPixel(0, 0), 37, 21, 128);
+	expectColorNear(image.getPixel(100, 54), 137, 75, 128);
+
+	// Half size, each pixel is the average of a 2x2 block
+	ASSERT_TRUE(image.loadFromFile("gradient.jpg", IntRect(), 128));
+	EXPECT_EQ(Vector2u(128, 96), image.getSize());
+	expectColorNear(image.getPixel(0, 0), 0.5f, 0.5f, 128);
+	expectColorNear(image.getPixel(50, 40), 100.5f, 80.5f, 128);
+
+	// An eighth, the largest DCT scaling
+	ASSERT_TRUE(image.loadFromFile("gradient.jpg", IntRect(), 32));
+	EXPECT_EQ(Vector2u(32, 24), image.getSize());
+	expectColorNear(image.getPixel(0, 0), 3.5f, 3.5f, 128);
+	expectColorNear(image.getPixel(31, 23), 251.5f, 187.5f, 128);
+
+	// Area and scaling together, the area rounds to the scaled pixels
+	ASSERT_TRUE(image.loadFromFile("gradient.jpg", IntRect(37, 21, 101, 55), 64));
+	EXPECT_EQ(Vector2u(51, 28), image.getSize());
+	expectColorNear(image.getPixel(0, 0), 36.5f, 20.5f, 128);
+}
+
+
+TEST(Image, ReduceRegions)
+{
+	// Lossless, so the cropped and averaged pixels are exact
+	makeImageFile("gradient.png", 64, 48);
+
+	Image image;
+	ASSERT_TRUE(image.loadFromFile("gradient.png", IntRect(5, 3, 20, 11), 8));
+	EXPECT_EQ(Vector2u(5, 3), image.getSize());
+
+	// Averages of 4x4 blocks, rounded
+	EXPECT_EQ(Color(7, 5, 128), image.getPixel(0, 0));
+	EXPECT_EQ(Color(23, 9, 128), image.getPixel(4, 1));
+
+	// The last row only has 3 rows of the area left
+	EXPECT_EQ(Color(7, 12, 128), image.getPixel(0, 2));
+}
+
+
+TEST(Image, DecodeIntoExistingMemory)
+{
+	// Texture memory has room for the pixels only, not for the spare
+	// byte the JPEG decoder asks for
+	makeImageFile("gradient.jpg", 64, 32);
+	makeImageFile("gradient.png", 64, 32);
+	priv::ImageLoader& loader = priv::ImageLoader::getInstance();
+
+	std::vector<Uint8> pixels(64 * 32 * 4);
+	Uint64 copies = priv::ImageLoader::getDecodeCopyCount();
+	ASSERT_TRUE(loader.loadImageFromFile("gradient.jpg", &pixels[0], Vector2u(64, 32)));
+	EXPECT_EQ(copies, priv::ImageLoader::getDecodeCopyCount());
+	expectColorNear(Color(pixels[0], pixels[1], pixels[2], pixels[3]), 0, 0, 128);
+	const Uint8* last = &pixels[pixels.size() - 4];
+	expectColorNear(Color(last[0], last[1], last[2], last[3]), 63, 31, 128);
+
+	ASSERT_TRUE(loader.loadImageFromFile("gradient.png", &pixels[0], Vector2u(64, 32)));
+	EXPECT_EQ(copies, priv::ImageLoader::getDecodeCopyCount());
+	EXPECT_EQ(63, last[0]);
+	EXPECT_EQ(31, last[1]);
+
+	// A size that doesn't match is rejected
+	EXPECT_FALSE(loader.loadImageFromFile("gradient.jpg", &pixels[0], Vector2u(32, 64)));
+}
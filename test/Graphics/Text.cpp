@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Font.hpp>
+#include <cpp3ds/Graphics/Text.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/Resources.hpp>
+#include <iostream>
+
+using namespace cpp3ds;
+
+namespace
+{
+	// Words of various lengths, with a line break every 12 words
+	String makeParagraph(std::size_t length)
+	{
+		const char* words[] = {"The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog,", "AVA", "Wolf", "TOKYO."};
+		String paragraph;
+		for (std::size_t i = 0; paragraph.getSize() < length; ++i)
+		{
+			paragraph += words[i % 12];
+			paragraph += (i % 12 == 11) ? "\n" : " ";
+		}
+		return paragraph.substring(0, length);
+	}
+}
+
+
+// Lays out a 10k character paragraph with the default font, the first
+// layout loads the glyphs, the next ones only look them up with kerning
+TEST(Text, LayoutBenchmark)
+{
+	const std::size_t length = 10000;
+	const int iterations = 50;
+
+	priv::ResourceInfo resource = priv::core_resources["opensans.ttf"];
+	Font font;
+	ASSERT_TRUE(font.loadFromMemory(resource.data, resource.size));
+
+	String paragraph = makeParagraph(length);
+	String shorter = paragraph.substring(0, length - 1);
+	Text text(paragraph, font, 16);
+
+	Clock clock;
+	FloatRect bounds = text.getLocalBounds();
+	Time first = clock.restart();
+
+	// Alternate between two strings so that each layout is redone
+	for (int n = 0; n < iterations; ++n)
+	{
+		text.setString((n % 2) ? paragraph : shorter);
+		text.getLocalBounds();
+	}
+	Time cached = clock.restart();
+
+	std::cout << "[ BENCHMARK] " << length << " characters: "
+	          << "first layout " << first.asMicroseconds() << " us, "
+	          << iterations << " cached layouts " << cached.asMicroseconds() << " us" << std::endl;
+
+	// The cached glyphs and kerning give the same layout
+	EXPECT_GT(bounds.width, 0.f);
+	EXPECT_EQ(bounds, text.getLocalBounds());
+}
@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/TextureAtlas.hpp>
+
+using namespace cpp3ds;
+
+
+TEST(TextureAtlas, ExactFit)
+{
+	TextureAtlas atlas;
+	ASSERT_TRUE(atlas.create(16, 16, 0));
+
+	EXPECT_EQ(IntRect(0, 0, 16, 8), atlas.reserve(16, 8));
+	EXPECT_EQ(IntRect(0, 8, 8, 8), atlas.reserve(8, 8));
+	EXPECT_EQ(IntRect(8, 8, 8, 8), atlas.reserve(8, 8));
+	EXPECT_FLOAT_EQ(1.f, atlas.getOccupancy());
+
+	// Full, even a single pixel doesn't fit
+	EXPECT_EQ(IntRect(), atlas.reserve(1, 1));
+
+	atlas.clear();
+	EXPECT_EQ(IntRect(0, 0, 16, 16), atlas.reserve(16, 16));
+}
+
+
+TEST(TextureAtlas, RejectsOverflow)
+{
+	TextureAtlas atlas;
+	ASSERT_TRUE(atlas.create(16, 16, 0));
+
+	EXPECT_EQ(IntRect(), atlas.reserve(17, 1));
+	EXPECT_EQ(IntRect(), atlas.reserve(1, 17));
+	EXPECT_EQ(IntRect(), atlas.reserve(0, 4));
+
+	// Rejected areas don't use any room
+	EXPECT_EQ(IntRect(0, 0, 10, 10), atlas.reserve(10, 10));
+	EXPECT_EQ(IntRect(10, 0, 6, 16), atlas.reserve(6, 16));
+	EXPECT_EQ(IntRect(), atlas.reserve(11, 6));
+	EXPECT_EQ(IntRect(0, 10, 10, 6), atlas.reserve(10, 6));
+}
+
+
+TEST(TextureAtlas, Padding)
+{
+	TextureAtlas atlas;
+	ASSERT_TRUE(atlas.create(16, 16, 1));
+
+	// The padding is on the left/top of each area, so it counts towards the atlas size
+	EXPECT_EQ(IntRect(), atlas.reserve(16, 1));
+	EXPECT_EQ(IntRect(), atlas.reserve(15, 16));
+	EXPECT_EQ(IntRect(), atlas.reserve(16, 15));
+
+	EXPECT_EQ(IntRect(1, 1, 7, 7), atlas.reserve(7, 7));
+	EXPECT_EQ(IntRect(9, 1, 7, 7), atlas.reserve(7, 7));
+	EXPECT_EQ(IntRect(1, 9, 15, 7), atlas.reserve(15, 7));
+	EXPECT_EQ(IntRect(), atlas.reserve(1, 1));
+
+	// Every area ends within the texture
+	atlas.clear();
+	IntRect rect;
+	while ((rect = atlas.reserve(3, 5)) != IntRect())
+	{
+		EXPECT_LE(rect.left + rect.width, 16);
+		EXPECT_LE(rect.top + rect.height, 16);
+	}
+}
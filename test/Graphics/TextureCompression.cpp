@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/TextureCompression.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	std::vector<Uint8> makeGradient(unsigned int width, unsigned int height)
+	{
+		std::vector<Uint8> pixels(width * height * 4);
+		for (unsigned int y = 0; y < height; ++y)
+		{
+			for (unsigned int x = 0; x < width; ++x)
+			{
+				Uint8* pixel = &pixels[(x + y * width) * 4];
+				pixel[0] = static_cast<Uint8>(x * 255 / (width - 1));
+				pixel[1] = static_cast<Uint8>(y * 255 / (height - 1));
+				pixel[2] = static_cast<Uint8>((x + y) * 127 / (width + height - 2));
+				pixel[3] = static_cast<Uint8>(255 - x * 255 / (width - 1));
+			}
+		}
+		return pixels;
+	}
+}
+
+
+TEST(TextureCompression, SolidColorIsKept)
+{
+	// A gray level that 4 bits base colors represent exactly, only
+	// the smallest intensity modifier remains
+	std::vector<Uint8> pixels(8 * 8 * 4);
+	for (std::size_t i = 0; i < pixels.size(); i += 4)
+	{
+		pixels[i] = pixels[i + 1] = pixels[i + 2] = 0x88;
+		pixels[i + 3] = 255;
+	}
+
+	std::vector<Uint8> texture(8 * 8 / 2);
+	std::vector<Uint8> result(pixels.size());
+	priv::compressEtc1(&texture[0], &pixels[0], 0, 0, 8, 8, 8 * 4, 8, 8, false);
+	priv::decompressEtc1(&result[0], &texture[0], 0, 0, 8, 8, 8 * 4, 8, 8, false);
+
+	for (std::size_t i = 0; i < pixels.size(); ++i)
+		EXPECT_NEAR(pixels[i], result[i], 2);
+}
+
+
+TEST(TextureCompression, GradientRoundTrip)
+{
+	const unsigned int width = 64, height = 32;
+	std::vector<Uint8> pixels = makeGradient(width, height);
+
+	std::vector<Uint8> texture(width * height);
+	std::vector<Uint8> result(pixels.size());
+	priv::compressEtc1(&texture[0], &pixels[0], 0, 0, width, height, width * 4, width, height, true);
+	priv::decompressEtc1(&result[0], &texture[0], 0, 0, width, height, width * 4, width, height, true);
+
+	double squaredError = 0;
+	for (std::size_t i = 0; i < pixels.size(); i += 4)
+	{
+		for (unsigned int c = 0; c < 3; ++c)
+		{
+			int difference = pixels[i + c] - result[i + c];
+			squaredError += difference * difference;
+		}
+
+		// 4 bits alpha is off by half a step at most
+		EXPECT_LE(std::abs(pixels[i + 3] - result[i + 3]), 9);
+	}
+
+	// A smooth gradient should stay well above 35 dB
+	double psnr = 10 * std::log10(255.0 * 255.0 * width * height * 3 / squaredError);
+	EXPECT_GT(psnr, 35.0);
+}
+
+
+TEST(TextureCompression, RegionLeavesOtherTilesUntouched)
+{
+	const unsigned int size = 16;
+	std::vector<Uint8> pixels = makeGradient(8, 8);
+
+	std::vector<Uint8> texture(size * size / 2, 0xCD);
+	priv::compressEtc1(&texture[0], &pixels[0], 8, 0, 8, 8, 8 * 4, size, size, false);
+
+	// Top right of the image is the last tile in memory (rows start from the bottom)
+	for (std::size_t i = 0; i < texture.size() * 3 / 4; ++i)
+		EXPECT_EQ(0xCD, texture[i]);
+
+	// And holds the same blocks as the region compressed on its own
+	std::vector<Uint8> alone(8 * 8 / 2);
+	priv::compressEtc1(&alone[0], &pixels[0], 0, 0, 8, 8, 8 * 4, 8, 8, false);
+	EXPECT_TRUE(std::equal(alone.begin(), alone.end(), texture.begin() + texture.size() * 3 / 4));
+}
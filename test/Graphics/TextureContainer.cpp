@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/TextureContainer.hpp>
+#include <cpp3ds/System/MemoryInputStream.hpp>
+#include <cstdlib>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	// Texture-like data: runs of a few colors with some noise
+	std::vector<Uint8> makeData(std::size_t size, unsigned int seed)
+	{
+		std::srand(seed);
+		std::vector<Uint8> data(size);
+		for (std::size_t i = 0; i < size; ++i)
+			data[i] = (std::rand() % 8 == 0) ? static_cast<Uint8>(std::rand()) : static_cast<Uint8>((i / 64) * 16);
+		return data;
+	}
+
+	std::vector<Uint8> decompress(const std::vector<Uint8>& compressed, priv::ChunkCompression compression, std::size_t size, bool& success)
+	{
+		MemoryInputStream stream;
+		stream.open(&compressed[0], compressed.size());
+		std::vector<Uint8> output(size);
+		success = priv::decompressChunk(stream, compressed.size(), compression, &output[0], size);
+		return output;
+	}
+}
+
+
+TEST(TextureContainer, Lz11RoundTrip)
+{
+	const std::size_t sizes[] = {32, 1000, 65536, 300000};
+	for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		std::vector<Uint8> data = makeData(sizes[i], i);
+		std::vector<Uint8> compressed;
+		priv::compressLz11(&data[0], data.size(), compressed);
+
+		bool success;
+		EXPECT_EQ(data, decompress(compressed, priv::ChunkLz11, data.size(), success));
+		EXPECT_TRUE(success);
+	}
+
+	// Long runs use the longest matches
+	std::vector<Uint8> zeros(100000, 0);
+	std::vector<Uint8> compressed;
+	priv::compressLz11(&zeros[0], zeros.size(), compressed);
+	EXPECT_LT(compressed.size(), 100u);
+
+	bool success;
+	EXPECT_EQ(zeros, decompress(compressed, priv::ChunkLz11, zeros.size(), success));
+	EXPECT_TRUE(success);
+}
+
+
+TEST(TextureContainer, Lz4RoundTrip)
+{
+	const std::size_t sizes[] = {5, 13, 1000, 65536, 300000};
+	for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		std::vector<Uint8> data = makeData(sizes[i], i);
+		std::vector<Uint8> compressed;
+		priv::compressLz4(&data[0], data.size(), compressed);
+
+		bool success;
+		EXPECT_EQ(data, decompress(compressed, priv::ChunkLz4, data.size(), success));
+		EXPECT_TRUE(success);
+	}
+
+	std::vector<Uint8> zeros(100000, 0);
+	std::vector<Uint8> compressed;
+	priv::compressLz4(&zeros[0], zeros.size(), compressed);
+	EXPECT_LT(compressed.size(), 1000u);
+}
+
+
+TEST(TextureContainer, CorruptDataIsRejected)
+{
+	std::vector<Uint8> data = makeData(4096, 1);
+	std::vector<Uint8> compressed;
+
+	// Wrong size
+	priv::compressLz11(&data[0], data.size(), compressed);
+	bool success;
+	decompress(compressed, priv::ChunkLz11, data.size() - 1, success);
+	EXPECT_FALSE(success);
+
+	// Truncated data
+	priv::compressLz4(&data[0], data.size(), compressed);
+	compressed.resize(compressed.size() / 2);
+	decompress(compressed, priv::ChunkLz4, data.size(), success);
+	EXPECT_FALSE(success);
+
+	// Match before the start of the output
+	const Uint8 match[] = {0x00, 0x00, 0x10, 0x00};
+	std::vector<Uint8> bad(match, match + sizeof(match));
+	decompress(bad, priv::ChunkLz4, 16, success);
+	EXPECT_FALSE(success);
+}
+
+
+TEST(TextureContainer, WriteAndRead)
+{
+	// A mipmapped texture with a level of each storage, and a single level one
+	std::vector<Uint8> base = makeData(64 * 32 * 2, 2);
+	std::vector<Uint8> level1 = makeData(32 * 16 * 2, 3);
+	std::vector<Uint8> level2 = makeData(16 * 8 * 2, 4);
+	std::vector<Uint8> etc = makeData(128 * 8 / 2, 5);
+
+	priv::TextureContainerWriter writer;
+	ASSERT_EQ(0, writer.addTexture(Texture::RGBA4, 64, 32, 60, 30));
+	ASSERT_TRUE(writer.addLevel(0, &base[0], base.size(), priv::ChunkLz4));
+	ASSERT_TRUE(writer.addLevel(0, &level1[0], level1.size(), priv::ChunkLz11));
+	ASSERT_TRUE(writer.addLevel(0, &level2[0], level2.size(), priv::ChunkRaw));
+	EXPECT_FALSE(writer.addLevel(0, &level2[0], level2.size(), priv::ChunkRaw));
+	ASSERT_EQ(1, writer.addTexture(Texture::ETC1, 128, 8, 128, 8, 1024, 512));
+	EXPECT_FALSE(writer.addLevel(1, &etc[0], etc.size() - 1, priv::ChunkRaw));
+	ASSERT_TRUE(writer.addLevel(1, &etc[0], etc.size(), priv::ChunkLz4));
+	writer.addRect(0, IntRect(1, 2, 30, 20));
+	EXPECT_EQ(-1, writer.addTexture(Texture::RGBA8, 100, 64, 100, 64));
+
+	std::vector<Uint8> file;
+	ASSERT_TRUE(writer.save(file));
+
+	MemoryInputStream stream;
+	stream.open(&file[0], file.size());
+	ASSERT_TRUE(priv::TextureContainer::isContainer(stream));
+
+	priv::TextureContainer container;
+	ASSERT_TRUE(container.openFromStream(stream));
+	ASSERT_EQ(2u, container.getTextureCount());
+	EXPECT_EQ(3, container.getTexture(0).levelCount);
+	EXPECT_EQ(60, container.getTexture(0).originalWidth);
+	EXPECT_EQ(1024, container.getTexture(1).left);
+	EXPECT_EQ(512, container.getTexture(1).top);
+	EXPECT_EQ(priv::ChunkLz4, container.getChunk(0, 0).compression);
+	EXPECT_EQ(priv::ChunkRaw, container.getChunk(0, 2).compression);
+	EXPECT_EQ(0u, container.getChunk(0, 2).offset % 512);
+	ASSERT_EQ(1u, container.getRectCount());
+	EXPECT_EQ(30, container.getRect(0).width);
+
+	std::vector<Uint8> expected = base;
+	expected.insert(expected.end(), level1.begin(), level1.end());
+	expected.insert(expected.end(), level2.begin(), level2.end());
+	ASSERT_EQ(expected.size(), container.getDataSize(0));
+
+	std::vector<Uint8> data(container.getDataSize(0));
+	ASSERT_TRUE(container.readTexture(0, &data[0]));
+	EXPECT_EQ(expected, data);
+
+	data.resize(container.getDataSize(1));
+	ASSERT_TRUE(container.readTexture(1, &data[0]));
+	EXPECT_EQ(etc, data);
+
+	// Files of the previous format aren't containers
+	const Uint8 legacy[10] = {0};
+	MemoryInputStream legacyStream;
+	legacyStream.open(legacy, sizeof(legacy));
+	EXPECT_FALSE(priv::TextureContainer::isContainer(legacyStream));
+}
@@ -0,0 +1,250 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/TextureTiling.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	// Per-pixel RGBA8 tiling, as done before the block kernels
+	void referenceTile32(Uint8* dest, const Uint8* source, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+	                     unsigned int textureWidth, unsigned int textureHeight)
+	{
+		for (unsigned int j = 0; j < height; ++j)
+		{
+			for (unsigned int i = 0; i < width; ++i)
+			{
+				unsigned int tx = i + x;
+				unsigned int ty = textureHeight - 1 - j - y;
+
+				unsigned int morton = 0;
+				for (unsigned int bit = 0; bit < 3; ++bit)
+					morton |= (((tx >> bit) & 1) << (2 * bit)) | (((ty >> bit) & 1) << (2 * bit + 1));
+				unsigned int offset = (morton + (tx & ~7u) * 8 + (ty & ~7u) * textureWidth) * 4;
+
+				const Uint8* src = source + (i + j * width) * 4;
+				for (unsigned int k = 0; k < 4; ++k)
+					dest[offset + k] = src[3 - k];
+			}
+		}
+	}
+
+	std::vector<Uint8> makePixels(std::size_t size)
+	{
+		std::vector<Uint8> pixels(size);
+		for (std::size_t i = 0; i < size; ++i)
+			pixels[i] = static_cast<Uint8>(i * 7 + i / 251);
+		return pixels;
+	}
+
+	// Tiles a region, checks untiling gives it back and that nothing else was touched
+	void checkRoundTrip(unsigned int bitsPerPixel, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+	{
+		const unsigned int textureWidth = 64;
+		const unsigned int textureHeight = 32;
+		unsigned int pitch = (width * bitsPerPixel + 7) / 8;
+
+		std::vector<Uint8> pixels = makePixels(pitch * height);
+		if (bitsPerPixel == 4 && width % 2)
+		{
+			// Unused nibble at the end of each row must stay clear to compare
+			for (unsigned int j = 0; j < height; ++j)
+				pixels[j * pitch + pitch - 1] &= 0x0F;
+		}
+
+		std::vector<Uint8> texture(textureWidth * textureHeight * bitsPerPixel / 8, 0xAB);
+		std::vector<Uint8> result(pixels.size(), 0);
+
+		ASSERT_TRUE(priv::tileImage(&texture[0], &pixels[0], x, y, width, height, pitch, textureWidth, textureHeight, bitsPerPixel));
+		ASSERT_TRUE(priv::untileImage(&result[0], &texture[0], x, y, width, height, pitch, textureWidth, textureHeight, bitsPerPixel));
+		EXPECT_EQ(pixels, result) << bitsPerPixel << " bits, region " << x << "," << y << " " << width << "x" << height;
+
+		std::size_t untouched = 0;
+		for (std::size_t i = 0; i < texture.size(); ++i)
+			untouched += (texture[i] == 0xAB);
+		EXPECT_GE(untouched, texture.size() - pixels.size());
+	}
+}
+
+
+TEST(TextureTiling, RoundTripAllDepths)
+{
+	const unsigned int depths[] = {4, 8, 16, 24, 32};
+	for (unsigned int i = 0; i < 5; ++i)
+	{
+		checkRoundTrip(depths[i], 0, 0, 64, 32);
+		checkRoundTrip(depths[i], 8, 16, 16, 8);
+		checkRoundTrip(depths[i], 3, 5, 27, 19);
+		checkRoundTrip(depths[i], 63, 31, 1, 1);
+	}
+}
+
+
+TEST(TextureTiling, MatchesReferenceLayout)
+{
+	const unsigned int textureWidth = 128;
+	const unsigned int textureHeight = 64;
+	const unsigned int x = 5, y = 9, width = 100, height = 37;
+
+	std::vector<Uint8> pixels = makePixels(width * height * 4);
+	std::vector<Uint8> expected(textureWidth * textureHeight * 4, 0);
+	std::vector<Uint8> result(expected.size(), 0);
+
+	referenceTile32(&expected[0], &pixels[0], x, y, width, height, textureWidth, textureHeight);
+	priv::tileImage(&result[0], &pixels[0], x, y, width, height, width * 4, textureWidth, textureHeight, 32);
+
+	EXPECT_EQ(expected, result);
+}
+
+
+TEST(TextureTiling, ReducedFormats)
+{
+	const Texture::Format formats[] = {Texture::RGBA8, Texture::RGB565, Texture::RGBA5551, Texture::RGBA4, Texture::LA8, Texture::A8};
+	const unsigned int width = 13, height = 11;
+
+	std::vector<Uint8> pixels = makePixels(width * height * 4);
+	for (unsigned int i = 0; i < 6; ++i)
+	{
+		Texture::Format format = formats[i];
+		std::vector<Uint8> texture(16 * 16 * priv::getBitsPerPixel(format) / 8);
+		std::vector<Uint8> result(pixels.size());
+
+		ASSERT_TRUE(priv::tileImage(&texture[0], &pixels[0], 2, 3, width, height, width * 4, 16, 16, format));
+		ASSERT_TRUE(priv::untileImage(&result[0], &texture[0], 2, 3, width, height, width * 4, 16, 16, format));
+
+		// Each channel is off by at most its quantization step
+		int tolerance[6][4] = {{0, 0, 0, 0}, {4, 2, 4, 255}, {4, 4, 4, 127}, {8, 8, 8, 8}, {255, 255, 255, 0}, {255, 255, 255, 0}};
+		for (std::size_t p = 0; p < pixels.size(); p += 4)
+		{
+			for (unsigned int c = 0; c < 4; ++c)
+				EXPECT_LE(std::abs(pixels[p + c] - result[p + c]), tolerance[i][c]) << "format " << format << ", channel " << c;
+		}
+
+		// Converting the same pixels without tiling gives the same texels
+		std::vector<Uint8> texels(width * priv::getBitsPerPixel(format) / 8);
+		std::vector<Uint8> line(width * 4);
+		priv::convertPixels(&texels[0], &pixels[0], width, format);
+		priv::untileImage(&line[0], &texture[0], 2, 3, width, 1, width * 4, 16, 16, format);
+		std::vector<Uint8> retexels(texels.size());
+		priv::convertPixels(&retexels[0], &line[0], width, format);
+		EXPECT_EQ(texels, retexels) << "format " << format;
+	}
+}
+
+
+TEST(TextureTiling, MipmapReduction)
+{
+	EXPECT_EQ(1u, priv::getMipmapLevelCount(8, 8));
+	EXPECT_EQ(8u, priv::getMipmapLevelCount(1024, 1024));
+	EXPECT_EQ(3u, priv::getMipmapLevelCount(256, 32));
+
+	// Each destination pixel is the rounded average of a 2x2 block
+	const Uint8 source[4 * 2 * 4] =
+	{
+		0, 10, 255, 1,   2, 20, 255, 2,   100, 0, 0, 0,   100, 0, 0, 0,
+		4, 30, 255, 3,   6, 40, 254, 4,   100, 0, 0, 0,   101, 0, 0, 0,
+	};
+	Uint8 result[2 * 4];
+	priv::halveImage(result, source, 4, 2);
+
+	const Uint8 expected[2 * 4] = {3, 25, 255, 3, 100, 0, 0, 0};
+	for (unsigned int i = 0; i < 8; ++i)
+		EXPECT_EQ(expected[i], result[i]);
+}
+
+
+TEST(TextureTiling, InPlaceMatchesCopy)
+{
+	// Odd and even band counts, the middle band stays in place
+	const unsigned int sizes[][2] = {{64, 32}, {32, 64}, {16, 8}, {8, 24}};
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		unsigned int width = sizes[i][0];
+		unsigned int height = sizes[i][1];
+		std::vector<Uint8> pixels = makePixels(width * height * 4);
+		std::vector<Uint8> expected(pixels.size());
+		ASSERT_TRUE(priv::tileImage(&expected[0], &pixels[0], 0, 0, width, height, width * 4, width, height, Texture::RGBA8));
+
+		priv::tileImageInPlace(&pixels[0], width, height);
+		EXPECT_EQ(expected, pixels) << width << "x" << height;
+	}
+}
+
+
+TEST(TextureTiling, GrowKeepsPixels)
+{
+	const unsigned int depths[] = {8, 16, 24, 32};
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		unsigned int pixelSize = depths[i] / 8;
+
+		// A 16x8 texture grown to 32x24, the new area filled with 0x5A
+		std::vector<Uint8> pixels = makePixels(16 * 8 * pixelSize);
+		std::vector<Uint8> source(16 * 8 * pixelSize);
+		ASSERT_TRUE(priv::tileImage(&source[0], &pixels[0], 0, 0, 16, 8, 16 * pixelSize, 16, 8, depths[i]));
+
+		std::vector<Uint8> fillTile(64 * pixelSize, 0x5A);
+		std::vector<Uint8> texture(32 * 24 * pixelSize);
+		priv::growTiledImage(&texture[0], &source[0], 16, 8, 32, 24, depths[i], &fillTile[0]);
+
+		std::vector<Uint8> result(texture.size());
+		ASSERT_TRUE(priv::untileImage(&result[0], &texture[0], 0, 0, 32, 24, 32 * pixelSize, 32, 24, depths[i]));
+
+		for (unsigned int y = 0; y < 24; ++y)
+		{
+			for (unsigned int x = 0; x < 32; ++x)
+			{
+				const Uint8* pixel = &result[(x + y * 32) * pixelSize];
+				for (unsigned int c = 0; c < pixelSize; ++c)
+				{
+					Uint8 expected = (x < 16 && y < 8) ? pixels[(x + y * 16) * pixelSize + c] : 0x5A;
+					ASSERT_EQ(expected, pixel[c]) << depths[i] << " bits, at " << x << "," << y;
+				}
+			}
+		}
+	}
+}
+
+
+TEST(TextureTiling, UnsupportedDepth)
+{
+	Uint8 pixel[4] = {0, 0, 0, 0};
+	Uint8 texture[64 * 4];
+	EXPECT_FALSE(priv::tileImage(texture, pixel, 0, 0, 1, 1, 4, 8, 8, 12));
+	EXPECT_FALSE(priv::untileImage(pixel, texture, 0, 0, 1, 1, 4, 8, 8, 0));
+}
+
+
+// Uploading a full 1024x1024 RGBA8 texture, per-pixel vs block kernels
+TEST(TextureTiling, TileBenchmark)
+{
+	const unsigned int size = 1024;
+	const int iterations = 10;
+
+	std::vector<Uint8> pixels = makePixels(size * size * 4);
+	std::vector<Uint8> texture(pixels.size());
+	std::vector<Uint8> result(pixels.size());
+
+	Clock clock;
+	for (int n = 0; n < iterations; ++n)
+		referenceTile32(&texture[0], &pixels[0], 0, 0, size, size, size, size);
+	Time perPixel = clock.restart();
+
+	for (int n = 0; n < iterations; ++n)
+		priv::tileImage(&texture[0], &pixels[0], 0, 0, size, size, size * 4, size, size, 32);
+	Time tiled = clock.restart();
+
+	for (int n = 0; n < iterations; ++n)
+		priv::untileImage(&result[0], &texture[0], 0, 0, size, size, size * 4, size, size, 32);
+	Time untiled = clock.restart();
+
+	std::cout << "[ BENCHMARK] " << iterations << " x " << size << "x" << size << " RGBA8: "
+	          << "per-pixel " << perPixel.asMicroseconds() << " us, "
+	          << "tileImage " << tiled.asMicroseconds() << " us, "
+	          << "untileImage " << untiled.asMicroseconds() << " us" << std::endl;
+
+	EXPECT_EQ(pixels, result);
+}
@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Graphics/Transform.hpp>
+#include <cpp3ds/Graphics/Vertex.hpp>
+#include <cpp3ds/System/Clock.hpp>
+#include <iostream>
+#include <vector>
+
+using namespace cpp3ds;
+
+namespace
+{
+	Transform makeTransform()
+	{
+		Transform transform;
+		transform.translate(120.f, 40.f).rotate(30.f).scale(2.f, 0.5f);
+		return transform;
+	}
+
+	std::vector<Vertex> makeVertices(std::size_t count)
+	{
+		std::vector<Vertex> vertices(count);
+		for (std::size_t i = 0; i < count; ++i)
+			vertices[i] = Vertex(Vector2f(i * 3.f, i * 0.5f - 10.f), Color(i, 255 - i, 0, 128), Vector2f(i, i * 2.f));
+		return vertices;
+	}
+}
+
+
+TEST(Transform, TransformVerticesMatchesTransformPoint)
+{
+	Transform transform = makeTransform();
+
+	// 7 vertices: one unrolled iteration plus a remainder
+	std::vector<Vertex> source = makeVertices(7);
+	std::vector<Vertex> result(source.size());
+	transform.transformVertices(&source[0], &result[0], source.size());
+
+	for (std::size_t i = 0; i < source.size(); ++i)
+	{
+		Vector2f expected = transform.transformPoint(source[i].position);
+		EXPECT_FLOAT_EQ(expected.x, result[i].position.x);
+		EXPECT_FLOAT_EQ(expected.y, result[i].position.y);
+		EXPECT_EQ(source[i].color, result[i].color);
+		EXPECT_EQ(source[i].texCoords, result[i].texCoords);
+	}
+}
+
+
+// Compares the pre-transform kernel used by RenderTarget
+// with transforming each vertex through transformPoint
+TEST(Transform, TransformVerticesBenchmark)
+{
+	const std::size_t vertexCount = 96;
+	const int iterations = 100000;
+
+	Transform transform = makeTransform();
+	std::vector<Vertex> source = makeVertices(vertexCount);
+	std::vector<Vertex> result(vertexCount);
+
+	Clock clock;
+	for (int n = 0; n < iterations; ++n)
+	{
+		for (std::size_t i = 0; i < vertexCount; ++i)
+		{
+			result[i].position  = transform * source[i].position;
+			result[i].color     = source[i].color;
+			result[i].texCoords = source[i].texCoords;
+		}
+	}
+	Time perVertex = clock.restart();
+
+	for (int n = 0; n < iterations; ++n)
+		transform.transformVertices(&source[0], &result[0], vertexCount);
+	Time batched = clock.restart();
+
+	std::cout << "[ BENCHMARK] " << iterations << " x " << vertexCount << " vertices: "
+	          << "transformPoint " << perVertex.asMicroseconds() << " us, "
+	          << "transformVertices " << batched.asMicroseconds() << " us" << std::endl;
+
+	// Keep the results alive so that the loops aren't optimized out
+	EXPECT_FLOAT_EQ(transform.transformPoint(source.back().position).x, result.back().position.x);
+}
@@ -0,0 +1,35 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/Network/Packet.hpp>
+#include <type_traits>
+#include <utility>
+
+using namespace cpp3ds;
+
+static_assert(std::is_nothrow_move_constructible<Packet>::value, "Packet must be nothrow movable");
+static_assert(std::is_nothrow_move_assignable<Packet>::value, "Packet must be nothrow move assignable");
+
+
+TEST(Packet, MoveKeepsDataAndReadPosition)
+{
+	Packet packet;
+	packet << Uint32(42) << Uint32(7);
+	const void* data = packet.getData();
+
+	Uint32 first;
+	packet >> first;
+
+	Packet moved(std::move(packet));
+	EXPECT_EQ(data, moved.getData());
+	EXPECT_EQ(0u, packet.getDataSize());
+
+	Packet assigned;
+	assigned << Uint8(1);
+	assigned = std::move(moved);
+	EXPECT_EQ(data, assigned.getData());
+
+	// Reading continues where it was before the moves
+	Uint32 second = 0;
+	EXPECT_TRUE(assigned >> second);
+	EXPECT_EQ(7u, second);
+	EXPECT_TRUE(assigned.endOfPacket());
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/System/Clock.hpp>
+#include <cpp3ds/System/HashTable.hpp>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace cpp3ds;
+
+
+TEST(HashTable, FindsValuesAfterGrowth)
+{
+	priv::HashTable<Uint64, int> table;
+	EXPECT_TRUE(table.find(0) == NULL);
+
+	// Keys only differing in their high bits, like the glyph keys
+	for (int i = 0; i < 1000; ++i)
+		table.insert(static_cast<Uint64>(i) << 40 | 'a', i);
+
+	EXPECT_EQ(1000u, table.getSize());
+	for (int i = 0; i < 1000; ++i)
+	{
+		const int* value = table.find(static_cast<Uint64>(i) << 40 | 'a');
+		ASSERT_TRUE(value != NULL);
+		EXPECT_EQ(i, *value);
+	}
+	EXPECT_TRUE(table.find('a' + 1) == NULL);
+
+	table.clear();
+	EXPECT_EQ(0u, table.getSize());
+	EXPECT_TRUE(table.find('a') == NULL);
+}
+
+
+TEST(HashTable, ValuesDontMove)
+{
+	priv::HashTable<unsigned int, std::vector<int> > table;
+	std::vector<int>& first = table[30];
+	first.push_back(1);
+
+	for (unsigned int size = 0; size < 500; ++size)
+		table[size].push_back(size);
+
+	// Growing rebuilt the key array, but not the values
+	EXPECT_EQ(&first, &table[30]);
+	EXPECT_EQ(2u, first.size());
+
+	// Inserting an existing key keeps its value
+	EXPECT_EQ(&first, &table.insert(30, std::vector<int>()));
+	EXPECT_EQ(500u, table.getSize());
+}
+
+
+// Looking up the glyphs of a paragraph, tree vs hash table
+TEST(HashTable, LookupBenchmark)
+{
+	const int iterations = 1000;
+	const Uint32 characters = 10000;
+
+	std::map<Uint64, float> tree;
+	priv::HashTable<Uint64, float> table;
+	for (Uint32 codePoint = 0x20; codePoint < 0x17F; ++codePoint)
+	{
+		tree[codePoint] = static_cast<float>(codePoint);
+		table.insert(codePoint, static_cast<float>(codePoint));
+	}
+
+	float treeSum = 0;
+	Clock clock;
+	for (int n = 0; n < iterations; ++n)
+		for (Uint32 i = 0; i < characters; ++i)
+			treeSum += tree.find(0x20 + (i * 7) % 0x15F)->second;
+	Time treeTime = clock.restart();
+
+	float tableSum = 0;
+	for (int n = 0; n < iterations; ++n)
+		for (Uint32 i = 0; i < characters; ++i)
+			tableSum += *table.find(0x20 + (i * 7) % 0x15F);
+	Time tableTime = clock.restart();
+
+	std::cout << "[ BENCHMARK] " << iterations << " x " << characters << " lookups: "
+	          << "std::map " << treeTime.asMicroseconds() << " us, "
+	          << "HashTable " << tableTime.asMicroseconds() << " us" << std::endl;
+
+	EXPECT_EQ(treeSum, tableSum);
+}
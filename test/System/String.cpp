@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+#include <cpp3ds/System/String.hpp>
+#include <type_traits>
+#include <utility>
+
+using namespace cpp3ds;
+
+static_assert(std::is_nothrow_move_constructible<String>::value, "String must be nothrow movable");
+static_assert(std::is_nothrow_move_assignable<String>::value, "String must be nothrow move assignable");
+
+
+TEST(String, MoveKeepsCharacters)
+{
+	// Long enough not to fit in the small string buffer
+	String string("A string that is stored on the heap, not inline");
+	const Uint32* data = string.getData();
+
+	String moved(std::move(string));
+	EXPECT_EQ(data, moved.getData());
+	EXPECT_TRUE(string.isEmpty());
+
+	String assigned("short");
+	assigned = std::move(moved);
+	EXPECT_EQ(data, assigned.getData());
+	EXPECT_EQ(std::string("A string that is stored on the heap, not inline"), assigned.toAnsiString());
+	EXPECT_TRUE(moved.isEmpty());
+}